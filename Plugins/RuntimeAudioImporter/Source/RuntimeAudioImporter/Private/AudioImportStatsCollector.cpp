@@ -0,0 +1,398 @@
+// Georgy Treshchev 2022.
+
+#include "AudioImportStatsCollector.h"
+
+#include "HAL/IConsoleManager.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("Runtime Audio Importer"), STATGROUP_RuntimeAudioImporter, STATCAT_Advanced);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Imports"), STAT_RuntimeAudioImporter_NumOfImports, STATGROUP_RuntimeAudioImporter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Allocations"), STAT_RuntimeAudioImporter_NumOfAllocations, STATGROUP_RuntimeAudioImporter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Audio Thread Render Allocations"), STAT_RuntimeAudioImporter_NumOfRenderAllocations, STATGROUP_RuntimeAudioImporter);
+DECLARE_MEMORY_STAT(TEXT("Read Bytes"), STAT_RuntimeAudioImporter_ReadBytes, STATGROUP_RuntimeAudioImporter);
+DECLARE_MEMORY_STAT(TEXT("Copy Copied Bytes"), STAT_RuntimeAudioImporter_CopyCopiedBytes, STATGROUP_RuntimeAudioImporter);
+DECLARE_MEMORY_STAT(TEXT("Decode Copied Bytes"), STAT_RuntimeAudioImporter_DecodeCopiedBytes, STATGROUP_RuntimeAudioImporter);
+DECLARE_MEMORY_STAT(TEXT("Convert Copied Bytes"), STAT_RuntimeAudioImporter_ConvertCopiedBytes, STATGROUP_RuntimeAudioImporter);
+DECLARE_MEMORY_STAT(TEXT("Attach Copied Bytes"), STAT_RuntimeAudioImporter_AttachCopiedBytes, STATGROUP_RuntimeAudioImporter);
+DECLARE_MEMORY_STAT(TEXT("Last Import Peak Allocated"), STAT_RuntimeAudioImporter_LastImportPeakAllocatedBytes, STATGROUP_RuntimeAudioImporter);
+
+static TAutoConsoleVariable<int32> CVarTrackImportAllocations(
+	TEXT("RuntimeAudioImporter.TrackImportAllocations"),
+	0,
+	TEXT("Whether to track the allocations made by each stage of the audio import and by the imported sound waves while rendering on the audio thread.\n")
+	TEXT("Once enabled, all allocations of the process go through a tracking allocator until exit, so it is intended for profiling only"));
+
+/** Installs the tracker on the game thread as soon as the allocations are to be tracked, so that the audio thread never has to */
+static void InstallTrackerOnConsoleVariablesChanged()
+{
+	if (CVarTrackImportAllocations.GetValueOnGameThread() != 0)
+	{
+		FAudioAllocationTracker::Install();
+	}
+}
+
+static FAutoConsoleVariableSink CVarTrackImportAllocationsSink(FConsoleCommandDelegate::CreateStatic(&InstallTrackerOnConsoleVariablesChanged));
+
+namespace
+{
+	/** Counters of the import stage running on the current thread */
+	thread_local FAudioImportStageCounters* GCurrentStageCounters{nullptr};
+
+	/** Counters of the rendering of the imported sound waves, which is not a part of any import */
+	FAudioImportStageCounters GRenderCounters;
+
+	/** Global counters on top of the stack, which all allocations are accounted to regardless of the thread */
+	TAtomic<FAudioImportStageCounters*> GGlobalCounters{nullptr};
+
+	/**
+	 * Allocator proxy which forwards the allocations to the allocator it has replaced and accounts them to the counters
+	 */
+	class FAllocationTrackerMalloc final : public FMalloc
+	{
+	public:
+		explicit FAllocationTrackerMalloc(FMalloc* InInnerMalloc)
+			: InnerMalloc(InInnerMalloc)
+		{
+		}
+
+		//~ Begin FMalloc Interface
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			return TrackAllocation(InnerMalloc->Malloc(Count, Alignment), Count);
+		}
+
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+		{
+			return TrackAllocation(InnerMalloc->TryMalloc(Count, Alignment), Count);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			TrackFree(Original);
+			return TrackAllocation(InnerMalloc->Realloc(Original, Count, Alignment), Count);
+		}
+
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			TrackFree(Original);
+			return TrackAllocation(InnerMalloc->TryRealloc(Original, Count, Alignment), Count);
+		}
+
+		virtual void Free(void* Original) override
+		{
+			TrackFree(Original);
+			InnerMalloc->Free(Original);
+		}
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+		{
+			return InnerMalloc->QuantizeSize(Count, Alignment);
+		}
+
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+		{
+			return InnerMalloc->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual void Trim(bool bTrimThreadCaches) override
+		{
+			InnerMalloc->Trim(bTrimThreadCaches);
+		}
+
+		virtual void SetupTLSCachesOnCurrentThread() override
+		{
+			InnerMalloc->SetupTLSCachesOnCurrentThread();
+		}
+
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+		{
+			InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread();
+		}
+
+		virtual void InitializeStatsMetadata() override
+		{
+			InnerMalloc->InitializeStatsMetadata();
+		}
+
+		virtual void UpdateStats() override
+		{
+			InnerMalloc->UpdateStats();
+		}
+
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override
+		{
+			InnerMalloc->GetAllocatorStats(OutStats);
+		}
+
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override
+		{
+			InnerMalloc->DumpAllocatorStats(Ar);
+		}
+
+		virtual bool IsInternallyThreadSafe() const override
+		{
+			return InnerMalloc->IsInternallyThreadSafe();
+		}
+
+		virtual bool ValidateHeap() override
+		{
+			return InnerMalloc->ValidateHeap();
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return InnerMalloc->GetDescriptiveName();
+		}
+		//~ End FMalloc Interface
+
+	private:
+		void* TrackAllocation(void* Allocation, SIZE_T RequestedSize)
+		{
+			FAudioImportStageCounters* StageCounters{GCurrentStageCounters};
+			FAudioImportStageCounters* GlobalCounters{GGlobalCounters.Load(EMemoryOrder::Relaxed)};
+
+			if ((StageCounters == nullptr && GlobalCounters == nullptr) || Allocation == nullptr)
+			{
+				return Allocation;
+			}
+
+			// The actual size is preferred so that freeing the allocation is subtracted symmetrically
+			SIZE_T AllocationSize{RequestedSize};
+			InnerMalloc->GetAllocationSize(Allocation, AllocationSize);
+
+			AccountAllocation(StageCounters, static_cast<int64>(AllocationSize));
+			AccountAllocation(GlobalCounters, static_cast<int64>(AllocationSize));
+
+			return Allocation;
+		}
+
+		void TrackFree(void* Original)
+		{
+			FAudioImportStageCounters* StageCounters{GCurrentStageCounters};
+			FAudioImportStageCounters* GlobalCounters{GGlobalCounters.Load(EMemoryOrder::Relaxed)};
+
+			SIZE_T AllocationSize{0};
+			if ((StageCounters != nullptr || GlobalCounters != nullptr) && Original != nullptr && InnerMalloc->GetAllocationSize(Original, AllocationSize))
+			{
+				if (StageCounters != nullptr)
+				{
+					StageCounters->AllocatedBytes -= static_cast<int64>(AllocationSize);
+				}
+
+				if (GlobalCounters != nullptr)
+				{
+					GlobalCounters->AllocatedBytes -= static_cast<int64>(AllocationSize);
+				}
+			}
+		}
+
+		static void AccountAllocation(FAudioImportStageCounters* Counters, int64 AllocationSize)
+		{
+			if (Counters == nullptr)
+			{
+				return;
+			}
+
+			++Counters->NumOfAllocations;
+
+			const int64 AllocatedBytes{(Counters->AllocatedBytes += AllocationSize)};
+
+			int64 PeakAllocatedBytes{Counters->PeakAllocatedBytes.Load()};
+			while (AllocatedBytes > PeakAllocatedBytes && !Counters->PeakAllocatedBytes.CompareExchange(PeakAllocatedBytes, AllocatedBytes))
+			{
+			}
+		}
+
+		FMalloc* InnerMalloc;
+	};
+
+	/** Guards the installation of the tracker and the stack of the global counters */
+	FCriticalSection& GetTrackerGuard()
+	{
+		static FCriticalSection TrackerGuard;
+		return TrackerGuard;
+	}
+
+	/** The installed tracker. Never destroyed, as a thread might still be inside it */
+	TAtomic<FAllocationTrackerMalloc*> GTracker{nullptr};
+
+	/** Global counters pushed so far, the last of which is accounted to. Guarded by the tracker guard */
+	TArray<FAudioImportStageCounters*>& GetGlobalCountersStack()
+	{
+		static TArray<FAudioImportStageCounters*> GlobalCountersStack;
+		return GlobalCountersStack;
+	}
+
+	void FillStageStats(const FAudioImportStageCounters& StageCounters, FAudioImportStageStats& StageStats)
+	{
+		StageStats.Time = static_cast<float>(StageCounters.Time.Load());
+		StageStats.NumOfCopiedBytes = StageCounters.NumOfCopiedBytes.Load();
+		StageStats.PeakAllocatedBytes = StageCounters.PeakAllocatedBytes.Load();
+		StageStats.NumOfAllocations = StageCounters.NumOfAllocations.Load();
+	}
+}
+
+bool FAudioAllocationTracker::Install()
+{
+	if (IsInstalled())
+	{
+		return true;
+	}
+
+	// Other threads keep allocating while the global allocator is swapped, which is only safe because the tracker forwards everything to the allocator it replaces and is never uninstalled
+	if (!IsInGameThread())
+	{
+		return false;
+	}
+
+	FScopeLock Lock(&GetTrackerGuard());
+
+	if (GTracker.Load() == nullptr)
+	{
+		FAllocationTrackerMalloc* Tracker = new FAllocationTrackerMalloc(GMalloc);
+		GMalloc = Tracker;
+		GTracker = Tracker;
+	}
+
+	return true;
+}
+
+bool FAudioAllocationTracker::IsInstalled()
+{
+	return GTracker.Load() != nullptr;
+}
+
+void FAudioAllocationTracker::PushGlobalCounters(FAudioImportStageCounters* Counters)
+{
+	FScopeLock Lock(&GetTrackerGuard());
+
+	TArray<FAudioImportStageCounters*>& GlobalCountersStack = GetGlobalCountersStack();
+	GlobalCountersStack.Add(Counters);
+	GGlobalCounters = Counters;
+}
+
+void FAudioAllocationTracker::PopGlobalCounters(FAudioImportStageCounters* Counters)
+{
+	FScopeLock Lock(&GetTrackerGuard());
+
+	// The counters may be popped out of order, in which case the ones on top stay accounted to
+	TArray<FAudioImportStageCounters*>& GlobalCountersStack = GetGlobalCountersStack();
+	GlobalCountersStack.RemoveSingle(Counters);
+	GGlobalCounters = GlobalCountersStack.Num() > 0 ? GlobalCountersStack.Last() : nullptr;
+}
+
+FAudioImportStatsCollector::FAudioImportStatsCollector()
+	: bAllocationsTracked{CVarTrackImportAllocations.GetValueOnAnyThread() != 0 && FAudioAllocationTracker::Install()}
+{
+}
+
+void FAudioImportStatsCollector::AddCopiedBytes(int64 NumOfBytes)
+{
+	if (FAudioImportStageCounters* StageCounters = GCurrentStageCounters)
+	{
+		StageCounters->NumOfCopiedBytes += NumOfBytes;
+	}
+}
+
+FAudioImportStats FAudioImportStatsCollector::Finish()
+{
+	FAudioImportStats ImportStats;
+	ImportStats.bCollected = true;
+	ImportStats.bAllocationsTracked = bAllocationsTracked;
+
+	FillStageStats(StageCounters[static_cast<uint8>(EAudioImportStage::Read)], ImportStats.Read);
+	FillStageStats(StageCounters[static_cast<uint8>(EAudioImportStage::Copy)], ImportStats.Copy);
+	FillStageStats(StageCounters[static_cast<uint8>(EAudioImportStage::Decode)], ImportStats.Decode);
+	FillStageStats(StageCounters[static_cast<uint8>(EAudioImportStage::Convert)], ImportStats.Convert);
+	FillStageStats(StageCounters[static_cast<uint8>(EAudioImportStage::Attach)], ImportStats.Attach);
+
+	if (!bPublished.Exchange(true))
+	{
+		int64 NumOfAllocations{0}, PeakAllocatedBytes{0};
+		for (const FAudioImportStageCounters& Counters : StageCounters)
+		{
+			NumOfAllocations += Counters.NumOfAllocations.Load();
+			PeakAllocatedBytes = FMath::Max(PeakAllocatedBytes, Counters.PeakAllocatedBytes.Load());
+		}
+
+		INC_DWORD_STAT(STAT_RuntimeAudioImporter_NumOfImports);
+		INC_DWORD_STAT_BY(STAT_RuntimeAudioImporter_NumOfAllocations, NumOfAllocations);
+		INC_MEMORY_STAT_BY(STAT_RuntimeAudioImporter_ReadBytes, ImportStats.Read.NumOfCopiedBytes);
+		INC_MEMORY_STAT_BY(STAT_RuntimeAudioImporter_CopyCopiedBytes, ImportStats.Copy.NumOfCopiedBytes);
+		INC_MEMORY_STAT_BY(STAT_RuntimeAudioImporter_DecodeCopiedBytes, ImportStats.Decode.NumOfCopiedBytes);
+		INC_MEMORY_STAT_BY(STAT_RuntimeAudioImporter_ConvertCopiedBytes, ImportStats.Convert.NumOfCopiedBytes);
+		INC_MEMORY_STAT_BY(STAT_RuntimeAudioImporter_AttachCopiedBytes, ImportStats.Attach.NumOfCopiedBytes);
+		SET_MEMORY_STAT(STAT_RuntimeAudioImporter_LastImportPeakAllocatedBytes, PeakAllocatedBytes);
+	}
+
+	return ImportStats;
+}
+
+FAudioImportStageScope::FAudioImportStageScope(const TSharedPtr<FAudioImportStatsCollector, ESPMode::ThreadSafe>& StatsCollector, EAudioImportStage Stage)
+	: StageCounters{StatsCollector.IsValid() ? &StatsCollector->StageCounters[static_cast<uint8>(Stage)] : nullptr}
+  , PreviousStageCounters{GCurrentStageCounters}
+  , StartTime{StageCounters != nullptr ? FPlatformTime::Seconds() : 0}
+{
+	if (StageCounters != nullptr)
+	{
+		GCurrentStageCounters = StageCounters;
+	}
+}
+
+FAudioImportStageScope::FAudioImportStageScope(FAudioImportStageCounters* InStageCounters)
+	: StageCounters{InStageCounters}
+  , PreviousStageCounters{GCurrentStageCounters}
+  , StartTime{0}
+{
+	if (StageCounters != nullptr)
+	{
+		GCurrentStageCounters = StageCounters;
+	}
+}
+
+FAudioImportStageScope::~FAudioImportStageScope()
+{
+	if (StageCounters == nullptr)
+	{
+		return;
+	}
+
+	if (StartTime > 0)
+	{
+		StageCounters->Time = StageCounters->Time.Load() + (FPlatformTime::Seconds() - StartTime);
+	}
+
+	GCurrentStageCounters = PreviousStageCounters;
+}
+
+FAudioImportStageCounters* FAudioImportStageScope::GetCurrentStageCounters()
+{
+	return GCurrentStageCounters;
+}
+
+FAudioRenderAllocationScope::FAudioRenderAllocationScope()
+	: PreviousNumOfAllocations{GRenderCounters.NumOfAllocations.Load()}
+{
+	StageScope.Emplace(&GRenderCounters);
+}
+
+FAudioRenderAllocationScope::~FAudioRenderAllocationScope()
+{
+	StageScope.Reset();
+
+	// The stat is only updated when something was allocated, as updating it may allocate on its own
+	const int64 NumOfAllocations{GRenderCounters.NumOfAllocations.Load() - PreviousNumOfAllocations};
+	if (NumOfAllocations > 0)
+	{
+		INC_DWORD_STAT_BY(STAT_RuntimeAudioImporter_NumOfRenderAllocations, NumOfAllocations);
+	}
+}
+
+int64 FAudioRenderAllocationScope::GetNumOfAllocations()
+{
+	return GRenderCounters.NumOfAllocations.Load();
+}
@@ -0,0 +1,149 @@
+// Georgy Treshchev 2022.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RuntimeAudioImporterTypes.h"
+
+/** Stages of the audio import the statistics are collected for */
+enum class EAudioImportStage : uint8
+{
+	Read,
+	Copy,
+	Decode,
+	Convert,
+	Attach,
+
+	Count
+};
+
+/** Counters of a single stage of the audio import. Updated from any thread running the stage */
+struct FAudioImportStageCounters
+{
+	TAtomic<int64> NumOfCopiedBytes{0};
+	TAtomic<int64> NumOfAllocations{0};
+	TAtomic<int64> AllocatedBytes{0};
+	TAtomic<int64> PeakAllocatedBytes{0};
+	TAtomic<double> Time{0};
+};
+
+/**
+ * Allocator proxy which accounts the allocations to the stage running on the allocating thread, and to the global counters on top of the stack regardless of the thread
+ * Shared by the import statistics and the benchmark. Installed as the global allocator once and never uninstalled, as allocations made through it may be freed at any time and other threads may still be inside it
+ */
+class FAudioAllocationTracker
+{
+public:
+	/**
+	 * Install the tracker as the global allocator, unless it is installed already. Only allowed on the game thread
+	 *
+	 * @return Whether the tracker is installed
+	 */
+	static bool Install();
+
+	/** Whether the tracker has been installed */
+	static bool IsInstalled();
+
+	/**
+	 * Account the allocations from all threads to the counters, until they are popped. Counters pushed later take precedence
+	 * The counters must outlive the tracker, since a thread may still be accounting to them right after they have been popped
+	 *
+	 * @param Counters Counters to account the allocations to
+	 */
+	static void PushGlobalCounters(FAudioImportStageCounters* Counters);
+
+	/**
+	 * Stop accounting the allocations to the counters
+	 *
+	 * @param Counters Counters previously pushed
+	 */
+	static void PopGlobalCounters(FAudioImportStageCounters* Counters);
+};
+
+/**
+ * Collects the statistics of a single audio import. The stages may run on different threads, and the collector is shared between them
+ */
+class FAudioImportStatsCollector
+{
+public:
+	FAudioImportStatsCollector();
+
+	/**
+	 * Account for the bytes copied by the stage running on the current thread. Does nothing if no stage is running
+	 *
+	 * @param NumOfBytes Number of copied bytes
+	 */
+	static void AddCopiedBytes(int64 NumOfBytes);
+
+	/**
+	 * Get the collected statistics, publishing them to the stat counters the first time
+	 */
+	FAudioImportStats Finish();
+
+private:
+	friend class FAudioImportStageScope;
+
+	/** Counters of each stage */
+	FAudioImportStageCounters StageCounters[static_cast<uint8>(EAudioImportStage::Count)];
+
+	/** Whether the allocations are tracked for this import */
+	bool bAllocationsTracked;
+
+	/** Whether the statistics have already been published to the stat counters */
+	TAtomic<bool> bPublished{false};
+};
+
+/**
+ * Collects the statistics of the stage for the lifetime of the scope on the current thread. Scopes can be nested, in which case the innermost stage is accounted for
+ */
+class FAudioImportStageScope
+{
+public:
+	/**
+	 * Start collecting the statistics of the stage
+	 *
+	 * @param StatsCollector The collector of the import. Nothing is collected if null
+	 * @param Stage The stage to collect the statistics of
+	 */
+	FAudioImportStageScope(const TSharedPtr<FAudioImportStatsCollector, ESPMode::ThreadSafe>& StatsCollector, EAudioImportStage Stage);
+
+	/**
+	 * Continue collecting the statistics of the stage on another thread, such as in the parallel decoding tasks. The time is accounted for by the scope that started the stage only
+	 *
+	 * @param InStageCounters Counters of the stage, obtained from GetCurrentStageCounters on the thread that started the stage. Nothing is collected if null
+	 */
+	explicit FAudioImportStageScope(FAudioImportStageCounters* InStageCounters);
+
+	~FAudioImportStageScope();
+
+	/** Get the counters of the stage running on the current thread, or null if there is none */
+	static FAudioImportStageCounters* GetCurrentStageCounters();
+
+private:
+	FAudioImportStageCounters* StageCounters;
+	FAudioImportStageCounters* PreviousStageCounters;
+
+	/** Time the stage started at, or zero if the time is not accounted for */
+	double StartTime;
+};
+
+/**
+ * Counts the allocations made by the imported sound waves while rendering on the audio thread for the lifetime of the scope, which are expected to be none once the playback has warmed up
+ * The allocations are only counted once the tracker has been installed on the game thread, see RuntimeAudioImporter.TrackImportAllocations
+ */
+class FAudioRenderAllocationScope
+{
+public:
+	FAudioRenderAllocationScope();
+	~FAudioRenderAllocationScope();
+
+	/** Get the total number of allocations made while rendering */
+	static int64 GetNumOfAllocations();
+
+private:
+	/** Ends before the stat is updated, so that the allocations made by the stats system are not counted */
+	TOptional<FAudioImportStageScope> StageScope;
+
+	/** Number of allocations made while rendering before the scope started */
+	int64 PreviousNumOfAllocations;
+};
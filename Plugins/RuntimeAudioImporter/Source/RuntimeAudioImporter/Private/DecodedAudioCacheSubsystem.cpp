@@ -0,0 +1,142 @@
+// Georgy Treshchev 2022.
+
+#include "DecodedAudioCacheSubsystem.h"
+#include "RuntimeAudioImporterDefines.h"
+
+#include "Engine/Engine.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+static TAutoConsoleVariable<int32> CVarDecodedAudioCacheMaxMegabytes(
+	TEXT("RuntimeAudioImporter.DecodedAudioCacheMaxMegabytes"),
+	256,
+	TEXT("The memory budget of the decoded audio cache shared between the imported sound waves, in megabytes. The least recently used entries are evicted when it is exceeded.\n")
+	TEXT("0: Disable the cache"));
+
+UDecodedAudioCacheSubsystem* UDecodedAudioCacheSubsystem::Get()
+{
+	return GEngine != nullptr ? GEngine->GetEngineSubsystem<UDecodedAudioCacheSubsystem>() : nullptr;
+}
+
+FString UDecodedAudioCacheSubsystem::MakeFileCacheKey(const FString& FilePath, EPCMStorageFormat StorageFormat, int32 SampleRate)
+{
+	const FFileStatData StatData{IFileManager::Get().GetStatData(*FilePath)};
+
+	if (!StatData.bIsValid || StatData.bIsDirectory)
+	{
+		return FString();
+	}
+
+	return FString::Printf(TEXT("%s|%lld|%lld|%d|%d"), *FPaths::ConvertRelativePathToFull(FilePath), StatData.FileSize, StatData.ModificationTime.GetTicks(), static_cast<int32>(StorageFormat), SampleRate);
+}
+
+bool UDecodedAudioCacheSubsystem::Find(const FString& CacheKey, FDecodedAudioStruct& DecodedAudioInfo)
+{
+	FScopeLock Lock(&CacheGuard);
+
+	FDecodedAudioCacheEntry* CacheEntry = Entries.Find(CacheKey);
+
+	if (CacheEntry == nullptr)
+	{
+		++NumOfMisses;
+		return false;
+	}
+
+	++NumOfHits;
+	CacheEntry->LastAccess = ++AccessCounter;
+
+	DecodedAudioInfo.SoundWaveBasicInfo = CacheEntry->SoundWaveBasicInfo;
+	DecodedAudioInfo.PCMInfo.PCMData = FRuntimeBulkDataBuffer<uint8>(CacheEntry->PCMData);
+	DecodedAudioInfo.PCMInfo.PCMNumOfFrames = CacheEntry->PCMNumOfFrames;
+	DecodedAudioInfo.PCMInfo.StorageFormat = CacheEntry->StorageFormat;
+
+	return true;
+}
+
+void UDecodedAudioCacheSubsystem::Add(const FString& CacheKey, FDecodedAudioStruct& DecodedAudioInfo)
+{
+	const int64 MaxCachedBytes{static_cast<int64>(FMath::Max(CVarDecodedAudioCacheMaxMegabytes.GetValueOnAnyThread(), 0)) * 1024 * 1024};
+	const int64 PCMDataSize{DecodedAudioInfo.PCMInfo.PCMData.GetView().Num()};
+
+	// Audio data exceeding the whole budget on its own would only evict everything else
+	if (CacheKey.IsEmpty() || PCMDataSize == 0 || PCMDataSize > MaxCachedBytes)
+	{
+		return;
+	}
+
+	// Moving the PCM data into a shared buffer without copying it, so that both the cache and the sound wave reference it
+	const TSharedRef<const FRuntimeBulkDataBuffer<uint8>, ESPMode::ThreadSafe> SharedPCMData = MakeShared<FRuntimeBulkDataBuffer<uint8>, ESPMode::ThreadSafe>(MoveTemp(DecodedAudioInfo.PCMInfo.PCMData));
+	DecodedAudioInfo.PCMInfo.PCMData = FRuntimeBulkDataBuffer<uint8>(SharedPCMData);
+
+	FScopeLock Lock(&CacheGuard);
+
+	// The same source may have been imported concurrently, in which case the newer decoded audio data replaces the older one
+	if (const FDecodedAudioCacheEntry* ExistingCacheEntry = Entries.Find(CacheKey))
+	{
+		CachedBytes -= ExistingCacheEntry->PCMData->GetView().Num();
+	}
+
+	Entries.Add(CacheKey, FDecodedAudioCacheEntry{DecodedAudioInfo.SoundWaveBasicInfo, SharedPCMData, DecodedAudioInfo.PCMInfo.PCMNumOfFrames, DecodedAudioInfo.PCMInfo.StorageFormat, ++AccessCounter});
+	CachedBytes += PCMDataSize;
+
+	EvictEntries(MaxCachedBytes);
+}
+
+void UDecodedAudioCacheSubsystem::Empty()
+{
+	FScopeLock Lock(&CacheGuard);
+
+	Entries.Empty();
+	CachedBytes = 0;
+}
+
+FDecodedAudioCacheStats UDecodedAudioCacheSubsystem::GetStats() const
+{
+	FScopeLock Lock(&CacheGuard);
+
+	FDecodedAudioCacheStats Stats;
+	{
+		Stats.NumOfHits = NumOfHits;
+		Stats.NumOfMisses = NumOfMisses;
+		Stats.NumOfEvictions = NumOfEvictions;
+		Stats.NumOfEntries = Entries.Num();
+		Stats.CachedBytes = CachedBytes;
+		Stats.MaxCachedBytes = static_cast<int64>(FMath::Max(CVarDecodedAudioCacheMaxMegabytes.GetValueOnAnyThread(), 0)) * 1024 * 1024;
+	}
+
+	return Stats;
+}
+
+void UDecodedAudioCacheSubsystem::Deinitialize()
+{
+	Empty();
+
+	Super::Deinitialize();
+}
+
+void UDecodedAudioCacheSubsystem::EvictEntries(int64 MaxCachedBytes)
+{
+	while (CachedBytes > MaxCachedBytes && Entries.Num() > 0)
+	{
+		// The number of entries is small, so a linear search for the least recently used one is cheap compared to decoding
+		const TPair<FString, FDecodedAudioCacheEntry>* LeastRecentlyUsedEntry{nullptr};
+		for (const TPair<FString, FDecodedAudioCacheEntry>& Entry : Entries)
+		{
+			if (LeastRecentlyUsedEntry == nullptr || Entry.Value.LastAccess < LeastRecentlyUsedEntry->Value.LastAccess)
+			{
+				LeastRecentlyUsedEntry = &Entry;
+			}
+		}
+
+		const FString CacheKey{LeastRecentlyUsedEntry->Key};
+
+		UE_LOG(LogRuntimeAudioImporter, Log, TEXT("Evicted '%s' from the decoded audio cache"), *CacheKey);
+
+		CachedBytes -= LeastRecentlyUsedEntry->Value.PCMData->GetView().Num();
+		++NumOfEvictions;
+
+		Entries.Remove(CacheKey);
+	}
+}
@@ -2,13 +2,83 @@
 
 #include "ImportedSoundWave.h"
 #include "RuntimeAudioImporterDefines.h"
-
+#include "AudioImportStatsCollector.h"
 #include "Async/Async.h"
+#include "Transcoders/RAWTranscoder.h"
+
+namespace
+{
+	/**
+	 * Crossfade the PCM data towards the target PCM data in place
+	 *
+	 * @param PCMData Interleaved PCM data to fade out
+	 * @param TargetPCMData Interleaved PCM data to fade in, starting at the beginning of the crossfade
+	 * @param NumOfFrames Number of frames to crossfade
+	 * @param NumOfChannels Number of channels
+	 * @param FirstFadeIndex Index of the first frame within the crossfade
+	 * @param NumOfFadeFrames Total number of frames of the crossfade
+	 * @param NumOfAvailableTargetFrames Number of target frames available. The rest are treated as silence, e.g. while the target is still being decoded
+	 * @param bEqualPower Whether to keep the power constant instead of the amplitude
+	 * @param bFadeIn Whether the PCM data fades in and the target PCM data fades out instead
+	 */
+	template <typename SampleType>
+	void CrossfadePCMData(SampleType* PCMData, const SampleType* TargetPCMData, int32 NumOfFrames, int32 NumOfChannels, uint32 FirstFadeIndex, uint32 NumOfFadeFrames, uint32 NumOfAvailableTargetFrames, bool bEqualPower, bool bFadeIn = false)
+	{
+		for (int32 FrameIndex = 0; FrameIndex < NumOfFrames; ++FrameIndex)
+		{
+			const uint32 FadeIndex{FirstFadeIndex + FrameIndex};
+			const float Alpha{static_cast<float>(FadeIndex + 1) / (NumOfFadeFrames + 1)};
+
+			float Gain{bEqualPower ? FMath::Cos(Alpha * HALF_PI) : 1.f - Alpha};
+			float TargetGain{bEqualPower ? FMath::Sin(Alpha * HALF_PI) : Alpha};
+
+			if (bFadeIn)
+			{
+				Swap(Gain, TargetGain);
+			}
+
+			SampleType* Frame{PCMData + FrameIndex * NumOfChannels};
+			const SampleType* TargetFrame{FadeIndex < NumOfAvailableTargetFrames ? TargetPCMData + static_cast<int64>(FadeIndex) * NumOfChannels : nullptr};
+
+			for (int32 ChannelIndex = 0; ChannelIndex < NumOfChannels; ++ChannelIndex)
+			{
+				const float Sample{static_cast<float>(Frame[ChannelIndex]) * Gain + (TargetFrame != nullptr ? static_cast<float>(TargetFrame[ChannelIndex]) * TargetGain : 0.f)};
+
+				if (TIsSame<SampleType, int16>::Value)
+				{
+					Frame[ChannelIndex] = static_cast<SampleType>(FMath::Clamp(FMath::RoundToInt(Sample), -32768, 32767));
+				}
+				else
+				{
+					Frame[ChannelIndex] = static_cast<SampleType>(Sample);
+				}
+			}
+		}
+	}
+}
+
+void UImportedSoundWave::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	if (HasAnyFlags(RF_ClassDefaultObject))
+	{
+		return;
+	}
+
+	// The blocks are allocated in advance so that the generation requests do not have to
+	for (TSharedPtr<FImportedPCMDataBlock, ESPMode::ThreadSafe>& PCMDataBlock : PCMDataBlockPool)
+	{
+		PCMDataBlock = MakeShared<FImportedPCMDataBlock, ESPMode::ThreadSafe>();
+	}
+}
 
 void UImportedSoundWave::BeginDestroy()
 {
 	UE_LOG(LogRuntimeAudioImporter, Warning, TEXT("Imported sound wave ('%s') data will be cleared because it is being unloaded"), *GetName());
 
+	FTSTicker::GetCoreTicker().RemoveTicker(PlaybackEventsTickerHandle);
+
 	Super::BeginDestroy();
 }
 
@@ -16,9 +86,28 @@ void UImportedSoundWave::ReleaseMemory()
 {
 	UE_LOG(LogRuntimeAudioImporter, Warning, TEXT("Releasing memory for the sound wave '%s'"), *GetName());
 
+	// Declared before the lock, so that the PCM data of the queued sound waves is released after unlocking
+	TArray<FQueuedPCMSource> RemovedSources;
+
+	FScopeLock Lock(&DataGuard);
+
+	bAwaitingPCMData = false;
+	NumOfDecodedFrames = 0;
+	PlayingNumOfDecodedFrames = &NumOfDecodedFrames;
+	PendingPrefetchFrame = -1;
+	PrefetchedStartFrame = 0;
+	PrefetchedEndFrame = 0;
 	PCMBufferInfo.PCMData.Empty();
+	PCMBufferInfo.PCMNumOfFrames = 0;
 
-	PCMBufferInfo.~FPCMStruct();
+	// The queued sound waves are removed along with their PCM data, including the ones the playback has already switched to
+	RemovedSources = MoveTemp(QueuedPCMSources);
+	QueuedSoundWaves.Empty();
+	PlayingQueuedSoundWave = nullptr;
+	NumOfStartedQueuedPCMSources = 0;
+	NumOfRemainingLoops = 0;
+
+	TimeStretcher.Reset();
 }
 
 bool UImportedSoundWave::RewindPlaybackTime(const float PlaybackTime)
@@ -34,23 +123,286 @@ bool UImportedSoundWave::RewindPlaybackTime(const float PlaybackTime)
 
 bool UImportedSoundWave::ChangeCurrentFrameCount(const uint32 NumOfFrames)
 {
-	if (NumOfFrames < 0 || NumOfFrames > PCMBufferInfo.PCMNumOfFrames)
+	// The PCM data is replaced when switching to a queued sound wave, so it is only checked under the lock
+	FScopeLock Lock(&DataGuard);
+
+	if (NumOfFrames > PCMBufferInfo.PCMNumOfFrames)
 	{
 		UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Cannot change the current frame for the imported sound wave '%s' to frame '%d' because the total number of frames is '%d'"), *GetName(), NumOfFrames, PCMBufferInfo.PCMNumOfFrames);
 		return false;
 	}
 
-	CurrentNumOfFrames = NumOfFrames;
+	// The playback position is only changed by the generation requests, which apply the latest seek at the next block boundary
+	PendingSeekFrame = NumOfFrames;
+
+	// The streaming decoder decodes the target ahead of the rest, so that the playback does not wait for the decoder to get there. It only decodes into the own PCM data, not into the one of a queued sound wave being played
+	if (PlayingNumOfDecodedFrames == &NumOfDecodedFrames && NumOfFrames >= NumOfDecodedFrames && (NumOfFrames < PrefetchedStartFrame || NumOfFrames >= PrefetchedEndFrame))
+	{
+		PendingPrefetchFrame = NumOfFrames;
+	}
 
 	// Setting "PlaybackFinishedBroadcast" to "false" in order to re-broadcast the "OnAudioPlaybackFinished" delegate again
 	PlaybackFinishedBroadcast = false;
+	bPlaybackFinishedPending = false;
 
 	return true;
 }
 
+bool UImportedSoundWave::AppendPCMData(const uint8* PCMData, uint32 NumOfFrames)
+{
+	// Growing the buffer copies all the PCM data appended so far, which is done outside the lock so that the playback does not wait for it
+	// The PCM data being copied is shared in the meantime, which keeps it alive and unchanged. Declared before the lock, so that the replaced buffer is released after unlocking
+	FRuntimeBulkDataBuffer<uint8> SourcePCMData;
+	FRuntimeBulkDataBuffer<uint8> GrownPCMData;
+	bool bGrown{false};
+
+	while (true)
+	{
+		int64 AppendedDataSize;
+
+		{
+			FScopeLock Lock(&DataGuard);
+
+			if (!bAwaitingPCMData)
+			{
+				UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Unable to append PCM data to the sound wave '%s' because it does not await PCM data"), *GetName());
+				return false;
+			}
+
+			// The grown buffer is discarded if the PCM data was changed while it was being copied, e.g. by another append
+			if (bGrown && PCMBufferInfo.PCMData.GetView().GetData() == SourcePCMData.GetView().GetData() && PCMBufferInfo.PCMData.GetView().Num() == SourcePCMData.GetView().Num())
+			{
+				PCMBufferInfo.PCMData = MoveTemp(GrownPCMData);
+			}
+
+			AppendedDataSize = static_cast<int64>(NumOfFrames) * NumChannels * PCMBufferInfo.GetSampleSize();
+
+			if (PCMBufferInfo.PCMData.GetSlack() >= AppendedDataSize)
+			{
+				PCMBufferInfo.PCMData.Append(PCMData, AppendedDataSize);
+				PCMBufferInfo.PCMNumOfFrames += NumOfFrames;
+				NumOfDecodedFrames = PCMBufferInfo.PCMNumOfFrames;
+
+				RawPCMDataSize = PCMBufferInfo.PCMData.GetView().Num();
+				Duration = static_cast<float>(PCMBufferInfo.PCMNumOfFrames) / SampleRate;
+
+				return true;
+			}
+
+			SourcePCMData = PCMBufferInfo.PCMData.Share();
+		}
+
+		// The buffer grows geometrically, so that appending in small portions takes amortized constant time
+		GrownPCMData = SourcePCMData.Clone(FMath::Max<int64>(AppendedDataSize, SourcePCMData.GetView().Num()));
+		bGrown = true;
+	}
+}
+
+void UImportedSoundWave::TruncatePCMData(uint32 NumOfFrames)
+{
+	FScopeLock Lock(&DataGuard);
+
+	if (PlayingNumOfDecodedFrames != &NumOfDecodedFrames || PCMBufferInfo.PCMData.GetView().GetData() == nullptr || NumOfFrames >= PCMBufferInfo.PCMNumOfFrames)
+	{
+		return;
+	}
+
+	PCMBufferInfo.PCMNumOfFrames = NumOfFrames;
+	NumOfDecodedFrames = FMath::Min<uint32>(NumOfDecodedFrames, NumOfFrames);
+
+	// The frames prefetched beyond the decoded ones are no longer played
+	PendingPrefetchFrame = -1;
+	PrefetchedStartFrame = 0;
+	PrefetchedEndFrame = 0;
+
+	// The loop region must not reach beyond the frames that are left
+	if (LoopEndFrame > NumOfFrames)
+	{
+		NumOfRemainingLoops = 0;
+	}
+
+	Duration = static_cast<float>(NumOfFrames) / SampleRate;
+}
+
+FPCMStruct UImportedSoundWave::SharePCMData()
+{
+	FScopeLock Lock(&DataGuard);
+	return PCMBufferInfo.Share();
+}
+
+bool UImportedSoundWave::EnqueueSoundWave(UImportedSoundWave* SoundWave)
+{
+	if (!IsValid(SoundWave) || SoundWave == this)
+	{
+		UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Unable to queue an invalid sound wave after the sound wave '%s'"), *GetName());
+		return false;
+	}
+
+	if (SoundWave->NumChannels != NumChannels || SoundWave->GetSampleRate() != GetSampleRate() || SoundWave->PCMBufferInfo.StorageFormat != PCMBufferInfo.StorageFormat)
+	{
+		UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Unable to queue the sound wave '%s' after the sound wave '%s' because their formats differ (%d and %d channels, %d and %d sample rate, %s and %s storage format)"),
+		       *SoundWave->GetName(), *GetName(), SoundWave->NumChannels, NumChannels, SoundWave->GetSampleRate(), GetSampleRate(),
+		       *UEnum::GetValueAsName(SoundWave->PCMBufferInfo.StorageFormat).ToString(), *UEnum::GetValueAsName(PCMBufferInfo.StorageFormat).ToString());
+		return false;
+	}
+
+	// Appending to the PCM data reallocates it, so the shared PCM data would not receive the appended frames
+	if (SoundWave->bAwaitingPCMData)
+	{
+		UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Unable to queue the sound wave '%s' because PCM data is still being appended to it"), *SoundWave->GetName());
+		return false;
+	}
+
+	FQueuedPCMSource QueuedSource{SoundWave->SharePCMData(), &SoundWave->NumOfDecodedFrames, SoundWave->Duration};
+
+	FScopeLock Lock(&DataGuard);
+
+	QueuedSoundWaves.Add(SoundWave);
+	QueuedPCMSources.Add(MoveTemp(QueuedSource));
+
+	return true;
+}
+
+void UImportedSoundWave::ClearQueue()
+{
+	TArray<FQueuedPCMSource> RemovedSources;
+
+	{
+		FScopeLock Lock(&DataGuard);
+
+		for (int32 SourceIndex = NumOfStartedQueuedPCMSources; SourceIndex < QueuedPCMSources.Num(); ++SourceIndex)
+		{
+			RemovedSources.Add(MoveTemp(QueuedPCMSources[SourceIndex]));
+		}
+
+		QueuedPCMSources.SetNum(NumOfStartedQueuedPCMSources);
+		QueuedSoundWaves.SetNum(NumOfStartedQueuedPCMSources);
+	}
+}
+
+int32 UImportedSoundWave::GetNumOfQueuedSoundWaves()
+{
+	FScopeLock Lock(&DataGuard);
+	return QueuedPCMSources.Num() - NumOfStartedQueuedPCMSources;
+}
+
+bool UImportedSoundWave::SetLoopRegion(float StartTime, float EndTime, int32 NumOfLoops)
+{
+	FScopeLock Lock(&DataGuard);
+
+	const uint32 StartFrame{static_cast<uint32>(FMath::Max(FMath::RoundToInt(StartTime * GetSampleRate()), 0))};
+	const uint32 EndFrame{EndTime > 0 ? static_cast<uint32>(FMath::Max(FMath::RoundToInt(EndTime * GetSampleRate()), 0)) : PCMBufferInfo.PCMNumOfFrames};
+
+	if (StartFrame >= EndFrame || EndFrame > PCMBufferInfo.PCMNumOfFrames)
+	{
+		UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Unable to loop the region from '%f' to '%f' of the sound wave '%s' with duration '%f'"), StartTime, EndTime, *GetName(), Duration);
+		return false;
+	}
+
+	LoopStartFrame = StartFrame;
+	LoopEndFrame = EndFrame;
+	NumOfRemainingLoops = NumOfLoops < 0 ? -1 : NumOfLoops;
+
+	return true;
+}
+
+void UImportedSoundWave::ClearLoopRegion()
+{
+	FScopeLock Lock(&DataGuard);
+	NumOfRemainingLoops = 0;
+}
+
+void UImportedSoundWave::SetCrossfadeDuration(float CrossfadeDuration)
+{
+	FScopeLock Lock(&DataGuard);
+	NumOfCrossfadeFrames = static_cast<uint32>(FMath::Max(FMath::RoundToInt(CrossfadeDuration * GetSampleRate()), 0));
+}
+
+void UImportedSoundWave::SetTimeStretch(float Tempo, float PitchShift)
+{
+	if (NumChannels <= 0 || SampleRate <= 0)
+	{
+		UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Unable to time stretch the imported sound wave '%s' because it has no audio data imported"), *GetName());
+		return;
+	}
+
+	{
+		FScopeLock Lock(&DataGuard);
+
+		if (IsTimeStretcherCompatible())
+		{
+			TimeStretcher->SetTempo(Tempo);
+			TimeStretcher->SetPitchShift(PitchShift);
+			return;
+		}
+	}
+
+	// Allocated outside of the data guard so that the generation requests are not blocked meanwhile
+	TUniquePtr<FImportedSoundWaveTimeStretcher> NewTimeStretcher{MakeUnique<FImportedSoundWaveTimeStretcher>(SampleRate, NumChannels)};
+
+	FScopeLock Lock(&DataGuard);
+
+	// The replaced time stretcher, if any, is released once the data guard is unlocked
+	if (!IsTimeStretcherCompatible())
+	{
+		NewTimeStretcher->Reset(CurrentNumOfFrames);
+		Swap(TimeStretcher, NewTimeStretcher);
+	}
+
+	TimeStretcher->SetTempo(Tempo);
+	TimeStretcher->SetPitchShift(PitchShift);
+}
+
+bool UImportedSoundWave::IsTimeStretcherCompatible() const
+{
+	return TimeStretcher.IsValid() && TimeStretcher->GetNumOfChannels() == NumChannels && TimeStretcher->GetSampleRate() == SampleRate;
+}
+
+void UImportedSoundWave::ClearTimeStretch()
+{
+	TUniquePtr<FImportedSoundWaveTimeStretcher> ReleasedTimeStretcher;
+
+	// Released outside of the data guard so that the generation requests are not blocked meanwhile
+	{
+		FScopeLock Lock(&DataGuard);
+		ReleasedTimeStretcher = MoveTemp(TimeStretcher);
+	}
+}
+
+TSharedRef<const FImportedSoundWaveTap, ESPMode::ThreadSafe> UImportedSoundWave::GetTap(int32 NumOfFrames)
+{
+	{
+		FScopeLock Lock(&DataGuard);
+
+		if (Tap.IsValid())
+		{
+			return Tap.ToSharedRef();
+		}
+	}
+
+	// Allocated outside of the data guard so that the generation requests are not blocked meanwhile
+	TSharedRef<FImportedSoundWaveTap, ESPMode::ThreadSafe> NewTap = MakeShared<FImportedSoundWaveTap, ESPMode::ThreadSafe>(NumOfFrames, NumChannels);
+
+	FScopeLock Lock(&DataGuard);
+
+	if (!Tap.IsValid())
+	{
+		Tap = NewTap;
+	}
+
+	return Tap.ToSharedRef();
+}
+
 float UImportedSoundWave::GetPlaybackTime() const
 {
-	return static_cast<float>(CurrentNumOfFrames) / SampleRate;
+	// A pending seek is reported right away, even though it is yet to be applied
+	const int64 SeekFrame{PendingSeekFrame};
+	return static_cast<float>(SeekFrame >= 0 ? SeekFrame : CurrentNumOfFrames.Load()) / SampleRate;
+}
+
+int32 UImportedSoundWave::GetCurrentNumOfFrames() const
+{
+	return static_cast<int32>(CurrentNumOfFrames.Load());
 }
 
 float UImportedSoundWave::GetDurationConst() const
@@ -141,76 +493,420 @@ float UImportedSoundWave::GetPlaybackPercentage() const
 
 bool UImportedSoundWave::IsPlaybackFinished()
 {
+	FScopeLock Lock(&DataGuard);
 	return GetPlaybackPercentage() == 100 && PCMBufferInfo.PCMData.GetView().GetData() != nullptr && PCMBufferInfo.PCMNumOfFrames > 0 && PCMBufferInfo.PCMData.GetView().Num() > 0;
 }
 
 int32 UImportedSoundWave::OnGeneratePCMAudio(TArray<uint8>& OutAudio, int32 NumSamples)
 {
-	// Ensure there is enough number of frames. Lack of frames means audio playback has finished
-	if (static_cast<uint32>(CurrentNumOfFrames) >= PCMBufferInfo.PCMNumOfFrames)
+	FAudioRenderAllocationScope AllocationScope;
+
+	// The playback events are polled by a core ticker instead of being posted as tasks, since posting a task allocates. The ticker is registered once, on the first generation request
+	if (!bPlaybackEventsTickerRequested.Exchange(true))
 	{
-		AsyncTask(ENamedThreads::GameThread, [this]()
+		AsyncTask(ENamedThreads::GameThread, [WeakThis = MakeWeakObjectPtr(this)]()
 		{
-			if (!PlaybackFinishedBroadcast)
+			if (WeakThis.IsValid())
 			{
-				UE_LOG(LogRuntimeAudioImporter, Warning, TEXT("Playback of the sound wave '%s' has been completed"), *GetName());
+				WeakThis->PlaybackEventsTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(WeakThis.Get(), &UImportedSoundWave::BroadcastPendingPlaybackEvents));
+			}
+		});
+	}
 
-				PlaybackFinishedBroadcast = true;
+	FScopeLock Lock(&DataGuard);
 
-				if (OnAudioPlaybackFinishedNative.IsBound())
+	if (NumChannels <= 0 || NumSamples <= 0)
+	{
+		return 0;
+	}
+
+	const int32 FrameSize{NumChannels * PCMBufferInfo.GetSampleSize()};
+
+	// Applying the seek posted since the previous generation request. The PCM data that would have been played without it is faded out
+	const uint8* PreviousPCMData{nullptr};
+	uint32 NumOfPreviousFrames{0};
+
+	const int64 SeekFrame{PendingSeekFrame.Exchange(-1)};
+	if (SeekFrame >= 0)
+	{
+		const uint32 PreviousFrame{static_cast<uint32>(CurrentNumOfFrames)};
+		const uint32 PreviousEndFrame{GetAvailableEndFrame(PreviousFrame, PCMBufferInfo.PCMNumOfFrames)};
+
+		if (PreviousFrame < PreviousEndFrame && PCMBufferInfo.PCMData.GetView().GetData() != nullptr)
+		{
+			PreviousPCMData = PCMBufferInfo.PCMData.GetView().GetData() + static_cast<int64>(PreviousFrame) * FrameSize;
+			NumOfPreviousFrames = PreviousEndFrame - PreviousFrame;
+		}
+
+		CurrentNumOfFrames = static_cast<uint32>(FMath::Min<int64>(SeekFrame, PCMBufferInfo.PCMNumOfFrames));
+	}
+
+	// Filling in OutAudio array directly. The engine reuses the array, so it is not reallocated once it is large enough
+	OutAudio.SetNumUninitialized(NumSamples / NumChannels * FrameSize, false);
+
+	const int32 NumOfRenderedFrames{RenderPCMData(OutAudio.GetData(), NumSamples / NumChannels)};
+
+	// Lack of frames means audio playback has finished
+	if (NumOfRenderedFrames <= 0)
+	{
+		OutAudio.Reset();
+		bPlaybackFinishedPending = true;
+		return 0;
+	}
+
+	OutAudio.SetNumUninitialized(NumOfRenderedFrames * FrameSize, false);
+	NumSamples = NumOfRenderedFrames * NumChannels;
+
+	// The time stretcher crossfades into the seek target on its own
+	if (SeekFrame >= 0 && !IsTimeStretcherCompatible())
+	{
+		FadeInSeek(OutAudio.GetData(), NumOfRenderedFrames, PreviousPCMData, NumOfPreviousFrames);
+	}
+
+	if (Tap.IsValid() && Tap->GetNumOfChannels() == NumChannels)
+	{
+		Tap->Write(OutAudio.GetData(), PCMBufferInfo.StorageFormat, NumOfRenderedFrames);
+	}
+
+	if (OnGeneratePCMDataNative.IsBound() || OnGeneratePCMData.IsBound() || OnGeneratePCMDataBlockNative.IsBound())
+	{
+		QueuePCMDataBlock(OutAudio.GetData(), NumSamples);
+	}
+
+	return NumSamples;
+}
+
+int32 UImportedSoundWave::RenderPCMData(uint8* OutPCMData, int32 NumOfFrames)
+{
+	const int32 FrameSize{NumChannels * PCMBufferInfo.GetSampleSize()};
+	int32 NumOfRenderedFrames{0};
+
+	while (NumOfRenderedFrames < NumOfFrames)
+	{
+		const bool bLooping{NumOfRemainingLoops != 0};
+		const uint32 SegmentEndFrame{bLooping ? LoopEndFrame : PCMBufferInfo.PCMNumOfFrames};
+
+		if (static_cast<uint32>(CurrentNumOfFrames) >= SegmentEndFrame)
+		{
+			// The part before the loop start has already been crossfaded into the loop end, so the playback continues right at the loop start
+			if (bLooping)
+			{
+				CurrentNumOfFrames = LoopStartFrame;
+
+				if (NumOfRemainingLoops > 0)
 				{
-					OnAudioPlaybackFinishedNative.Broadcast();
+					--NumOfRemainingLoops;
 				}
-				
-				if (OnAudioPlaybackFinished.IsBound())
+
+				continue;
+			}
+
+			// More PCM data is yet to be appended, so filling in silence instead of finishing the playback
+			if (bAwaitingPCMData)
+			{
+				break;
+			}
+
+			// Switching to the next queued sound wave within the same generation request. Its crossfaded beginning has already been played, unless the time stretcher crossfades into it instead
+			if (NumOfStartedQueuedPCMSources < QueuedPCMSources.Num())
+			{
+				FQueuedPCMSource& QueuedSource{QueuedPCMSources[NumOfStartedQueuedPCMSources++]};
+				bQueuedSoundWaveStartedPending = true;
+				const uint32 NumOfPlayedFrames{IsTimeStretcherCompatible() ? 0 : GetNumOfCrossfadeFrames(QueuedSource)};
+
+				// The PCM data played so far is kept by the queued source, so that it is released on the game thread
+				Swap(PCMBufferInfo, QueuedSource.PCMBufferInfo);
+				PlayingNumOfDecodedFrames = QueuedSource.NumOfDecodedFrames;
+
+				Duration = QueuedSource.Duration;
+				RawPCMDataSize = PCMBufferInfo.PCMData.GetView().Num();
+				CurrentNumOfFrames = NumOfPlayedFrames;
+
+				continue;
+			}
+
+			return NumOfRenderedFrames;
+		}
+
+		// The streaming decoder has not caught up with the playback yet, so filling in silence instead of finishing the playback
+		const uint32 NumOfAvailableFrames{GetAvailableEndFrame(CurrentNumOfFrames, SegmentEndFrame)};
+		if (static_cast<uint32>(CurrentNumOfFrames) >= NumOfAvailableFrames || PCMBufferInfo.PCMData.GetView().GetData() == nullptr)
+		{
+			break;
+		}
+
+		uint8* SegmentPCMData{OutPCMData + NumOfRenderedFrames * FrameSize};
+
+		// The time stretcher reads the PCM data at its own pace, so the frames are not copied one to one
+		if (IsTimeStretcherCompatible())
+		{
+			// The playback position has been changed by a seek or a jump, which the time stretcher crossfades into
+			if (TimeStretcher->GetSourcePosition() != static_cast<uint32>(CurrentNumOfFrames))
+			{
+				TimeStretcher->SetSourcePosition(CurrentNumOfFrames);
+			}
+
+			// The frames beyond the segment end are treated as silence, unless more of them are yet to be decoded or appended
+			const bool bSegmentEnds{NumOfAvailableFrames == SegmentEndFrame && (bLooping || !bAwaitingPCMData)};
+			const int32 NumOfFramesToStretch{NumOfFrames - NumOfRenderedFrames};
+			const int32 NumOfStretchedFrames{TimeStretcher->Render(PCMBufferInfo.PCMData.GetView().GetData(), PCMBufferInfo.StorageFormat, NumOfAvailableFrames, bSegmentEnds, SegmentPCMData, NumOfFramesToStretch)};
+
+			CurrentNumOfFrames = FMath::Min(TimeStretcher->GetSourcePosition(), SegmentEndFrame);
+			NumOfRenderedFrames += NumOfStretchedFrames;
+
+			if (NumOfStretchedFrames < NumOfFramesToStretch)
+			{
+				if (!bSegmentEnds)
 				{
-					OnAudioPlaybackFinished.Broadcast();
+					break;
 				}
+
+				CurrentNumOfFrames = SegmentEndFrame;
 			}
-		});
 
-		return 0;
+			continue;
+		}
+
+		const int32 NumOfFramesToCopy{static_cast<int32>(FMath::Min<uint32>(NumOfAvailableFrames - CurrentNumOfFrames, NumOfFrames - NumOfRenderedFrames))};
+
+		FMemory::Memcpy(SegmentPCMData, PCMBufferInfo.PCMData.GetView().GetData() + static_cast<int64>(CurrentNumOfFrames) * FrameSize, NumOfFramesToCopy * FrameSize);
+		CrossfadeToNextSegment(SegmentPCMData, CurrentNumOfFrames, NumOfFramesToCopy, SegmentEndFrame, bLooping);
+
+		// Increasing CurrentFrameCount for correct iteration sequence
+		CurrentNumOfFrames = CurrentNumOfFrames + NumOfFramesToCopy;
+		NumOfRenderedFrames += NumOfFramesToCopy;
 	}
 
-	// Getting the remaining number of samples if the required number of samples is greater than the total available number
-	if (static_cast<uint32>(CurrentNumOfFrames) + static_cast<uint32>(NumSamples) / static_cast<uint32>(NumChannels) >= PCMBufferInfo.PCMNumOfFrames)
+	FMemory::Memzero(OutPCMData + NumOfRenderedFrames * FrameSize, (NumOfFrames - NumOfRenderedFrames) * FrameSize);
+
+	return NumOfFrames;
+}
+
+void UImportedSoundWave::CrossfadeToNextSegment(uint8* PCMData, uint32 StartFrame, int32 NumOfFrames, uint32 SegmentEndFrame, bool bLooping) const
+{
+	const int32 FrameSize{NumChannels * PCMBufferInfo.GetSampleSize()};
+
+	uint32 NumOfFadeFrames;
+	const uint8* TargetPCMData;
+	uint32 NumOfAvailableTargetFrames;
+
+	if (bLooping)
 	{
-		NumSamples = (PCMBufferInfo.PCMNumOfFrames - CurrentNumOfFrames) * NumChannels;
+		// The loop end fades into the part right before the loop start
+		NumOfFadeFrames = FMath::Min3(NumOfCrossfadeFrames, LoopStartFrame, LoopEndFrame - LoopStartFrame);
+		TargetPCMData = PCMBufferInfo.PCMData.GetView().GetData() + static_cast<int64>(LoopStartFrame - NumOfFadeFrames) * FrameSize;
+		NumOfAvailableTargetFrames = NumOfFadeFrames;
+	}
+	else if (!bAwaitingPCMData && NumOfStartedQueuedPCMSources < QueuedPCMSources.Num())
+	{
+		// The end fades into the beginning of the next queued sound wave
+		const FQueuedPCMSource& QueuedSource{QueuedPCMSources[NumOfStartedQueuedPCMSources]};
+		NumOfFadeFrames = GetNumOfCrossfadeFrames(QueuedSource);
+		TargetPCMData = QueuedSource.PCMBufferInfo.PCMData.GetView().GetData();
+		NumOfAvailableTargetFrames = FMath::Min<uint32>(NumOfFadeFrames, *QueuedSource.NumOfDecodedFrames);
+	}
+	else
+	{
+		return;
+	}
+
+	if (NumOfFadeFrames == 0 || TargetPCMData == nullptr)
+	{
+		return;
 	}
 
-	// Retrieving a part of PCM data
-	uint8* RetrievedPCMData = PCMBufferInfo.PCMData.GetView().GetData() + (CurrentNumOfFrames * NumChannels * sizeof(float));
-	const int32 RetrievedPCMDataSize = NumSamples * sizeof(float);
+	const uint32 FadeStartFrame{SegmentEndFrame - NumOfFadeFrames};
+	const uint32 FirstFadedFrame{FMath::Max(StartFrame, FadeStartFrame)};
+	const uint32 EndFrame{StartFrame + NumOfFrames};
 
-	// Ensure we got a valid PCM data
-	if (RetrievedPCMDataSize <= 0 || RetrievedPCMData == nullptr)
+	if (FirstFadedFrame >= EndFrame)
 	{
-		return 0;
+		return;
+	}
+
+	// The loop fades into the same material, so the gains sum up to one. The queued sound waves are uncorrelated, so their power sums up to one instead
+	const bool bEqualPower{!bLooping};
+
+	const int32 NumOfFadedFrames{static_cast<int32>(EndFrame - FirstFadedFrame)};
+	const uint32 FirstFadeIndex{FirstFadedFrame - FadeStartFrame};
+	const int32 FirstFadedFrameOffset{static_cast<int32>(FirstFadedFrame - StartFrame)};
+
+	if (PCMBufferInfo.StorageFormat == EPCMStorageFormat::Int16)
+	{
+		CrossfadePCMData(reinterpret_cast<int16*>(PCMData) + FirstFadedFrameOffset * NumChannels, reinterpret_cast<const int16*>(TargetPCMData), NumOfFadedFrames, NumChannels, FirstFadeIndex, NumOfFadeFrames, NumOfAvailableTargetFrames, bEqualPower);
+	}
+	else
+	{
+		CrossfadePCMData(reinterpret_cast<float*>(PCMData) + FirstFadedFrameOffset * NumChannels, reinterpret_cast<const float*>(TargetPCMData), NumOfFadedFrames, NumChannels, FirstFadeIndex, NumOfFadeFrames, NumOfAvailableTargetFrames, bEqualPower);
+	}
+}
+
+void UImportedSoundWave::FadeInSeek(uint8* PCMData, int32 NumOfFrames, const uint8* PreviousPCMData, uint32 NumOfPreviousFrames) const
+{
+	const int32 NumOfFadeFrames{FMath::Min(FMath::Max(FMath::RoundToInt(SeekFadeDuration * GetSampleRate()), 1), NumOfFrames)};
+	const uint32 NumOfAvailablePreviousFrames{PreviousPCMData != nullptr ? FMath::Min<uint32>(NumOfPreviousFrames, NumOfFadeFrames) : 0};
+
+	// The positions before and after the seek are uncorrelated, so their power sums up to one
+	if (PCMBufferInfo.StorageFormat == EPCMStorageFormat::Int16)
+	{
+		CrossfadePCMData(reinterpret_cast<int16*>(PCMData), reinterpret_cast<const int16*>(PreviousPCMData), NumOfFadeFrames, NumChannels, 0, NumOfFadeFrames, NumOfAvailablePreviousFrames, true, true);
+	}
+	else
+	{
+		CrossfadePCMData(reinterpret_cast<float*>(PCMData), reinterpret_cast<const float*>(PreviousPCMData), NumOfFadeFrames, NumChannels, 0, NumOfFadeFrames, NumOfAvailablePreviousFrames, true, true);
+	}
+}
+
+uint32 UImportedSoundWave::GetAvailableEndFrame(uint32 StartFrame, uint32 SegmentEndFrame) const
+{
+	uint32 EndFrame{*PlayingNumOfDecodedFrames};
+
+	// The prefetched frames belong to the own PCM data of the sound wave, not to the queued sound waves
+	if (StartFrame >= EndFrame && PlayingNumOfDecodedFrames == &NumOfDecodedFrames && StartFrame >= PrefetchedStartFrame && StartFrame < PrefetchedEndFrame)
+	{
+		EndFrame = PrefetchedEndFrame;
+	}
+
+	return FMath::Min(EndFrame, SegmentEndFrame);
+}
+
+uint32 UImportedSoundWave::GetNumOfCrossfadeFrames(const FQueuedPCMSource& QueuedSource) const
+{
+	return FMath::Min3(NumOfCrossfadeFrames, PCMBufferInfo.PCMNumOfFrames, QueuedSource.PCMBufferInfo.PCMNumOfFrames);
+}
+
+void UImportedSoundWave::QueuePCMDataBlock(const uint8* PCMData, int32 NumOfSamples)
+{
+	// Generation requests are serialized by the data guard, so there is a single producer at a time
+	const uint32 NumOfQueuedBlocks{NumOfQueuedPCMDataBlocks};
+
+	// The game thread has not caught up with the queued blocks yet
+	if (NumOfQueuedBlocks - NumOfBroadcastPCMDataBlocks >= PendingPCMDataBlocksCapacity)
+	{
+		return;
+	}
+
+	TSharedPtr<FImportedPCMDataBlock, ESPMode::ThreadSafe>* FreePCMDataBlock{nullptr};
+	for (TSharedPtr<FImportedPCMDataBlock, ESPMode::ThreadSafe>& PCMDataBlock : PCMDataBlockPool)
+	{
+		if (PCMDataBlock.IsValid() && PCMDataBlock.GetSharedReferenceCount() == 1)
+		{
+			FreePCMDataBlock = &PCMDataBlock;
+			break;
+		}
+	}
+
+	// All blocks are queued or held by the listeners
+	if (FreePCMDataBlock == nullptr)
+	{
+		return;
+	}
+
+	// The listeners always receive 32-bit float data. The block keeps its capacity, so it is only reallocated while warming up
+	TArray<float>& BlockPCMData{(*FreePCMDataBlock)->PCMData};
+	BlockPCMData.SetNumUninitialized(NumOfSamples, false);
+
+	if (PCMBufferInfo.StorageFormat == EPCMStorageFormat::Int16)
+	{
+		RAWTranscoder::ConvertInt16ToFloat(reinterpret_cast<const int16*>(PCMData), BlockPCMData.GetData(), NumOfSamples);
+	}
+	else
+	{
+		FMemory::Memcpy(BlockPCMData.GetData(), PCMData, NumOfSamples * sizeof(float));
 	}
 
-	// Filling in OutAudio array with the retrieved PCM data
-	OutAudio = TArray<uint8>(RetrievedPCMData, RetrievedPCMDataSize);
+	PendingPCMDataBlocks[NumOfQueuedBlocks % PendingPCMDataBlocksCapacity] = *FreePCMDataBlock;
+	NumOfQueuedPCMDataBlocks = NumOfQueuedBlocks + 1;
+}
+
+bool UImportedSoundWave::BroadcastPendingPlaybackEvents(float DeltaTime)
+{
+	// The queued sound waves the playback has switched to are removed from the queue, along with the PCM data played before them
+	TArray<UImportedSoundWave*> StartedSoundWaves;
+	TArray<FQueuedPCMSource> PlayedSources;
+
+	if (bQueuedSoundWaveStartedPending.Exchange(false))
+	{
+		FScopeLock Lock(&DataGuard);
+
+		if (NumOfStartedQueuedPCMSources > 0)
+		{
+			StartedSoundWaves.Append(QueuedSoundWaves.GetData(), NumOfStartedQueuedPCMSources);
+			PlayingQueuedSoundWave = StartedSoundWaves.Last();
+
+			for (int32 SourceIndex = 0; SourceIndex < NumOfStartedQueuedPCMSources; ++SourceIndex)
+			{
+				PlayedSources.Add(MoveTemp(QueuedPCMSources[SourceIndex]));
+			}
+
+			QueuedSoundWaves.RemoveAt(0, NumOfStartedQueuedPCMSources);
+			QueuedPCMSources.RemoveAt(0, NumOfStartedQueuedPCMSources);
+			NumOfStartedQueuedPCMSources = 0;
+		}
+	}
 
-	// Increasing CurrentFrameCount for correct iteration sequence
-	CurrentNumOfFrames = CurrentNumOfFrames + (NumSamples / NumChannels);
+	for (UImportedSoundWave* StartedSoundWave : StartedSoundWaves)
+	{
+		if (OnQueuedSoundWaveStartedNative.IsBound())
+		{
+			OnQueuedSoundWaveStartedNative.Broadcast(StartedSoundWave);
+		}
 
-	AsyncTask(ENamedThreads::GameThread, [this, RetrievedPCMData, RetrievedPCMDataSize = NumSamples]()
+		if (OnQueuedSoundWaveStarted.IsBound())
+		{
+			OnQueuedSoundWaveStarted.Broadcast(StartedSoundWave);
+		}
+	}
+
+	const uint32 NumOfQueuedBlocks{NumOfQueuedPCMDataBlocks};
+
+	for (uint32 BlockIndex = NumOfBroadcastPCMDataBlocks; BlockIndex != NumOfQueuedBlocks; ++BlockIndex)
 	{
+		const TSharedPtr<FImportedPCMDataBlock, ESPMode::ThreadSafe> PCMDataBlock{MoveTemp(PendingPCMDataBlocks[BlockIndex % PendingPCMDataBlocksCapacity])};
+		NumOfBroadcastPCMDataBlocks = BlockIndex + 1;
+
 		if (OnGeneratePCMDataNative.IsBound())
 		{
-			OnGeneratePCMDataNative.Broadcast(TArray<float>(reinterpret_cast<float*>(RetrievedPCMData), RetrievedPCMDataSize));
+			OnGeneratePCMDataNative.Broadcast(PCMDataBlock->PCMData);
 		}
-		
+
 		if (OnGeneratePCMData.IsBound())
 		{
-			OnGeneratePCMData.Broadcast(TArray<float>(reinterpret_cast<float*>(RetrievedPCMData), RetrievedPCMDataSize));
+			OnGeneratePCMData.Broadcast(PCMDataBlock->PCMData);
 		}
-	});
 
-	return NumSamples;
+		if (OnGeneratePCMDataBlockNative.IsBound())
+		{
+			OnGeneratePCMDataBlockNative.Broadcast(PCMDataBlock.ToSharedRef());
+		}
+	}
+
+	if (bPlaybackFinishedPending.Exchange(false) && !PlaybackFinishedBroadcast)
+	{
+		UE_LOG(LogRuntimeAudioImporter, Warning, TEXT("Playback of the sound wave '%s' has been completed"), *GetName());
+
+		PlaybackFinishedBroadcast = true;
+
+		if (OnAudioPlaybackFinishedNative.IsBound())
+		{
+			OnAudioPlaybackFinishedNative.Broadcast();
+		}
+
+		if (OnAudioPlaybackFinished.IsBound())
+		{
+			OnAudioPlaybackFinished.Broadcast();
+		}
+	}
+
+	return true;
+}
+
+int64 UImportedSoundWave::GetNumOfRenderAllocations()
+{
+	return FAudioRenderAllocationScope::GetNumOfAllocations();
 }
 
 Audio::EAudioMixerStreamDataFormat::Type UImportedSoundWave::GetGeneratedPCMDataFormat() const
 {
-	return Audio::EAudioMixerStreamDataFormat::Type::Float;
+	return PCMBufferInfo.StorageFormat == EPCMStorageFormat::Int16 ? Audio::EAudioMixerStreamDataFormat::Type::Int16 : Audio::EAudioMixerStreamDataFormat::Type::Float;
 }
\ No newline at end of file
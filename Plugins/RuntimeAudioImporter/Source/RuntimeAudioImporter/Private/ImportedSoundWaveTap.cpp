@@ -0,0 +1,144 @@
+// Georgy Treshchev 2022.
+
+#include "ImportedSoundWaveTap.h"
+#include "Transcoders/RAWTranscoder.h"
+
+#include "HAL/PlatformMisc.h"
+
+FImportedSoundWaveTap::FImportedSoundWaveTap(int32 InNumOfFrames, int32 InNumOfChannels)
+	: NumOfFrames{FMath::Max(InNumOfFrames, 1)}
+  , NumOfChannels{FMath::Max(InNumOfChannels, 1)}
+{
+	PCMData.SetNumZeroed(NumOfFrames * NumOfChannels);
+}
+
+void FImportedSoundWaveTap::Write(const uint8* InPCMData, EPCMStorageFormat StorageFormat, int32 InNumOfFrames)
+{
+	if (InPCMData == nullptr || InNumOfFrames <= 0)
+	{
+		return;
+	}
+
+	const int32 FrameSize{NumOfChannels * (StorageFormat == EPCMStorageFormat::Int16 ? static_cast<int32>(sizeof(int16)) : static_cast<int32>(sizeof(float)))};
+
+	// Only the most recent frames fit into the ring buffer, so the older ones are skipped as if they had been overwritten
+	const int32 NumOfSkippedFrames{FMath::Max(InNumOfFrames - NumOfFrames, 0)};
+	const int32 NumOfFramesToWrite{InNumOfFrames - NumOfSkippedFrames};
+	InPCMData += NumOfSkippedFrames * FrameSize;
+
+	const uint64 StartPosition{WritePosition.Load() + NumOfSkippedFrames};
+	const uint64 EndPosition{StartPosition + NumOfFramesToWrite};
+
+	// The consumers must see the frames being overwritten before the new data
+	WriteEndPosition = EndPosition;
+	FPlatformMisc::MemoryBarrier();
+
+	for (int32 NumOfWrittenFrames = 0; NumOfWrittenFrames < NumOfFramesToWrite;)
+	{
+		const int32 RingFrameIndex{static_cast<int32>((StartPosition + NumOfWrittenFrames) % NumOfFrames)};
+		const int32 NumOfSegmentFrames{FMath::Min(NumOfFramesToWrite - NumOfWrittenFrames, NumOfFrames - RingFrameIndex)};
+
+		const uint8* SegmentPCMData{InPCMData + NumOfWrittenFrames * FrameSize};
+		float* RingPCMData{PCMData.GetData() + RingFrameIndex * NumOfChannels};
+
+		if (StorageFormat == EPCMStorageFormat::Int16)
+		{
+			RAWTranscoder::ConvertInt16ToFloat(reinterpret_cast<const int16*>(SegmentPCMData), RingPCMData, NumOfSegmentFrames * NumOfChannels);
+		}
+		else
+		{
+			FMemory::Memcpy(RingPCMData, SegmentPCMData, NumOfSegmentFrames * FrameSize);
+		}
+
+		NumOfWrittenFrames += NumOfSegmentFrames;
+	}
+
+	WritePosition = EndPosition;
+}
+
+uint64 FImportedSoundWaveTap::Read(uint64 StartFrame, float* OutPCMData, int32 InNumOfFrames) const
+{
+	for (int32 NumOfReadFrames = 0; NumOfReadFrames < InNumOfFrames;)
+	{
+		const int32 RingFrameIndex{static_cast<int32>((StartFrame + NumOfReadFrames) % NumOfFrames)};
+		const int32 NumOfSegmentFrames{FMath::Min(InNumOfFrames - NumOfReadFrames, NumOfFrames - RingFrameIndex)};
+
+		FMemory::Memcpy(OutPCMData + NumOfReadFrames * NumOfChannels, PCMData.GetData() + RingFrameIndex * NumOfChannels, NumOfSegmentFrames * NumOfChannels * sizeof(float));
+
+		NumOfReadFrames += NumOfSegmentFrames;
+	}
+
+	// The copy must be complete before checking whether the producer has started overwriting it
+	FPlatformMisc::MemoryBarrier();
+
+	const uint64 OverwrittenEndPosition{WriteEndPosition.Load()};
+	const uint64 FirstIntactFrame{OverwrittenEndPosition > static_cast<uint64>(NumOfFrames) ? OverwrittenEndPosition - NumOfFrames : 0};
+
+	return FMath::Max(StartFrame, FirstIntactFrame);
+}
+
+FImportedSoundWaveTapReader::FImportedSoundWaveTapReader(const TSharedRef<const FImportedSoundWaveTap, ESPMode::ThreadSafe>& InTap)
+	: Tap{InTap}
+  , ReadPosition{InTap->GetWritePosition()}
+{
+}
+
+int32 FImportedSoundWaveTapReader::ReadNew(TArray<float>& OutPCMData, int32 MaxNumOfFrames)
+{
+	const uint64 WritePosition{Tap->GetWritePosition()};
+	const uint64 OldestFrame{WritePosition > static_cast<uint64>(Tap->GetNumOfFrames()) ? WritePosition - Tap->GetNumOfFrames() : 0};
+
+	// The producer has lapped the reader
+	if (ReadPosition < OldestFrame)
+	{
+		++NumOfOverruns;
+		NumOfDroppedFrames += OldestFrame - ReadPosition;
+		ReadPosition = OldestFrame;
+	}
+
+	const int32 NumOfFramesToRead{static_cast<int32>(FMath::Min<uint64>(WritePosition - ReadPosition, FMath::Max(MaxNumOfFrames, 0)))};
+	const uint64 FirstIntactFrame{CopyFrames(ReadPosition, NumOfFramesToRead, OutPCMData)};
+
+	// The producer has overwritten some of the frames while they were being copied
+	if (FirstIntactFrame > ReadPosition)
+	{
+		++NumOfOverruns;
+		NumOfDroppedFrames += FirstIntactFrame - ReadPosition;
+	}
+
+	ReadPosition += NumOfFramesToRead;
+
+	return OutPCMData.Num() / Tap->GetNumOfChannels();
+}
+
+int32 FImportedSoundWaveTapReader::ReadLatest(TArray<float>& OutPCMData, int32 NumOfFrames) const
+{
+	const uint64 WritePosition{Tap->GetWritePosition()};
+	const int32 NumOfFramesToRead{static_cast<int32>(FMath::Min<uint64>(WritePosition, FMath::Min(Tap->GetNumOfFrames(), FMath::Max(NumOfFrames, 0))))};
+
+	CopyFrames(WritePosition - NumOfFramesToRead, NumOfFramesToRead, OutPCMData);
+
+	return OutPCMData.Num() / Tap->GetNumOfChannels();
+}
+
+uint64 FImportedSoundWaveTapReader::CopyFrames(uint64 StartFrame, int32 NumOfFramesToCopy, TArray<float>& OutPCMData) const
+{
+	const int32 NumOfChannels{Tap->GetNumOfChannels()};
+
+	OutPCMData.SetNumUninitialized(NumOfFramesToCopy * NumOfChannels, false);
+
+	if (NumOfFramesToCopy <= 0)
+	{
+		return StartFrame;
+	}
+
+	const uint64 FirstIntactFrame{FMath::Min<uint64>(Tap->Read(StartFrame, OutPCMData.GetData(), NumOfFramesToCopy), StartFrame + NumOfFramesToCopy)};
+
+	// Only the intact frames are kept
+	if (FirstIntactFrame > StartFrame)
+	{
+		OutPCMData.RemoveAt(0, static_cast<int32>(FirstIntactFrame - StartFrame) * NumOfChannels, false);
+	}
+
+	return FirstIntactFrame;
+}
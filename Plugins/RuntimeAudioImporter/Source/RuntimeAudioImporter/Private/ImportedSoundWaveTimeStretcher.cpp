@@ -0,0 +1,324 @@
+// Georgy Treshchev 2022.
+
+#include "ImportedSoundWaveTimeStretcher.h"
+#include "Transcoders/RAWTranscoder.h"
+
+#include "Math/VectorRegister.h"
+
+namespace
+{
+	/** Duration of each hop of the output, in seconds. Long enough to contain a period of the bass, short enough not to smear the transients */
+	constexpr float HopDuration{0.01f};
+
+	/** Maximum distance of the stretched segment from its nominal position, in seconds */
+	constexpr float SearchDuration{0.005f};
+
+	/** The segment is first searched for at this step, in frames, and then refined around the best candidate */
+	constexpr int32 CoarseSearchStep{4};
+
+	/**
+	 * Compute the dot product of the samples. Vectorized on the platforms supporting vector intrinsics
+	 */
+	FORCEINLINE float DotProduct(const float* Samples, const float* OtherSamples, int32 NumOfSamples)
+	{
+		VectorRegister4Float Sum{VectorZeroFloat()};
+
+		int32 SampleIndex = 0;
+		for (; SampleIndex + 4 <= NumOfSamples; SampleIndex += 4)
+		{
+			Sum = VectorMultiplyAdd(VectorLoad(Samples + SampleIndex), VectorLoad(OtherSamples + SampleIndex), Sum);
+		}
+
+		alignas(16) float Lanes[4];
+		VectorStoreAligned(Sum, Lanes);
+
+		float Result{Lanes[0] + Lanes[1] + Lanes[2] + Lanes[3]};
+
+		for (; SampleIndex < NumOfSamples; ++SampleIndex)
+		{
+			Result += Samples[SampleIndex] * OtherSamples[SampleIndex];
+		}
+
+		return Result;
+	}
+
+	/**
+	 * Downmix the interleaved frames to mono. The channels are summed up, as only the shape of the waveform matters
+	 */
+	FORCEINLINE void DownmixToMono(const float* PCMData, float* MonoPCMData, int32 NumOfFrames, int32 NumOfChannels)
+	{
+		for (int32 FrameIndex = 0; FrameIndex < NumOfFrames; ++FrameIndex)
+		{
+			float Sample{0};
+
+			for (int32 ChannelIndex = 0; ChannelIndex < NumOfChannels; ++ChannelIndex)
+			{
+				Sample += PCMData[FrameIndex * NumOfChannels + ChannelIndex];
+			}
+
+			MonoPCMData[FrameIndex] = Sample;
+		}
+	}
+}
+
+FImportedSoundWaveTimeStretcher::FImportedSoundWaveTimeStretcher(int32 InSampleRate, int32 InNumOfChannels)
+	: SampleRate{FMath::Max(InSampleRate, 1)}
+  , NumOfChannels{FMath::Max(InNumOfChannels, 1)}
+  , NumOfHopFrames{FMath::Max(FMath::RoundToInt(HopDuration * SampleRate), 16)}
+  , MaxSearchRadius{FMath::Max(FMath::RoundToInt(SearchDuration * SampleRate), CoarseSearchStep)}
+{
+	const int32 MaxNumOfWindowFrames{2 * MaxSearchRadius + 2 * NumOfHopFrames};
+
+	HopPCMData.SetNumZeroed((NumOfHopFrames + 1) * NumOfChannels);
+	OverlapPCMData.SetNumZeroed(NumOfHopFrames * NumOfChannels);
+	RenderedPCMData.SetNumZeroed(NumOfHopFrames * NumOfChannels);
+	WindowPCMData.SetNumZeroed(MaxNumOfWindowFrames * NumOfChannels);
+	WindowMonoPCMData.SetNumZeroed(MaxNumOfWindowFrames);
+	OverlapMonoPCMData.SetNumZeroed(NumOfHopFrames);
+	WindowEnergy.SetNumZeroed(MaxNumOfWindowFrames + 1);
+
+	// The segments are aligned by the search, so a raised cosine keeps their sum at a constant amplitude
+	FadeInGains.SetNumUninitialized(NumOfHopFrames);
+	for (int32 FrameIndex = 0; FrameIndex < NumOfHopFrames; ++FrameIndex)
+	{
+		FadeInGains[FrameIndex] = 0.5f - 0.5f * FMath::Cos(PI * (FrameIndex + 0.5f) / NumOfHopFrames);
+	}
+
+	Reset();
+}
+
+void FImportedSoundWaveTimeStretcher::SetTempo(float InTempo)
+{
+	Tempo = FMath::Clamp(InTempo, MinTempo, MaxTempo);
+}
+
+void FImportedSoundWaveTimeStretcher::SetPitchShift(float InPitchShift)
+{
+	PitchShift = FMath::Clamp(InPitchShift, MinPitchShift, MaxPitchShift);
+}
+
+void FImportedSoundWaveTimeStretcher::SetSourcePosition(uint32 Frame)
+{
+	SourcePosition = Frame;
+}
+
+void FImportedSoundWaveTimeStretcher::Reset(uint32 Frame)
+{
+	SourcePosition = Frame;
+	bHasOverlap = false;
+
+	// The first output frame is the first frame of the next hop, rather than the interpolation from the silence before it
+	FMemory::Memzero(HopPCMData.GetData(), HopPCMData.Num() * sizeof(float));
+	HopReadPosition = NumOfHopFrames + 1;
+}
+
+int32 FImportedSoundWaveTimeStretcher::Render(const uint8* SourcePCMData, EPCMStorageFormat StorageFormat, uint32 SourceEndFrame, bool bSourceEnds, uint8* OutPCMData, int32 NumOfFrames)
+{
+	if (SourcePCMData == nullptr || OutPCMData == nullptr)
+	{
+		return 0;
+	}
+
+	if (StorageFormat != EPCMStorageFormat::Int16)
+	{
+		return RenderFrames(SourcePCMData, StorageFormat, SourceEndFrame, bSourceEnds, reinterpret_cast<float*>(OutPCMData), NumOfFrames);
+	}
+
+	// The frames are rendered in 32-bit float a hop at a time and converted the same way as the rest of the imported PCM data
+	int16* OutInt16PCMData{reinterpret_cast<int16*>(OutPCMData)};
+	int32 NumOfRenderedFrames{0};
+
+	while (NumOfRenderedFrames < NumOfFrames)
+	{
+		const int32 NumOfFramesToRender{FMath::Min(NumOfFrames - NumOfRenderedFrames, NumOfHopFrames)};
+		const int32 NumOfRenderedHopFrames{RenderFrames(SourcePCMData, StorageFormat, SourceEndFrame, bSourceEnds, RenderedPCMData.GetData(), NumOfFramesToRender)};
+
+		RAWTranscoder::ConvertFloatToInt16(RenderedPCMData.GetData(), OutInt16PCMData + NumOfRenderedFrames * NumOfChannels, static_cast<int64>(NumOfRenderedHopFrames) * NumOfChannels);
+		NumOfRenderedFrames += NumOfRenderedHopFrames;
+
+		if (NumOfRenderedHopFrames < NumOfFramesToRender)
+		{
+			break;
+		}
+	}
+
+	return NumOfRenderedFrames;
+}
+
+int32 FImportedSoundWaveTimeStretcher::RenderFrames(const uint8* SourcePCMData, EPCMStorageFormat StorageFormat, uint32 SourceEndFrame, bool bSourceEnds, float* OutPCMData, int32 NumOfFrames)
+{
+	int32 NumOfRenderedFrames{0};
+
+	while (NumOfRenderedFrames < NumOfFrames)
+	{
+		// The interpolation needs the frame after the last one of the hop
+		if (HopReadPosition >= NumOfHopFrames)
+		{
+			if (!StretchHop(SourcePCMData, StorageFormat, SourceEndFrame, bSourceEnds))
+			{
+				break;
+			}
+
+			HopReadPosition -= NumOfHopFrames;
+		}
+
+		const int32 HopFrameIndex{static_cast<int32>(HopReadPosition)};
+		const float Fraction{static_cast<float>(HopReadPosition - HopFrameIndex)};
+
+		const float* Frame{HopPCMData.GetData() + HopFrameIndex * NumOfChannels};
+		const float* NextFrame{Frame + NumOfChannels};
+		float* OutFrame{OutPCMData + NumOfRenderedFrames * NumOfChannels};
+
+		for (int32 ChannelIndex = 0; ChannelIndex < NumOfChannels; ++ChannelIndex)
+		{
+			OutFrame[ChannelIndex] = Frame[ChannelIndex] + (NextFrame[ChannelIndex] - Frame[ChannelIndex]) * Fraction;
+		}
+
+		HopReadPosition += PitchShift;
+		++NumOfRenderedFrames;
+	}
+
+	return NumOfRenderedFrames;
+}
+
+bool FImportedSoundWaveTimeStretcher::StretchHop(const uint8* SourcePCMData, EPCMStorageFormat StorageFormat, uint32 SourceEndFrame, bool bSourceEnds)
+{
+	const int64 NominalFrame{static_cast<int64>(SourcePosition)};
+
+	if (bSourceEnds && NominalFrame >= SourceEndFrame)
+	{
+		return false;
+	}
+
+	// Each candidate segment consists of the hop crossfaded into and the continuation crossfaded from at the next hop
+	const int32 SearchRadius{bHasOverlap ? MaxSearchRadius : 0};
+	const int64 WindowStartFrame{NominalFrame - SearchRadius};
+	const int32 NumOfWindowFrames{2 * SearchRadius + 2 * NumOfHopFrames};
+
+	if (!bSourceEnds && WindowStartFrame + NumOfWindowFrames > SourceEndFrame)
+	{
+		return false;
+	}
+
+	ReadSourceFrames(SourcePCMData, StorageFormat, WindowStartFrame, NumOfWindowFrames, SourceEndFrame);
+
+	const int32 SegmentStartFrame{SearchRadius + (bHasOverlap ? FindSimilarSegmentOffset(SearchRadius) : 0)};
+	const float* SegmentPCMData{WindowPCMData.GetData() + SegmentStartFrame * NumOfChannels};
+
+	// The last frame of the previous hop is kept for the interpolation across the hops
+	float* HopFramesPCMData{HopPCMData.GetData() + NumOfChannels};
+	FMemory::Memcpy(HopPCMData.GetData(), HopPCMData.GetData() + NumOfHopFrames * NumOfChannels, NumOfChannels * sizeof(float));
+
+	if (bHasOverlap)
+	{
+		for (int32 FrameIndex = 0; FrameIndex < NumOfHopFrames; ++FrameIndex)
+		{
+			const float Gain{FadeInGains[FrameIndex]};
+
+			for (int32 ChannelIndex = 0; ChannelIndex < NumOfChannels; ++ChannelIndex)
+			{
+				const int32 SampleIndex{FrameIndex * NumOfChannels + ChannelIndex};
+				HopFramesPCMData[SampleIndex] = OverlapPCMData[SampleIndex] + (SegmentPCMData[SampleIndex] - OverlapPCMData[SampleIndex]) * Gain;
+			}
+		}
+	}
+	else
+	{
+		FMemory::Memcpy(HopFramesPCMData, SegmentPCMData, NumOfHopFrames * NumOfChannels * sizeof(float));
+	}
+
+	FMemory::Memcpy(OverlapPCMData.GetData(), SegmentPCMData + NumOfHopFrames * NumOfChannels, NumOfHopFrames * NumOfChannels * sizeof(float));
+	bHasOverlap = true;
+
+	// The stretched output is played faster by the pitch shift, so the source advances slower to keep the tempo
+	SourcePosition += NumOfHopFrames * static_cast<double>(Tempo) / PitchShift;
+
+	return true;
+}
+
+void FImportedSoundWaveTimeStretcher::ReadSourceFrames(const uint8* SourcePCMData, EPCMStorageFormat StorageFormat, int64 StartFrame, int32 NumOfFramesToRead, uint32 SourceEndFrame)
+{
+	const int64 FirstSourceFrame{FMath::Clamp<int64>(StartFrame, 0, SourceEndFrame)};
+	const int64 EndSourceFrame{FMath::Clamp<int64>(StartFrame + NumOfFramesToRead, 0, SourceEndFrame)};
+
+	const int32 NumOfLeadingFrames{static_cast<int32>(FMath::Clamp<int64>(FirstSourceFrame - StartFrame, 0, NumOfFramesToRead))};
+	const int32 NumOfSourceFrames{static_cast<int32>(FMath::Max<int64>(EndSourceFrame - FirstSourceFrame, 0))};
+	const int32 NumOfTrailingFrames{NumOfFramesToRead - NumOfLeadingFrames - NumOfSourceFrames};
+
+	float* PCMData{WindowPCMData.GetData()};
+
+	FMemory::Memzero(PCMData, NumOfLeadingFrames * NumOfChannels * sizeof(float));
+	PCMData += NumOfLeadingFrames * NumOfChannels;
+
+	if (StorageFormat == EPCMStorageFormat::Int16)
+	{
+		RAWTranscoder::ConvertInt16ToFloat(reinterpret_cast<const int16*>(SourcePCMData) + FirstSourceFrame * NumOfChannels, PCMData, static_cast<int64>(NumOfSourceFrames) * NumOfChannels);
+	}
+	else
+	{
+		FMemory::Memcpy(PCMData, reinterpret_cast<const float*>(SourcePCMData) + FirstSourceFrame * NumOfChannels, NumOfSourceFrames * NumOfChannels * sizeof(float));
+	}
+	PCMData += NumOfSourceFrames * NumOfChannels;
+
+	FMemory::Memzero(PCMData, NumOfTrailingFrames * NumOfChannels * sizeof(float));
+}
+
+int32 FImportedSoundWaveTimeStretcher::FindSimilarSegmentOffset(int32 SearchRadius)
+{
+	const int32 NumOfWindowFrames{2 * SearchRadius + 2 * NumOfHopFrames};
+
+	DownmixToMono(WindowPCMData.GetData(), WindowMonoPCMData.GetData(), NumOfWindowFrames, NumOfChannels);
+	DownmixToMono(OverlapPCMData.GetData(), OverlapMonoPCMData.GetData(), NumOfHopFrames, NumOfChannels);
+
+	WindowEnergy[0] = 0;
+	for (int32 FrameIndex = 0; FrameIndex < NumOfWindowFrames; ++FrameIndex)
+	{
+		WindowEnergy[FrameIndex + 1] = WindowEnergy[FrameIndex] + FMath::Square(WindowMonoPCMData[FrameIndex]);
+	}
+
+	// The squared normalized cross-correlation with the sign kept, which avoids the square root
+	auto GetSimilarity = [this](int32 SegmentStartFrame)
+	{
+		const float Correlation{DotProduct(OverlapMonoPCMData.GetData(), WindowMonoPCMData.GetData() + SegmentStartFrame, NumOfHopFrames)};
+		const float Energy{WindowEnergy[SegmentStartFrame + NumOfHopFrames] - WindowEnergy[SegmentStartFrame]};
+
+		return Correlation * FMath::Abs(Correlation) / (FMath::Max(Energy, 0.f) + SMALL_NUMBER);
+	};
+
+	const int32 MaxSegmentStartFrame{2 * SearchRadius};
+
+	// The nominal position is preferred on ties, as it does not shift the timing
+	int32 BestSegmentStartFrame{SearchRadius};
+	float BestSimilarity{GetSimilarity(SearchRadius)};
+
+	for (int32 SegmentStartFrame = 0; SegmentStartFrame <= MaxSegmentStartFrame; SegmentStartFrame += CoarseSearchStep)
+	{
+		const float Similarity{GetSimilarity(SegmentStartFrame)};
+		if (Similarity > BestSimilarity)
+		{
+			BestSimilarity = Similarity;
+			BestSegmentStartFrame = SegmentStartFrame;
+		}
+	}
+
+	const int32 CoarseSegmentStartFrame{BestSegmentStartFrame};
+	const int32 FirstRefinedFrame{FMath::Max(CoarseSegmentStartFrame - CoarseSearchStep + 1, 0)};
+	const int32 LastRefinedFrame{FMath::Min(CoarseSegmentStartFrame + CoarseSearchStep - 1, MaxSegmentStartFrame)};
+
+	for (int32 SegmentStartFrame = FirstRefinedFrame; SegmentStartFrame <= LastRefinedFrame; ++SegmentStartFrame)
+	{
+		if (SegmentStartFrame == CoarseSegmentStartFrame)
+		{
+			continue;
+		}
+
+		const float Similarity{GetSimilarity(SegmentStartFrame)};
+		if (Similarity > BestSimilarity)
+		{
+			BestSimilarity = Similarity;
+			BestSegmentStartFrame = SegmentStartFrame;
+		}
+	}
+
+	return BestSegmentStartFrame - SearchRadius;
+}
@@ -102,8 +102,8 @@ FAudioThumbnail::FAudioThumbnail(const FLinearColor& BaseColor, const UImportedS
 
 	if(SoundWave)
 	{
-		const float* TempLookupData = reinterpret_cast<float*>(SoundWave->PCMBufferInfo.PCMData.GetView().GetData());
-		LookupSize = SoundWave->PCMBufferInfo.PCMData.GetView().Num() * sizeof(uint8) / sizeof(float);
+		const uint8* TempLookupData = SoundWave->PCMBufferInfo.PCMData.GetView().GetData();
+		LookupSize = SoundWave->PCMBufferInfo.PCMData.GetView().Num() / SoundWave->PCMBufferInfo.GetSampleSize();
 
 		if (!TempLookupData)
 		{
@@ -112,9 +112,17 @@ FAudioThumbnail::FAudioThumbnail(const FLinearColor& BaseColor, const UImportedS
 		
 		LookupDataArray.Reserve(LookupSize);
 
-		for(int32 i = 0; i < LookupSize; ++i)
+		// Signed 16-bit data is already in the lookup range
+		if (SoundWave->PCMBufferInfo.StorageFormat == EPCMStorageFormat::Int16)
 		{
-			LookupDataArray.Add(FMath::CeilToInt(TempLookupData[i] * TNumericLimits<int16>::Max()));
+			LookupDataArray.Append(reinterpret_cast<const int16*>(TempLookupData), LookupSize);
+		}
+		else
+		{
+			for(int32 i = 0; i < LookupSize; ++i)
+			{
+				LookupDataArray.Add(FMath::CeilToInt(reinterpret_cast<const float*>(TempLookupData)[i] * TNumericLimits<int16>::Max()));
+			}
 		}
 	}
 	else
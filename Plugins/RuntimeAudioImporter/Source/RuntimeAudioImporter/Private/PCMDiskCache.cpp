@@ -0,0 +1,268 @@
+// Georgy Treshchev 2022.
+
+#include "PCMDiskCache.h"
+#include "RuntimeAudioImporterDefines.h"
+
+#include "Async/MappedFileHandle.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/SecureHash.h"
+
+static TAutoConsoleVariable<int32> CVarPCMDiskCache(
+	TEXT("RuntimeAudioImporter.PCMDiskCache"),
+	0,
+	TEXT("Whether to cache the decoded PCM data on disk, so that importing the same audio data again skips decoding.\n")
+	TEXT("0: Disabled\n")
+	TEXT("1: Enabled"));
+
+static TAutoConsoleVariable<int32> CVarPCMDiskCacheMaxMegabytes(
+	TEXT("RuntimeAudioImporter.PCMDiskCacheMaxMegabytes"),
+	2048,
+	TEXT("The maximum size of the decoded PCM disk cache, in megabytes. The least recently used entries are evicted when it is exceeded"));
+
+namespace
+{
+	/** Identifies the cache entries ("RAIP") */
+	constexpr uint32 CacheEntryMagic{0x50494152};
+
+	/** Version of the decoded output. Must be increased whenever the decoders change their output, so that the stale entries are no longer used */
+	constexpr uint32 DecoderVersion{1};
+
+	/** Header preceding the raw PCM data in the cache entry */
+	struct FPCMCacheHeader
+	{
+		uint32 Magic;
+		uint32 DecoderVersion;
+		uint32 NumOfChannels;
+		uint32 SampleRate;
+		uint64 NumOfFrames;
+		uint32 StorageFormat;
+		uint32 Reserved;
+	};
+
+	static_assert(sizeof(FPCMCacheHeader) == 32, "The PCM data must remain aligned after the header");
+
+	/** Guards the eviction, since the entries may be stored from several threads at once */
+	FCriticalSection EvictionGuard;
+
+	FString GetCacheDirectory()
+	{
+		return FPaths::ProjectSavedDir() / TEXT("RuntimeAudioImporter") / TEXT("PCMCache");
+	}
+
+	FString GetCacheEntryPath(const FString& CacheKey)
+	{
+		return GetCacheDirectory() / CacheKey + TEXT(".pcm");
+	}
+
+	/**
+	 * Evict the least recently used entries until the cache fits into its maximum size
+	 */
+	void EvictEntries()
+	{
+		struct FCacheEntry
+		{
+			FString FilePath;
+			int64 Size;
+			FDateTime LastUsedTime;
+		};
+
+		const int64 MaxCacheSize{static_cast<int64>(FMath::Max(CVarPCMDiskCacheMaxMegabytes.GetValueOnAnyThread(), 0)) * 1024 * 1024};
+
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+		FScopeLock Lock(&EvictionGuard);
+
+		TArray<FCacheEntry> CacheEntries;
+		int64 CacheSize{0};
+
+		// The modification time of an entry is updated each time it is loaded, so it reflects its last use
+		PlatformFile.IterateDirectoryStat(*GetCacheDirectory(), [&CacheEntries, &CacheSize](const TCHAR* FilenameOrDirectory, const FFileStatData& StatData)
+		{
+			if (!StatData.bIsDirectory && FPaths::GetExtension(FilenameOrDirectory) == TEXT("pcm"))
+			{
+				CacheEntries.Add({FilenameOrDirectory, StatData.FileSize, StatData.ModificationTime});
+				CacheSize += StatData.FileSize;
+			}
+
+			return true;
+		});
+
+		if (CacheSize <= MaxCacheSize)
+		{
+			return;
+		}
+
+		CacheEntries.Sort([](const FCacheEntry& EntryA, const FCacheEntry& EntryB)
+		{
+			return EntryA.LastUsedTime < EntryB.LastUsedTime;
+		});
+
+		for (const FCacheEntry& CacheEntry : CacheEntries)
+		{
+			if (CacheSize <= MaxCacheSize)
+			{
+				break;
+			}
+
+			// Entries mapped at the moment cannot be deleted on some platforms, in which case they are evicted later
+			if (PlatformFile.DeleteFile(*CacheEntry.FilePath))
+			{
+				CacheSize -= CacheEntry.Size;
+				UE_LOG(LogRuntimeAudioImporter, Log, TEXT("Evicted '%s' from the decoded PCM disk cache"), *CacheEntry.FilePath);
+			}
+		}
+	}
+}
+
+bool PCMDiskCache::IsEnabled()
+{
+	return CVarPCMDiskCache.GetValueOnAnyThread() > 0;
+}
+
+FString PCMDiskCache::GetCacheKey(const uint8* AudioData, int64 AudioDataSize, EPCMStorageFormat StorageFormat)
+{
+	const uint8 StorageFormatByte{static_cast<uint8>(StorageFormat)};
+
+	FSHA1 HashState;
+	HashState.Update(AudioData, AudioDataSize);
+	HashState.Update(reinterpret_cast<const uint8*>(&DecoderVersion), sizeof(DecoderVersion));
+	HashState.Update(&StorageFormatByte, sizeof(StorageFormatByte));
+	HashState.Final();
+
+	uint8 Hash[FSHA1::DigestSize];
+	HashState.GetHash(Hash);
+
+	return BytesToHex(Hash, FSHA1::DigestSize);
+}
+
+bool PCMDiskCache::Load(const FString& CacheKey, FDecodedAudioStruct& DecodedAudioInfo)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const FString FilePath{GetCacheEntryPath(CacheKey)};
+
+	if (!PlatformFile.FileExists(*FilePath))
+	{
+		return false;
+	}
+
+	FPCMCacheHeader Header;
+	{
+		TUniquePtr<IFileHandle> FileHandle{PlatformFile.OpenRead(*FilePath)};
+
+		if (!FileHandle.IsValid() || !FileHandle->Read(reinterpret_cast<uint8*>(&Header), sizeof(Header)))
+		{
+			return false;
+		}
+	}
+
+	const EPCMStorageFormat StorageFormat{DecodedAudioInfo.PCMInfo.StorageFormat};
+	const int64 SampleSize{StorageFormat == EPCMStorageFormat::Int16 ? sizeof(int16) : sizeof(float)};
+	const int64 PCMDataSize{static_cast<int64>(Header.NumOfFrames) * Header.NumOfChannels * SampleSize};
+
+	if (Header.Magic != CacheEntryMagic || Header.DecoderVersion != DecoderVersion || Header.StorageFormat != static_cast<uint32>(StorageFormat)
+		|| Header.NumOfChannels == 0 || Header.SampleRate == 0 || Header.NumOfFrames == 0 || Header.NumOfFrames > TNumericLimits<uint32>::Max()
+		|| PlatformFile.FileSize(*FilePath) != static_cast<int64>(sizeof(Header)) + PCMDataSize)
+	{
+		UE_LOG(LogRuntimeAudioImporter, Warning, TEXT("The decoded PCM disk cache entry '%s' is invalid and will be deleted"), *FilePath);
+		PlatformFile.DeleteFile(*FilePath);
+		return false;
+	}
+
+	// Mapping the PCM data instead of reading it so that it is paged in lazily while being played back
+	TUniquePtr<IMappedFileHandle> MappedFileHandle{PlatformFile.OpenMapped(*FilePath)};
+	TUniquePtr<IMappedFileRegion> MappedFileRegion{MappedFileHandle.IsValid() ? MappedFileHandle->MapRegion(sizeof(Header), PCMDataSize) : nullptr};
+
+	if (MappedFileRegion.IsValid())
+	{
+		DecodedAudioInfo.PCMInfo.PCMData = FRuntimeBulkDataBuffer<uint8>(MoveTemp(MappedFileHandle), MoveTemp(MappedFileRegion));
+	}
+	else
+	{
+		// Memory mapping is not supported by all platforms, so falling back to reading the PCM data
+		TUniquePtr<IFileHandle> FileHandle{PlatformFile.OpenRead(*FilePath)};
+		uint8* PCMData = static_cast<uint8*>(FMemory::Malloc(PCMDataSize));
+
+		if (!FileHandle.IsValid() || !FileHandle->Seek(sizeof(Header)) || !FileHandle->Read(PCMData, PCMDataSize))
+		{
+			FMemory::Free(PCMData);
+			return false;
+		}
+
+		DecodedAudioInfo.PCMInfo.PCMData = FRuntimeBulkDataBuffer<uint8>(PCMData, PCMDataSize);
+	}
+
+	DecodedAudioInfo.PCMInfo.PCMNumOfFrames = static_cast<uint32>(Header.NumOfFrames);
+
+	// Getting basic audio information
+	{
+		DecodedAudioInfo.SoundWaveBasicInfo.NumOfChannels = Header.NumOfChannels;
+		DecodedAudioInfo.SoundWaveBasicInfo.SampleRate = Header.SampleRate;
+		DecodedAudioInfo.SoundWaveBasicInfo.Duration = static_cast<float>(Header.NumOfFrames) / Header.SampleRate;
+	}
+
+	// Touching the entry so that it is evicted last
+	PlatformFile.SetTimeStamp(*FilePath, FDateTime::UtcNow());
+
+	UE_LOG(LogRuntimeAudioImporter, Log, TEXT("Loaded the decoded audio data from the PCM disk cache entry '%s'"), *FilePath);
+
+	return true;
+}
+
+void PCMDiskCache::Store(const FString& CacheKey, const FDecodedAudioStruct& DecodedAudioInfo)
+{
+	const FPCMStruct& PCMInfo{DecodedAudioInfo.PCMInfo};
+
+	if (PCMInfo.PCMNumOfFrames == 0 || PCMInfo.PCMData.GetView().Num() == 0)
+	{
+		return;
+	}
+
+	FPCMCacheHeader Header;
+	{
+		Header.Magic = CacheEntryMagic;
+		Header.DecoderVersion = DecoderVersion;
+		Header.NumOfChannels = DecodedAudioInfo.SoundWaveBasicInfo.NumOfChannels;
+		Header.SampleRate = DecodedAudioInfo.SoundWaveBasicInfo.SampleRate;
+		Header.NumOfFrames = PCMInfo.PCMNumOfFrames;
+		Header.StorageFormat = static_cast<uint32>(PCMInfo.StorageFormat);
+		Header.Reserved = 0;
+	}
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const FString FilePath{GetCacheEntryPath(CacheKey)};
+
+	// The entry is written under a temporary name and renamed afterwards, so that a partially written entry is never loaded
+	const FString TempFilePath{FString::Printf(TEXT("%s.%u.tmp"), *FilePath, FPlatformTLS::GetCurrentThreadId())};
+
+	PlatformFile.CreateDirectoryTree(*GetCacheDirectory());
+
+	bool bWritten{false};
+	{
+		TUniquePtr<IFileHandle> FileHandle{PlatformFile.OpenWrite(*TempFilePath)};
+
+		if (FileHandle.IsValid())
+		{
+			bWritten = FileHandle->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header)) && FileHandle->Write(PCMInfo.PCMData.GetView().GetData(), PCMInfo.PCMData.GetView().Num());
+		}
+	}
+
+	// Renaming fails if the same audio data has just been stored by another import, which is fine
+	if (!bWritten || !PlatformFile.MoveFile(*FilePath, *TempFilePath))
+	{
+		if (!bWritten)
+		{
+			UE_LOG(LogRuntimeAudioImporter, Warning, TEXT("Unable to write the decoded PCM disk cache entry '%s'"), *FilePath);
+		}
+
+		PlatformFile.DeleteFile(*TempFilePath);
+		return;
+	}
+
+	UE_LOG(LogRuntimeAudioImporter, Log, TEXT("Stored the decoded audio data in the PCM disk cache entry '%s'"), *FilePath);
+
+	EvictEntries();
+}
@@ -0,0 +1,46 @@
+// Georgy Treshchev 2022.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RuntimeAudioImporterTypes.h"
+
+/**
+ * On-disk cache of decoded PCM data, keyed by the hash of the encoded audio data and the decoder version.
+ * Each entry is a small header followed by the raw PCM data, which is memory-mapped when loaded
+ */
+class RUNTIMEAUDIOIMPORTER_API PCMDiskCache
+{
+public:
+	/**
+	 * Whether the decoded PCM data should be cached on disk
+	 */
+	static bool IsEnabled();
+
+	/**
+	 * Get the cache key of the encoded audio data
+	 *
+	 * @param AudioData Pointer to memory location of the encoded audio data
+	 * @param AudioDataSize Memory size allocated for the encoded audio data
+	 * @param StorageFormat The storage format of the decoded PCM data
+	 * @return The cache key
+	 */
+	static FString GetCacheKey(const uint8* AudioData, int64 AudioDataSize, EPCMStorageFormat StorageFormat);
+
+	/**
+	 * Load the decoded audio data from the cache
+	 *
+	 * @param CacheKey The cache key of the encoded audio data
+	 * @param DecodedAudioInfo Decoded audio data. The PCM data is memory-mapped if supported by the platform, and is therefore read-only
+	 * @return Whether the decoded audio data was found in the cache or not
+	 */
+	static bool Load(const FString& CacheKey, FDecodedAudioStruct& DecodedAudioInfo);
+
+	/**
+	 * Store the decoded audio data in the cache, evicting the least recently used entries exceeding the cache size
+	 *
+	 * @param CacheKey The cache key of the encoded audio data
+	 * @param DecodedAudioInfo Decoded audio data
+	 */
+	static void Store(const FString& CacheKey, const FDecodedAudioStruct& DecodedAudioInfo);
+};
@@ -1,6 +1,223 @@
 // Georgy Treshchev 2022.
 
 #include "PreImportedSoundAsset.h"
+#include "RuntimeAudioImporterDefines.h"
 
+#include "Async/Async.h"
+#include "Serialization/CustomVersion.h"
 
+#if WITH_EDITOR
+#include "RuntimeAudioImporterLibrary.h"
+#endif
 
+namespace
+{
+	/** Versions of the serialized pre-imported sound asset */
+	enum class EPreImportedSoundAssetVersion : int32
+	{
+		BeforeCustomVersionWasAdded = 0,
+
+		/** The decoded PCM data payload is serialized */
+		DecodedPCMData,
+
+		VersionPlusOne,
+		LatestVersion = VersionPlusOne - 1
+	};
+
+	const FGuid PreImportedSoundAssetVersionGUID(0x5A3C1E2B, 0x7D4F4B8A, 0x9E6C2D1F, 0x3B8A7C64);
+
+	FCustomVersionRegistration GRegisterPreImportedSoundAssetVersion(PreImportedSoundAssetVersionGUID, static_cast<int32>(EPreImportedSoundAssetVersion::LatestVersion), TEXT("PreImportedSoundAssetVer"));
+}
+
+void UPreImportedSoundAsset::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	Ar.UsingCustomVersion(PreImportedSoundAssetVersionGUID);
+
+	if (Ar.CustomVer(PreImportedSoundAssetVersionGUID) >= static_cast<int32>(EPreImportedSoundAssetVersion::DecodedPCMData))
+	{
+		DecodedPCMBulkData.Serialize(Ar, this);
+	}
+}
+
+#if WITH_EDITOR
+void UPreImportedSoundAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	const FName PropertyName{PropertyChangedEvent.GetPropertyName()};
+
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(UPreImportedSoundAsset, bStoreDecodedPCM) || PropertyName == GET_MEMBER_NAME_CHECKED(UPreImportedSoundAsset, DecodedPCMStorageFormat))
+	{
+		UpdateDecodedPCMData();
+	}
+}
+
+bool UPreImportedSoundAsset::UpdateDecodedPCMData()
+{
+	// The loaded data no longer matches the stored one
+	LoadedDecodedPCMData.Reset();
+
+	if (!bStoreDecodedPCM)
+	{
+		DecodedPCMBulkData.RemoveBulkData();
+		DecodedNumOfChannels = DecodedSampleRate = DecodedNumOfFrames = 0;
+		return true;
+	}
+
+	FEncodedAudioStruct EncodedAudioInfo(FRuntimeBulkDataBuffer<uint8>(TArray<uint8>(AudioDataArray)), AudioFormat);
+
+	FDecodedAudioStruct DecodedAudioInfo;
+	DecodedAudioInfo.PCMInfo.StorageFormat = DecodedPCMStorageFormat;
+
+	if (!URuntimeAudioImporterLibrary::DecodeAudioData(EncodedAudioInfo, DecodedAudioInfo))
+	{
+		UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Unable to decode the audio data of the pre-imported sound asset '%s' to store the decoded PCM data"), *GetName());
+
+		bStoreDecodedPCM = false;
+		DecodedPCMBulkData.RemoveBulkData();
+		DecodedNumOfChannels = DecodedSampleRate = DecodedNumOfFrames = 0;
+		return false;
+	}
+
+	const FRuntimeBulkDataBuffer<uint8>::ViewType& PCMData = DecodedAudioInfo.PCMInfo.PCMData.GetView();
+
+	DecodedPCMBulkData.Lock(LOCK_READ_WRITE);
+	FMemory::Memcpy(DecodedPCMBulkData.Realloc(PCMData.Num()), PCMData.GetData(), PCMData.Num());
+	DecodedPCMBulkData.Unlock();
+
+	// Stored outside of the export data so that it is loaded on demand, and memory-mapped where the platform supports it
+	DecodedPCMBulkData.SetBulkDataFlags(BULKDATA_Force_NOT_InlinePayload | BULKDATA_MemoryMappedPayload);
+
+	DecodedNumOfChannels = DecodedAudioInfo.SoundWaveBasicInfo.NumOfChannels;
+	DecodedSampleRate = DecodedAudioInfo.SoundWaveBasicInfo.SampleRate;
+	DecodedNumOfFrames = DecodedAudioInfo.PCMInfo.PCMNumOfFrames;
+
+	UE_LOG(LogRuntimeAudioImporter, Log, TEXT("Stored the decoded PCM data of the pre-imported sound asset '%s'. Decoded audio info: %s"), *GetName(), *DecodedAudioInfo.ToString());
+
+	return true;
+}
+#endif
+
+bool UPreImportedSoundAsset::HasDecodedPCMData() const
+{
+	return DecodedNumOfFrames > 0 && DecodedPCMBulkData.GetBulkDataSize() > 0;
+}
+
+void UPreImportedSoundAsset::LoadDecodedAudioData(TFunction<void(bool bSucceeded, FDecodedAudioStruct&& DecodedAudioInfo)> OnLoaded)
+{
+	check(IsInGameThread());
+
+	PendingLoadCallbacks.Add(MoveTemp(OnLoaded));
+
+	if (LoadedDecodedPCMData.IsValid())
+	{
+		OnDecodedPCMDataLoaded(FRuntimeBulkDataBuffer<uint8>());
+		return;
+	}
+
+	// The data is already being loaded for another caller
+	if (PendingLoadCallbacks.Num() > 1)
+	{
+		return;
+	}
+
+	if (!HasDecodedPCMData())
+	{
+		UE_LOG(LogRuntimeAudioImporter, Error, TEXT("The pre-imported sound asset '%s' has no decoded PCM data stored"), *GetName());
+		OnDecodedPCMDataLoaded(FRuntimeBulkDataBuffer<uint8>());
+		return;
+	}
+
+	// The payload has been memory-mapped on load, so it is referenced without being read or copied
+	if (DecodedPCMBulkData.IsDataMemoryMapped())
+	{
+		TUniquePtr<FOwnedBulkDataPtr> FileMapping{DecodedPCMBulkData.StealFileMapping()};
+
+		if (FileMapping.IsValid() && FileMapping->GetMappedRegion() != nullptr)
+		{
+			TUniquePtr<IMappedFileHandle> MappedFileHandle{FileMapping->GetMappedHandle()};
+			TUniquePtr<IMappedFileRegion> MappedFileRegion{FileMapping->GetMappedRegion()};
+			FileMapping->RelinquishOwnership();
+
+			OnDecodedPCMDataLoaded(FRuntimeBulkDataBuffer<uint8>(MoveTemp(MappedFileHandle), MoveTemp(MappedFileRegion)));
+			return;
+		}
+	}
+
+	// The payload is in memory if the asset has not been saved yet
+	if (DecodedPCMBulkData.IsBulkDataLoaded())
+	{
+		void* PCMData{nullptr};
+		DecodedPCMBulkData.GetCopy(&PCMData, true);
+
+		OnDecodedPCMDataLoaded(FRuntimeBulkDataBuffer<uint8>(static_cast<uint8*>(PCMData), DecodedPCMBulkData.GetBulkDataSize()));
+		return;
+	}
+
+	FBulkDataIORequestCallBack OnRequestCompleted = [WeakThis = MakeWeakObjectPtr(this)](bool bWasCancelled, IBulkDataIORequest* Request)
+	{
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, bWasCancelled, Request]()
+		{
+			Request->WaitCompletion();
+
+			// The read data is owned by the caller and allocated with FMemory::Malloc, so it is taken over without copying
+			uint8* PCMData{bWasCancelled ? nullptr : Request->GetReadResults()};
+			const int64 PCMDataSize{Request->GetSize()};
+
+			delete Request;
+
+			if (!WeakThis.IsValid())
+			{
+				FMemory::Free(PCMData);
+				return;
+			}
+
+			if (PCMData == nullptr)
+			{
+				UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Unable to load the decoded PCM data of the pre-imported sound asset '%s'"), *WeakThis->GetName());
+				WeakThis->OnDecodedPCMDataLoaded(FRuntimeBulkDataBuffer<uint8>());
+				return;
+			}
+
+			WeakThis->OnDecodedPCMDataLoaded(FRuntimeBulkDataBuffer<uint8>(PCMData, PCMDataSize));
+		});
+	};
+
+	if (DecodedPCMBulkData.CreateStreamingRequest(AIOP_Normal, &OnRequestCompleted, nullptr) == nullptr)
+	{
+		UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Unable to start loading the decoded PCM data of the pre-imported sound asset '%s'"), *GetName());
+		OnDecodedPCMDataLoaded(FRuntimeBulkDataBuffer<uint8>());
+	}
+}
+
+void UPreImportedSoundAsset::OnDecodedPCMDataLoaded(FRuntimeBulkDataBuffer<uint8>&& LoadedPCMData)
+{
+	if (LoadedPCMData.GetView().Num() > 0)
+	{
+		LoadedDecodedPCMData = MakeShared<FRuntimeBulkDataBuffer<uint8>, ESPMode::ThreadSafe>(MoveTemp(LoadedPCMData));
+	}
+
+	const bool bSucceeded{LoadedDecodedPCMData.IsValid()};
+
+	FDecodedAudioStruct DecodedAudioInfo;
+	if (bSucceeded)
+	{
+		DecodedAudioInfo.SoundWaveBasicInfo.NumOfChannels = DecodedNumOfChannels;
+		DecodedAudioInfo.SoundWaveBasicInfo.SampleRate = DecodedSampleRate;
+		DecodedAudioInfo.SoundWaveBasicInfo.Duration = static_cast<float>(DecodedNumOfFrames) / DecodedSampleRate;
+
+		DecodedAudioInfo.PCMInfo.PCMData = FRuntimeBulkDataBuffer<uint8>(LoadedDecodedPCMData.ToSharedRef());
+		DecodedAudioInfo.PCMInfo.PCMNumOfFrames = DecodedNumOfFrames;
+		DecodedAudioInfo.PCMInfo.StorageFormat = DecodedPCMStorageFormat;
+	}
+
+	// The callbacks may start loading again, so they are moved out first
+	TArray<TFunction<void(bool, FDecodedAudioStruct&&)>> LoadCallbacks{MoveTemp(PendingLoadCallbacks)};
+
+	for (const TFunction<void(bool, FDecodedAudioStruct&&)>& LoadCallback : LoadCallbacks)
+	{
+		LoadCallback(bSucceeded, DecodedAudioInfo.Share());
+	}
+}
@@ -0,0 +1,317 @@
+// Georgy Treshchev 2022.
+
+#include "ProgressiveMP3Importer.h"
+#include "RuntimeAudioImporterDefines.h"
+#include "RuntimeAudioImporterLibrary.h"
+
+#include "Transcoders/MP3Transcoder.h"
+#include "Transcoders/ProgressiveDecoder.h"
+
+#include "Async/Async.h"
+#include "HAL/CriticalSection.h"
+#include "Misc/ScopeLock.h"
+#include "Templates/Atomic.h"
+
+/** Decoding state of the progressive import, shared with the background decoding tasks so that they never access the importer, which may be destroyed while they are running */
+struct FProgressiveMP3ImportState
+{
+	FProgressiveMP3ImportState(UProgressiveMP3Importer* Importer, UImportedSoundWave* SoundWave, EPCMStorageFormat StorageFormat)
+		: Importer(Importer)
+	  , SoundWave(SoundWave)
+	  , StorageFormat(StorageFormat)
+	{
+	}
+
+	/**
+	 * End the stream, after which the appended data is ignored, and release the sound wave from the root set on the game thread. Must be called with DecoderGuard locked
+	 */
+	void EndStream()
+	{
+		bStreamEnded = true;
+
+		if (bSoundWaveRooted)
+		{
+			bSoundWaveRooted = false;
+
+			// The sound wave stays in the root set until the task runs, so it is still valid by then
+			AsyncTask(ENamedThreads::GameThread, [SoundWave = SoundWave]()
+			{
+				SoundWave->RemoveFromRoot();
+			});
+		}
+	}
+
+	/** The importer the results are broadcast by. Accessed only from the game thread */
+	const TWeakObjectPtr<UProgressiveMP3Importer> Importer;
+
+	/** The sound wave the decoded PCM data is appended to. Kept in the root set until the stream ends, so that it outlives the decoding tasks even if the importer does not */
+	UImportedSoundWave* const SoundWave;
+
+	/** Format to store the PCM data of the imported sound wave in */
+	const EPCMStorageFormat StorageFormat;
+
+	/** Appended data not yet passed to the decoder. Guarded by PendingDataGuard */
+	TArray64<uint8> PendingEncodedData;
+
+	/** Whether the end of the stream has been marked. Guarded by PendingDataGuard */
+	bool bFinishRequested{false};
+
+	/** Guards the pending data, since it may be appended from different threads */
+	FCriticalSection PendingDataGuard;
+
+	/** Decoder of the stream. Created by the first decoding task. Guarded by DecoderGuard */
+	TUniquePtr<FProgressiveAudioDecoder> Decoder;
+
+	/** Decoded PCM data, reused between the decoding tasks. Guarded by DecoderGuard */
+	TArray<uint8> DecodedPCMData;
+
+	/** Whether the sound wave is still in the root set. Guarded by DecoderGuard */
+	bool bSoundWaveRooted{true};
+
+	/** Serializes the decoding tasks, so that the stream is decoded in order */
+	FCriticalSection DecoderGuard;
+
+	/** Whether a decoding task is scheduled */
+	TAtomic<bool> bDecodingScheduled{false};
+
+	/** Whether the sound wave is ready to be played */
+	TAtomic<bool> bSoundWaveReady{false};
+
+	/** Whether the stream has ended (either finished or failed), after which the appended data is ignored */
+	TAtomic<bool> bStreamEnded{false};
+};
+
+UProgressiveMP3Importer::~UProgressiveMP3Importer() = default;
+
+void UProgressiveMP3Importer::BeginDestroy()
+{
+	// The stream can no longer be finished once the importer is gone, so it is ended here unless a decoding task has already ended it
+	if (State.IsValid())
+	{
+		FScopeLock DecoderLock(&State->DecoderGuard);
+
+		if (!State->bStreamEnded)
+		{
+			// The playback finishes once it reaches the end of the appended data, since nothing more is coming
+			SoundWave->bAwaitingPCMData = false;
+			State->EndStream();
+		}
+	}
+
+	Super::BeginDestroy();
+}
+
+UProgressiveMP3Importer* UProgressiveMP3Importer::CreateProgressiveMP3Importer(EPCMStorageFormat PCMStorageFormat)
+{
+	UProgressiveMP3Importer* ProgressiveImporter = NewObject<UProgressiveMP3Importer>();
+
+	ProgressiveImporter->SoundWave = NewObject<UImportedSoundWave>();
+	ProgressiveImporter->SoundWave->AddToRoot();
+	ProgressiveImporter->State = MakeShared<FProgressiveMP3ImportState, ESPMode::ThreadSafe>(ProgressiveImporter, ProgressiveImporter->SoundWave, PCMStorageFormat);
+
+	return ProgressiveImporter;
+}
+
+void UProgressiveMP3Importer::AppendEncodedData(const TArray<uint8>& AudioData)
+{
+	AppendEncodedData(AudioData.GetData(), AudioData.Num());
+}
+
+void UProgressiveMP3Importer::AppendEncodedData(const uint8* AudioData, int64 AudioDataSize)
+{
+	if (State->bStreamEnded || AudioDataSize <= 0)
+	{
+		return;
+	}
+
+	{
+		FScopeLock Lock(&State->PendingDataGuard);
+
+		if (State->bFinishRequested)
+		{
+			UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Unable to append '%lld' bytes to the MP3 stream because it has already been finished"), AudioDataSize);
+			return;
+		}
+
+		State->PendingEncodedData.Append(AudioData, AudioDataSize);
+	}
+
+	ScheduleDecoding();
+}
+
+void UProgressiveMP3Importer::FinishStream()
+{
+	{
+		FScopeLock Lock(&State->PendingDataGuard);
+
+		if (State->bFinishRequested)
+		{
+			return;
+		}
+
+		State->bFinishRequested = true;
+	}
+
+	ScheduleDecoding();
+}
+
+UImportedSoundWave* UProgressiveMP3Importer::GetSoundWave() const
+{
+	return State->bSoundWaveReady ? SoundWave : nullptr;
+}
+
+void UProgressiveMP3Importer::ScheduleDecoding()
+{
+	if (State->bDecodingScheduled.Exchange(true))
+	{
+		return;
+	}
+
+	// The task owns the decoding state, so it keeps running even if the importer is destroyed in the meantime
+	AsyncTask(ENamedThreads::AnyBackgroundHiPriTask, [State = State.ToSharedRef()]()
+	{
+		DecodePendingData(State);
+	});
+}
+
+void UProgressiveMP3Importer::DecodePendingData(const TSharedRef<FProgressiveMP3ImportState, ESPMode::ThreadSafe>& State)
+{
+	FScopeLock DecoderLock(&State->DecoderGuard);
+
+	// Cleared while holding the decoder lock, so that the data appended from now on is taken by the next task only after this one is done
+	State->bDecodingScheduled = false;
+
+	TArray64<uint8> EncodedData;
+	bool bEndOfStream;
+	{
+		FScopeLock Lock(&State->PendingDataGuard);
+
+		EncodedData = MoveTemp(State->PendingEncodedData);
+		bEndOfStream = State->bFinishRequested;
+	}
+
+	if (State->bStreamEnded)
+	{
+		return;
+	}
+
+	if (!State->Decoder.IsValid())
+	{
+		State->Decoder = MP3Transcoder::CreateProgressiveDecoder();
+	}
+
+	FProgressiveAudioDecoder& Decoder = *State->Decoder;
+	UImportedSoundWave* SoundWave = State->SoundWave;
+
+	Decoder.AppendEncodedData(EncodedData.GetData(), EncodedData.Num());
+
+	const uint32 NumOfDecodedFrames{Decoder.DecodeFrames(State->DecodedPCMData, State->StorageFormat, bEndOfStream)};
+
+	if (NumOfDecodedFrames > 0)
+	{
+		const bool bFirstFrames{!State->bSoundWaveReady};
+
+		// The sound wave is not exposed until now, so it can be defined from this thread
+		if (bFirstFrames)
+		{
+			FDecodedAudioStruct DecodedAudioInfo;
+			DecodedAudioInfo.SoundWaveBasicInfo = Decoder.GetSoundWaveBasicInfo();
+
+			URuntimeAudioImporterLibrary::FillSoundWaveBasicInfo(SoundWave, DecodedAudioInfo);
+
+			SoundWave->PCMBufferInfo.StorageFormat = State->StorageFormat;
+			SoundWave->PCMBufferInfo.PCMNumOfFrames = 0;
+			SoundWave->bAwaitingPCMData = true;
+		}
+
+		// Fails if the memory of the sound wave has been released, in which case the rest of the stream is of no use
+		if (!SoundWave->AppendPCMData(State->DecodedPCMData.GetData(), NumOfDecodedFrames))
+		{
+			State->Decoder.Reset();
+			State->EndStream();
+
+			OnFinished_Internal(State->Importer);
+			return;
+		}
+
+		if (bFirstFrames)
+		{
+			State->bSoundWaveReady = true;
+
+			UE_LOG(LogRuntimeAudioImporter, Log, TEXT("The first frames of the MP3 stream were successfully imported, the rest is appended as it arrives. Information about imported data:\n%s"), *Decoder.GetSoundWaveBasicInfo().ToString());
+			OnResult_Internal(State->Importer, SoundWave, ETranscodingStatus::SuccessfulImport);
+		}
+	}
+
+	if (bEndOfStream)
+	{
+		State->Decoder.Reset();
+		State->DecodedPCMData.Empty();
+
+		// The playback finishes once it reaches the end of the appended data. Set before ending the stream, after which the sound wave may be garbage collected
+		SoundWave->bAwaitingPCMData = false;
+		State->EndStream();
+
+		if (!State->bSoundWaveReady)
+		{
+			UE_LOG(LogRuntimeAudioImporter, Error, TEXT("The MP3 stream has been finished without a single decodable frame"));
+			OnResult_Internal(State->Importer, nullptr, ETranscodingStatus::FailedToReadAudioDataArray);
+			return;
+		}
+
+		OnFinished_Internal(State->Importer);
+	}
+}
+
+void UProgressiveMP3Importer::OnResult_Internal(const TWeakObjectPtr<UProgressiveMP3Importer>& WeakThis, UImportedSoundWave* SoundWaveRef, ETranscodingStatus Status)
+{
+	AsyncTask(ENamedThreads::GameThread, [WeakThis, SoundWaveRef, Status]()
+	{
+		if (!WeakThis.IsValid())
+		{
+			return;
+		}
+
+		bool bBroadcasted{false};
+
+		if (WeakThis->OnResultNative.IsBound())
+		{
+			bBroadcasted = true;
+			WeakThis->OnResultNative.Broadcast(WeakThis.Get(), SoundWaveRef, Status);
+		}
+
+		if (WeakThis->OnResult.IsBound())
+		{
+			bBroadcasted = true;
+			WeakThis->OnResult.Broadcast(WeakThis.Get(), SoundWaveRef, Status);
+		}
+
+		if (!bBroadcasted)
+		{
+			UE_LOG(LogRuntimeAudioImporter, Error, TEXT("You did not bind to the delegate to get the result of the progressive import"));
+		}
+	});
+}
+
+void UProgressiveMP3Importer::OnFinished_Internal(const TWeakObjectPtr<UProgressiveMP3Importer>& WeakThis)
+{
+	AsyncTask(ENamedThreads::GameThread, [WeakThis]()
+	{
+		if (!WeakThis.IsValid())
+		{
+			return;
+		}
+
+		UE_LOG(LogRuntimeAudioImporter, Log, TEXT("Progressive import of the MP3 stream has been finished"));
+
+		if (WeakThis->OnFinishedNative.IsBound())
+		{
+			WeakThis->OnFinishedNative.Broadcast(WeakThis.Get(), WeakThis->SoundWave);
+		}
+
+		if (WeakThis->OnFinished.IsBound())
+		{
+			WeakThis->OnFinished.Broadcast(WeakThis.Get(), WeakThis->SoundWave);
+		}
+	});
+}
@@ -86,7 +86,12 @@ void URuntimeAudioCompressor::CompressSoundWave(UImportedSoundWave* ImportedSoun
 		// Filling in decoded audio info
 		FDecodedAudioStruct DecodedAudioInfo;
 		{
-			DecodedAudioInfo.PCMInfo = ImportedSoundWaveRef->PCMBufferInfo;
+			// Referenced without being copied, since the transcoders only read it
+			DecodedAudioInfo.PCMInfo = ImportedSoundWaveRef->SharePCMData();
+
+			// The transcoders take 32-bit float data
+			RAWTranscoder::ConvertPCMStorageFormat(DecodedAudioInfo.PCMInfo, EPCMStorageFormat::Float32);
+
 			FSoundWaveBasicStruct SoundWaveBasicInfo;
 			{
 				SoundWaveBasicInfo.NumOfChannels = ImportedSoundWaveRef->NumChannels;
@@ -147,7 +152,7 @@ void URuntimeAudioCompressor::CompressSoundWave(UImportedSoundWave* ImportedSoun
 			FDecodedAudioStruct CustomDecodedAudioInfo;
 			{
 				CustomDecodedAudioInfo.SoundWaveBasicInfo = DecodedAudioInfo.SoundWaveBasicInfo;
-				CustomDecodedAudioInfo.PCMInfo.PCMData = FBulkDataBuffer<uint8>(reinterpret_cast<uint8*>(RawPCMData), RawPCMDataSize);
+				CustomDecodedAudioInfo.PCMInfo.PCMData = FRuntimeBulkDataBuffer<uint8>(reinterpret_cast<uint8*>(RawPCMData), RawPCMDataSize);
 				CustomDecodedAudioInfo.PCMInfo.PCMNumOfFrames = DecodedAudioInfo.PCMInfo.PCMNumOfFrames;
 			}
 
@@ -0,0 +1,636 @@
+// Georgy Treshchev 2022.
+
+#include "AudioImportStatsCollector.h"
+#include "RuntimeAudioImporterDefines.h"
+#include "RuntimeAudioImporterLibrary.h"
+#include "RuntimeAudioImporterTypes.h"
+#include "ImportedSoundWaveTimeStretcher.h"
+
+#include "Transcoders/ChunkedDecoder.h"
+#include "Transcoders/FlacTranscoder.h"
+#include "Transcoders/MP3Transcoder.h"
+#include "Transcoders/RAWTranscoder.h"
+#include "Transcoders/VorbisTranscoder.h"
+#include "Transcoders/WAVTranscoder.h"
+
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+#if !UE_BUILD_SHIPPING
+
+namespace
+{
+	/** Benchmark settings parsed from the console command arguments */
+	struct FBenchmarkSettings
+	{
+		/** Duration of the synthetic signal, in seconds */
+		float Duration = 30.f;
+
+		/** Number of channels of the synthetic signal */
+		int32 NumOfChannels = 2;
+
+		/** Sample rate of the synthetic signal */
+		int32 SampleRate = 48000;
+
+		/** Number of measured iterations of each benchmark case */
+		int32 NumOfIterations = 5;
+
+		/** Number of samples of the large storage format conversion cases, tiled from the synthetic signal. Zero to skip them */
+		int64 NumOfLargeSamples = 100000000;
+
+		/** Path to the MP3 file to benchmark decoding of. There is no MP3 encoder to produce the data from the synthetic signal */
+		FString MP3FilePath;
+
+		/** Path to the FLAC file to benchmark decoding of. There is no FLAC encoder to produce the data from the synthetic signal */
+		FString FlacFilePath;
+
+		/** Path to save the JSON report to */
+		FString OutputFilePath;
+	};
+
+	/** Measured results of a single benchmark case */
+	struct FBenchmarkResult
+	{
+		/** Name of the benchmark case */
+		FString Name;
+
+		/** Whether the benchmark case succeeded or not. The rest of the results are only meaningful if it did */
+		bool bSucceeded = false;
+
+		/** The reason why the benchmark case was skipped or failed */
+		FString Reason;
+
+		/** Number of bytes processed per iteration. Encoded bytes for decoding and PCM bytes otherwise */
+		int64 NumOfProcessedBytes = 0;
+
+		/** Duration of the processed audio data, in seconds */
+		double AudioDuration = 0;
+
+		/** Fastest iteration, in seconds */
+		double BestTime = 0;
+
+		/** Mean of all iterations, in seconds */
+		double MeanTime = 0;
+
+		/** Peak number of bytes allocated while an iteration was running */
+		int64 PeakAllocatedBytes = 0;
+
+		/** Number of allocations made per iteration */
+		int64 NumOfAllocations = 0;
+
+		/** Peak growth of the resident memory of the process while an iteration was running. Only measured by the file loading cases */
+		int64 ResidentBytes = 0;
+
+		double GetMegabytesPerSecond() const
+		{
+			return BestTime > 0 ? NumOfProcessedBytes / (1024. * 1024.) / BestTime : 0;
+		}
+
+		double GetRealtimeFactor() const
+		{
+			return BestTime > 0 ? AudioDuration / BestTime : 0;
+		}
+
+		FString ToJson() const
+		{
+			return FString::Printf(TEXT("{\"name\": \"%s\", \"succeeded\": %s, \"reason\": \"%s\", \"processed_bytes\": %lld, \"audio_seconds\": %.3f, \"best_seconds\": %.6f, \"mean_seconds\": %.6f, \"mb_per_second\": %.2f, \"realtime_factor\": %.2f, \"peak_allocated_bytes\": %lld, \"allocations\": %lld, \"resident_bytes\": %lld}"),
+			                       *Name, bSucceeded ? TEXT("true") : TEXT("false"), *Reason.ReplaceCharWithEscapedChar(), NumOfProcessedBytes, AudioDuration, BestTime, MeanTime, GetMegabytesPerSecond(), GetRealtimeFactor(), PeakAllocatedBytes, NumOfAllocations, ResidentBytes);
+		}
+
+		FString ToString() const
+		{
+			if (!bSucceeded)
+			{
+				return FString::Printf(TEXT("%-24s skipped: %s"), *Name, *Reason);
+			}
+
+			return FString::Printf(TEXT("%-24s best %9.3f ms, mean %9.3f ms, %9.2f MB/s, %8.2fx realtime, peak %10lld bytes in %lld allocations"),
+			                       *Name, BestTime * 1000, MeanTime * 1000, GetMegabytesPerSecond(), GetRealtimeFactor(), PeakAllocatedBytes, NumOfAllocations);
+		}
+	};
+
+	/**
+	 * Measure the benchmark case. One warm-up iteration is run before the measured ones
+	 *
+	 * @param Name Name of the benchmark case
+	 * @param NumOfProcessedBytes Number of bytes processed per iteration
+	 * @param AudioDuration Duration of the processed audio data, in seconds
+	 * @param NumOfIterations Number of measured iterations
+	 * @param BenchmarkCase Single iteration of the benchmark case. Returns whether it succeeded or not
+	 * @return The measured results
+	 */
+	FBenchmarkResult RunBenchmarkCase(const FString& Name, int64 NumOfProcessedBytes, double AudioDuration, int32 NumOfIterations, TFunctionRef<bool()> BenchmarkCase)
+	{
+		// The allocations from all threads are counted, so the benchmark should be run while the rest of the engine is idle
+		// The counters are never destroyed, as a thread might still be accounting to them after they have been popped
+		static FAudioImportStageCounters AllocationCounters;
+		FAudioAllocationTracker::Install();
+
+		FBenchmarkResult Result;
+		Result.Name = Name;
+		Result.NumOfProcessedBytes = NumOfProcessedBytes;
+		Result.AudioDuration = AudioDuration;
+
+		if (!BenchmarkCase())
+		{
+			Result.Reason = TEXT("The transcoder failed");
+			return Result;
+		}
+
+		double TotalTime{0};
+		Result.BestTime = TNumericLimits<double>::Max();
+
+		for (int32 IterationIndex = 0; IterationIndex < NumOfIterations; ++IterationIndex)
+		{
+			AllocationCounters.NumOfAllocations = 0;
+			AllocationCounters.AllocatedBytes = 0;
+			AllocationCounters.PeakAllocatedBytes = 0;
+			FAudioAllocationTracker::PushGlobalCounters(&AllocationCounters);
+
+			const double StartTime{FPlatformTime::Seconds()};
+			const bool bSucceeded{BenchmarkCase()};
+			const double IterationTime{FPlatformTime::Seconds() - StartTime};
+
+			FAudioAllocationTracker::PopGlobalCounters(&AllocationCounters);
+
+			if (!bSucceeded)
+			{
+				Result.Reason = TEXT("The transcoder failed");
+				return Result;
+			}
+
+			TotalTime += IterationTime;
+			Result.BestTime = FMath::Min(Result.BestTime, IterationTime);
+			Result.PeakAllocatedBytes = FMath::Max(Result.PeakAllocatedBytes, AllocationCounters.PeakAllocatedBytes.Load());
+			Result.NumOfAllocations = AllocationCounters.NumOfAllocations.Load();
+		}
+
+		Result.MeanTime = TotalTime / NumOfIterations;
+		Result.bSucceeded = true;
+
+		return Result;
+	}
+
+	FBenchmarkResult MakeSkippedResult(const FString& Name, const FString& Reason)
+	{
+		FBenchmarkResult Result;
+		Result.Name = Name;
+		Result.Reason = Reason;
+		return Result;
+	}
+
+	FString GetRAWFormatName(ERAWAudioFormat Format)
+	{
+		switch (Format)
+		{
+		case ERAWAudioFormat::Int16:
+			return TEXT("Int16");
+		case ERAWAudioFormat::Int32:
+			return TEXT("Int32");
+		case ERAWAudioFormat::UInt8:
+			return TEXT("UInt8");
+		case ERAWAudioFormat::Float32:
+			return TEXT("Float32");
+		}
+
+		return TEXT("Unknown");
+	}
+
+	/**
+	 * Generate a deterministic signal with a logarithmic sine sweep and a bit of noise in each channel, so that the encoders do not take shortcuts on silence or pure tones
+	 */
+	void GenerateSignal(const FBenchmarkSettings& Settings, FDecodedAudioStruct& DecodedAudioInfo)
+	{
+		const int64 NumOfFrames{static_cast<int64>(Settings.Duration * Settings.SampleRate)};
+		const int64 NumOfSamples{NumOfFrames * Settings.NumOfChannels};
+
+		TArray<uint8> PCMData;
+		PCMData.SetNumUninitialized(NumOfSamples * sizeof(float));
+
+		float* Samples = reinterpret_cast<float*>(PCMData.GetData());
+		FRandomStream RandomStream(0x5EED);
+
+		constexpr double StartFrequency{100}, EndFrequency{8000};
+		const double SweepRate{FMath::Loge(EndFrequency / StartFrequency) / FMath::Max<double>(Settings.Duration, 1)};
+
+		for (int32 ChannelIndex = 0; ChannelIndex < Settings.NumOfChannels; ++ChannelIndex)
+		{
+			double Phase{ChannelIndex * PI / Settings.NumOfChannels};
+
+			for (int64 FrameIndex = 0; FrameIndex < NumOfFrames; ++FrameIndex)
+			{
+				const double Time{static_cast<double>(FrameIndex) / Settings.SampleRate};
+				const double Frequency{StartFrequency * FMath::Exp(SweepRate * FMath::Fmod(Time, static_cast<double>(Settings.Duration)))};
+
+				Phase += 2 * PI * Frequency / Settings.SampleRate;
+				Samples[FrameIndex * Settings.NumOfChannels + ChannelIndex] = static_cast<float>(0.5 * FMath::Sin(Phase) + 0.05 * RandomStream.FRandRange(-1, 1));
+			}
+		}
+
+		DecodedAudioInfo.SoundWaveBasicInfo.NumOfChannels = Settings.NumOfChannels;
+		DecodedAudioInfo.SoundWaveBasicInfo.SampleRate = Settings.SampleRate;
+		DecodedAudioInfo.SoundWaveBasicInfo.Duration = Settings.Duration;
+
+		DecodedAudioInfo.PCMInfo.PCMData = FRuntimeBulkDataBuffer<uint8>(MoveTemp(PCMData));
+		DecodedAudioInfo.PCMInfo.PCMNumOfFrames = NumOfFrames;
+		DecodedAudioInfo.PCMInfo.StorageFormat = EPCMStorageFormat::Float32;
+	}
+
+	/**
+	 * Benchmark decoding of the encoded audio data into both PCM storage formats
+	 */
+	template <typename DecodeFunctionType>
+	void RunDecodingBenchmarkCases(const FString& Name, const FEncodedAudioStruct& EncodedAudioInfo, double AudioDuration, int32 NumOfIterations, DecodeFunctionType DecodeFunction, TArray<FBenchmarkResult>& Results)
+	{
+		for (const EPCMStorageFormat StorageFormat : {EPCMStorageFormat::Float32, EPCMStorageFormat::Int16})
+		{
+			const FString CaseName{FString::Printf(TEXT("%s.Decode.%s"), *Name, StorageFormat == EPCMStorageFormat::Int16 ? TEXT("Int16") : TEXT("Float32"))};
+
+			Results.Add(RunBenchmarkCase(CaseName, EncodedAudioInfo.AudioData.GetView().Num(), AudioDuration, NumOfIterations, [&EncodedAudioInfo, &DecodeFunction, StorageFormat]()
+			{
+				FDecodedAudioStruct DecodedAudioInfo;
+				DecodedAudioInfo.PCMInfo.StorageFormat = StorageFormat;
+				return DecodeFunction(EncodedAudioInfo, DecodedAudioInfo, nullptr, nullptr);
+			}));
+		}
+
+		Results.Add(RunBenchmarkCase(FString::Printf(TEXT("%s.Sniff"), *Name), EncodedAudioInfo.AudioData.GetView().Num(), AudioDuration, NumOfIterations, [&EncodedAudioInfo]()
+		{
+			uint8 Confidence;
+			return URuntimeAudioImporterLibrary::SniffAudioFormat(EncodedAudioInfo.AudioData.GetView().GetData(), EncodedAudioInfo.AudioData.GetView().Num(), Confidence) == EncodedAudioInfo.AudioFormat;
+		}));
+	}
+
+	/**
+	 * Load the audio file the way the file imports do, either by mapping it or by reading it whole as they fall back to where mapping is unavailable
+	 */
+	bool LoadBenchmarkFile(FRuntimeBulkDataBuffer<uint8>& AudioData, const FString& FilePath, bool bMapped)
+	{
+		if (bMapped)
+		{
+			TUniquePtr<IMappedFileHandle> MappedFileHandle{FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FilePath)};
+			TUniquePtr<IMappedFileRegion> MappedFileRegion{MappedFileHandle.IsValid() ? MappedFileHandle->MapRegion() : nullptr};
+			if (!MappedFileRegion.IsValid())
+			{
+				return false;
+			}
+
+			AudioData = FRuntimeBulkDataBuffer<uint8>(MoveTemp(MappedFileHandle), MoveTemp(MappedFileRegion));
+			return true;
+		}
+
+		TArray<uint8> AudioDataArray;
+		if (!FFileHelper::LoadFileToArray(AudioDataArray, *FilePath))
+		{
+			return false;
+		}
+
+		AudioData = FRuntimeBulkDataBuffer<uint8>(MoveTemp(AudioDataArray));
+		return true;
+	}
+
+	/**
+	 * Benchmark the time to the first decoded chunk and the growth of the resident memory when the audio file is mapped and when it is read whole.
+	 * The file stays in the OS file cache after the warm-up iteration, so the times are those of a warm cache
+	 */
+	void RunFileLoadingBenchmarkCases(const FString& Name, const FString& FilePath, int32 NumOfIterations, TUniquePtr<FChunkedAudioDecoder> (*CreateDecoderFunction)(const uint8*, int64), TArray<FBenchmarkResult>& Results)
+	{
+		if (FilePath.IsEmpty())
+		{
+			return;
+		}
+
+		constexpr uint32 NumOfFirstFrames{1024};
+		const int64 FileSize{IFileManager::Get().FileSize(*FilePath)};
+
+		double FirstSampleTimes[2]{0, 0};
+		int64 ResidentBytes[2]{0, 0};
+
+		for (const bool bMapped : {true, false})
+		{
+			const FString CaseName{FString::Printf(TEXT("%s.FirstSample.%s"), *Name, bMapped ? TEXT("Mapped") : TEXT("ReadWhole"))};
+
+			{
+				FRuntimeBulkDataBuffer<uint8> AudioData;
+				if (!LoadBenchmarkFile(AudioData, FilePath, bMapped))
+				{
+					Results.Add(MakeSkippedResult(CaseName, bMapped ? FString::Printf(TEXT("Unable to map the file '%s', memory mapping might not be supported on this platform"), *FilePath) : FString::Printf(TEXT("Unable to read the file '%s'"), *FilePath)));
+					continue;
+				}
+			}
+
+			int64 PeakResidentBytes{0};
+			TArray<float> FirstPCMData;
+
+			FBenchmarkResult& Result{Results.Add_GetRef(RunBenchmarkCase(CaseName, FileSize, 0, NumOfIterations, [&]()
+			{
+				const uint64 UsedPhysicalBefore{FPlatformMemory::GetStats().UsedPhysical};
+
+				FRuntimeBulkDataBuffer<uint8> AudioData;
+				if (!LoadBenchmarkFile(AudioData, FilePath, bMapped))
+				{
+					return false;
+				}
+
+				const TUniquePtr<FChunkedAudioDecoder> Decoder{CreateDecoderFunction(AudioData.GetView().GetData(), AudioData.GetView().Num())};
+				if (!Decoder.IsValid())
+				{
+					return false;
+				}
+
+				FirstPCMData.SetNumUninitialized(NumOfFirstFrames * Decoder->GetSoundWaveBasicInfo().NumOfChannels, false);
+				if (Decoder->ReadFrames(FirstPCMData.GetData(), NumOfFirstFrames) == 0)
+				{
+					return false;
+				}
+
+				PeakResidentBytes = FMath::Max(PeakResidentBytes, static_cast<int64>(FPlatformMemory::GetStats().UsedPhysical) - static_cast<int64>(UsedPhysicalBefore));
+				return true;
+			}))};
+
+			Result.ResidentBytes = PeakResidentBytes;
+			FirstSampleTimes[bMapped ? 0 : 1] = Result.BestTime;
+			ResidentBytes[bMapped ? 0 : 1] = PeakResidentBytes;
+		}
+
+		UE_LOG(LogRuntimeAudioImporter, Log, TEXT("%s: first sample of a %lld-byte file after %.3f ms with %lld resident bytes when mapped, %.3f ms with %lld resident bytes when read whole"),
+		       *Name, FileSize, FirstSampleTimes[0] * 1000, ResidentBytes[0], FirstSampleTimes[1] * 1000, ResidentBytes[1]);
+	}
+
+	/**
+	 * Benchmark decoding of the audio file given in the arguments, or report the cases as skipped if no file is given
+	 */
+	template <typename DecodeFunctionType>
+	void RunFileDecodingBenchmarkCases(const FString& Name, const FString& FilePath, EAudioFormat AudioFormat, int32 NumOfIterations, DecodeFunctionType DecodeFunction, TArray<FBenchmarkResult>& Results)
+	{
+		const FString CaseName{FString::Printf(TEXT("%s.Decode"), *Name)};
+
+		if (FilePath.IsEmpty())
+		{
+			Results.Add(MakeSkippedResult(CaseName, FString::Printf(TEXT("There is no %s encoder, pass %sFile=<path> to benchmark decoding of an existing file"), *Name, *Name)));
+			return;
+		}
+
+		TArray<uint8> AudioData;
+		if (!FFileHelper::LoadFileToArray(AudioData, *FilePath))
+		{
+			Results.Add(MakeSkippedResult(CaseName, FString::Printf(TEXT("Unable to read the file '%s'"), *FilePath)));
+			return;
+		}
+
+		const FEncodedAudioStruct EncodedAudioInfo(FRuntimeBulkDataBuffer<uint8>(MoveTemp(AudioData)), AudioFormat);
+
+		// The duration is only known once decoded
+		FDecodedAudioStruct DecodedAudioInfo;
+		if (!DecodeFunction(EncodedAudioInfo, DecodedAudioInfo, nullptr, nullptr))
+		{
+			Results.Add(MakeSkippedResult(CaseName, FString::Printf(TEXT("Unable to decode the file '%s'"), *FilePath)));
+			return;
+		}
+
+		RunDecodingBenchmarkCases(Name, EncodedAudioInfo, DecodedAudioInfo.SoundWaveBasicInfo.Duration, NumOfIterations, DecodeFunction, Results);
+	}
+
+	void RunBenchmark(const TArray<FString>& Args)
+	{
+		const FString CommandLine{FString::Join(Args, TEXT(" "))};
+
+		FBenchmarkSettings Settings;
+		FParse::Value(*CommandLine, TEXT("Seconds="), Settings.Duration);
+		FParse::Value(*CommandLine, TEXT("Channels="), Settings.NumOfChannels);
+		FParse::Value(*CommandLine, TEXT("SampleRate="), Settings.SampleRate);
+		FParse::Value(*CommandLine, TEXT("Iterations="), Settings.NumOfIterations);
+		FParse::Value(*CommandLine, TEXT("LargeSamples="), Settings.NumOfLargeSamples);
+		FParse::Value(*CommandLine, TEXT("MP3File="), Settings.MP3FilePath);
+		FParse::Value(*CommandLine, TEXT("FlacFile="), Settings.FlacFilePath);
+		FParse::Value(*CommandLine, TEXT("Output="), Settings.OutputFilePath);
+
+		if (Settings.Duration <= 0 || Settings.NumOfChannels <= 0 || Settings.SampleRate <= 0 || Settings.NumOfIterations <= 0 || Settings.NumOfLargeSamples < 0)
+		{
+			UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Invalid benchmark settings. Seconds, Channels, SampleRate and Iterations must be positive and LargeSamples must not be negative"));
+			return;
+		}
+
+		if (Settings.OutputFilePath.IsEmpty())
+		{
+			Settings.OutputFilePath = FPaths::ProjectSavedDir() / TEXT("RuntimeAudioImporter") / FString::Printf(TEXT("Benchmark-%s.json"), *FDateTime::Now().ToString());
+		}
+
+		UE_LOG(LogRuntimeAudioImporter, Log, TEXT("Running the transcoder benchmark on %.2f seconds of %d-channel audio at %d Hz, %d iterations per case"), Settings.Duration, Settings.NumOfChannels, Settings.SampleRate, Settings.NumOfIterations);
+
+		FDecodedAudioStruct FloatAudioInfo;
+		GenerateSignal(Settings, FloatAudioInfo);
+
+		const int64 NumOfSamples{static_cast<int64>(FloatAudioInfo.PCMInfo.PCMNumOfFrames) * Settings.NumOfChannels};
+		const double AudioDuration{Settings.Duration};
+		const int32 NumOfIterations{Settings.NumOfIterations};
+
+		FDecodedAudioStruct Int16AudioInfo{FloatAudioInfo.Share()};
+		RAWTranscoder::ConvertPCMStorageFormat(Int16AudioInfo.PCMInfo, EPCMStorageFormat::Int16);
+
+		TArray<FBenchmarkResult> Results;
+
+		// RAW conversions between every pair of formats, from the synthetic signal transcoded to each of them
+		{
+			const ERAWAudioFormat RAWFormats[]{ERAWAudioFormat::Int16, ERAWAudioFormat::Int32, ERAWAudioFormat::UInt8, ERAWAudioFormat::Float32};
+
+			TMap<ERAWAudioFormat, TArray<uint8>> SourceSamples;
+			for (const ERAWAudioFormat Format : RAWFormats)
+			{
+				TArray<uint8>& Samples{SourceSamples.Add(Format)};
+				Samples.SetNumUninitialized(NumOfSamples * RAWTranscoder::GetSampleSize(Format));
+				RAWTranscoder::TranscodeSamples(FloatAudioInfo.PCMInfo.PCMData.GetView().GetData(), ERAWAudioFormat::Float32, Samples.GetData(), Format, NumOfSamples);
+			}
+
+			TArray<uint8> OutSamples;
+			OutSamples.SetNumUninitialized(NumOfSamples * sizeof(int32));
+
+			for (const ERAWAudioFormat FormatFrom : RAWFormats)
+			{
+				for (const ERAWAudioFormat FormatTo : RAWFormats)
+				{
+					if (FormatFrom == FormatTo)
+					{
+						continue;
+					}
+
+					const uint8* InSamples{SourceSamples[FormatFrom].GetData()};
+					const FString CaseName{FString::Printf(TEXT("RAW.%sTo%s"), *GetRAWFormatName(FormatFrom), *GetRAWFormatName(FormatTo))};
+
+					Results.Add(RunBenchmarkCase(CaseName, NumOfSamples * RAWTranscoder::GetSampleSize(FormatFrom), AudioDuration, NumOfIterations, [&]()
+					{
+						RAWTranscoder::TranscodeSamples(InSamples, FormatFrom, OutSamples.GetData(), FormatTo, NumOfSamples);
+						return true;
+					}));
+				}
+			}
+		}
+
+		// Storage format conversions on a large buffer, which is bound by the memory bandwidth rather than by the caches
+		if (Settings.NumOfLargeSamples > 0)
+		{
+			const float* SignalSamples = reinterpret_cast<const float*>(FloatAudioInfo.PCMInfo.PCMData.GetView().GetData());
+			const double LargeAudioDuration{static_cast<double>(Settings.NumOfLargeSamples) / (static_cast<double>(Settings.SampleRate) * Settings.NumOfChannels)};
+
+			TArray64<float> FloatSamples;
+			FloatSamples.SetNumUninitialized(Settings.NumOfLargeSamples);
+			for (int64 SampleIndex = 0; SampleIndex < Settings.NumOfLargeSamples; SampleIndex += NumOfSamples)
+			{
+				FMemory::Memcpy(FloatSamples.GetData() + SampleIndex, SignalSamples, FMath::Min(NumOfSamples, Settings.NumOfLargeSamples - SampleIndex) * sizeof(float));
+			}
+
+			TArray64<int16> Int16Samples;
+			Int16Samples.SetNumUninitialized(Settings.NumOfLargeSamples);
+
+			Results.Add(RunBenchmarkCase(TEXT("RAW.Large.Float32ToInt16"), Settings.NumOfLargeSamples * sizeof(float), LargeAudioDuration, NumOfIterations, [&]()
+			{
+				RAWTranscoder::ConvertFloatToInt16(FloatSamples.GetData(), Int16Samples.GetData(), Settings.NumOfLargeSamples);
+				return true;
+			}));
+
+			Results.Add(RunBenchmarkCase(TEXT("RAW.Large.Int16ToFloat32"), Settings.NumOfLargeSamples * sizeof(int16), LargeAudioDuration, NumOfIterations, [&]()
+			{
+				RAWTranscoder::ConvertInt16ToFloat(Int16Samples.GetData(), FloatSamples.GetData(), Settings.NumOfLargeSamples);
+				return true;
+			}));
+		}
+
+		// WAV
+		{
+			FEncodedAudioStruct WAVAudioInfo;
+
+			Results.Add(RunBenchmarkCase(TEXT("WAV.Encode.Int16"), NumOfSamples * sizeof(float), AudioDuration, NumOfIterations, [&]()
+			{
+				WAVAudioInfo = FEncodedAudioStruct();
+				return WAVTranscoder::Encode(FloatAudioInfo, WAVAudioInfo, FWAVEncodingFormat(EWAVEncodingFormat::FORMAT_PCM, 16));
+			}));
+
+			if (WAVAudioInfo.AudioData.GetView().Num() > 0)
+			{
+				WAVAudioInfo.AudioFormat = EAudioFormat::Wav;
+				RunDecodingBenchmarkCases(TEXT("WAV"), WAVAudioInfo, AudioDuration, NumOfIterations, &WAVTranscoder::Decode, Results);
+
+				// Saving the encoded data next to the report, since loading is only meaningful from a file
+				const FString WAVFilePath{FPaths::GetPath(Settings.OutputFilePath) / TEXT("Benchmark.wav")};
+				if (FFileHelper::SaveArrayToFile(TArrayView<const uint8>(WAVAudioInfo.AudioData.GetView().GetData(), static_cast<int32>(WAVAudioInfo.AudioData.GetView().Num())), *WAVFilePath))
+				{
+					RunFileLoadingBenchmarkCases(TEXT("WAV"), WAVFilePath, NumOfIterations, &WAVTranscoder::CreateChunkedDecoder, Results);
+					IFileManager::Get().Delete(*WAVFilePath);
+				}
+				else
+				{
+					Results.Add(MakeSkippedResult(TEXT("WAV.FirstSample"), FString::Printf(TEXT("Unable to save the encoded data to '%s'"), *WAVFilePath)));
+				}
+			}
+		}
+
+		// OGG Vorbis
+		{
+			FEncodedAudioStruct VorbisAudioInfo;
+
+			Results.Add(RunBenchmarkCase(TEXT("Vorbis.Encode"), NumOfSamples * sizeof(float), AudioDuration, NumOfIterations, [&]()
+			{
+				VorbisAudioInfo = FEncodedAudioStruct();
+				return VorbisTranscoder::Encode(FloatAudioInfo, VorbisAudioInfo, 50);
+			}));
+
+			if (VorbisAudioInfo.AudioData.GetView().Num() > 0)
+			{
+				VorbisAudioInfo.AudioFormat = EAudioFormat::OggVorbis;
+				RunDecodingBenchmarkCases(TEXT("Vorbis"), VorbisAudioInfo, AudioDuration, NumOfIterations, &VorbisTranscoder::Decode, Results);
+			}
+		}
+
+		// MP3 and FLAC can only be decoded
+		RunFileDecodingBenchmarkCases(TEXT("MP3"), Settings.MP3FilePath, EAudioFormat::Mp3, NumOfIterations, &MP3Transcoder::Decode, Results);
+		RunFileDecodingBenchmarkCases(TEXT("Flac"), Settings.FlacFilePath, EAudioFormat::Flac, NumOfIterations, &FlacTranscoder::Decode, Results);
+		RunFileLoadingBenchmarkCases(TEXT("MP3"), Settings.MP3FilePath, NumOfIterations, &MP3Transcoder::CreateChunkedDecoder, Results);
+		RunFileLoadingBenchmarkCases(TEXT("Flac"), Settings.FlacFilePath, NumOfIterations, &FlacTranscoder::CreateChunkedDecoder, Results);
+
+		// Time stretching, rendered in blocks the way the generation requests do. A single voice renders on a single core, so the realtime factor is the number of voices a core can keep up with
+		double TimeStretchVoicesPerCore{0};
+		{
+			constexpr float Tempo{1.25f};
+			constexpr float PitchShift{1.f};
+			constexpr int32 NumOfBlockFrames{512};
+
+			const uint32 NumOfSourceFrames{FloatAudioInfo.PCMInfo.PCMNumOfFrames};
+			const int64 NumOfStretchedFrames{static_cast<int64>(NumOfSourceFrames / Tempo)};
+
+			for (const FDecodedAudioStruct* SourceAudioInfo : {&FloatAudioInfo, &Int16AudioInfo})
+			{
+				const EPCMStorageFormat StorageFormat{SourceAudioInfo->PCMInfo.StorageFormat};
+				const int32 SampleSize{SourceAudioInfo->PCMInfo.GetSampleSize()};
+				const uint8* SourcePCMData{SourceAudioInfo->PCMInfo.PCMData.GetView().GetData()};
+
+				FImportedSoundWaveTimeStretcher TimeStretcher(Settings.SampleRate, Settings.NumOfChannels);
+				TimeStretcher.SetTempo(Tempo);
+				TimeStretcher.SetPitchShift(PitchShift);
+
+				TArray<uint8> BlockPCMData;
+				BlockPCMData.SetNumUninitialized(NumOfBlockFrames * Settings.NumOfChannels * SampleSize);
+
+				const FString CaseName{FString::Printf(TEXT("TimeStretch.%s"), StorageFormat == EPCMStorageFormat::Int16 ? TEXT("Int16") : TEXT("Float32"))};
+
+				const FBenchmarkResult& Result{Results.Add_GetRef(RunBenchmarkCase(CaseName, NumOfStretchedFrames * Settings.NumOfChannels * SampleSize, static_cast<double>(NumOfStretchedFrames) / Settings.SampleRate, NumOfIterations, [&]()
+				{
+					TimeStretcher.Reset();
+					while (TimeStretcher.Render(SourcePCMData, StorageFormat, NumOfSourceFrames, true, BlockPCMData.GetData(), NumOfBlockFrames) == NumOfBlockFrames)
+					{
+					}
+					return true;
+				}))};
+
+				if (Result.bSucceeded)
+				{
+					UE_LOG(LogRuntimeAudioImporter, Log, TEXT("%s: up to %d voices per core at %d Hz with %d channels, tempo %.2f"), *CaseName, FMath::FloorToInt(Result.GetRealtimeFactor()), Settings.SampleRate, Settings.NumOfChannels, Tempo);
+
+					if (StorageFormat == EPCMStorageFormat::Float32)
+					{
+						TimeStretchVoicesPerCore = FMath::FloorToDouble(Result.GetRealtimeFactor());
+					}
+				}
+			}
+		}
+
+		TArray<FString> ResultsJson;
+		for (const FBenchmarkResult& Result : Results)
+		{
+			UE_LOG(LogRuntimeAudioImporter, Log, TEXT("%s"), *Result.ToString());
+			ResultsJson.Add(Result.ToJson());
+		}
+
+		const FString Report{FString::Printf(TEXT("{\n\t\"seconds\": %.3f,\n\t\"channels\": %d,\n\t\"sample_rate\": %d,\n\t\"iterations\": %d,\n\t\"platform\": \"%s\",\n\t\"time_stretch_voices_per_core\": %.0f,\n\t\"cases\": [\n\t\t%s\n\t]\n}\n"),
+		                                     Settings.Duration, Settings.NumOfChannels, Settings.SampleRate, Settings.NumOfIterations, ANSI_TO_TCHAR(FPlatformProperties::IniPlatformName()), TimeStretchVoicesPerCore, *FString::Join(ResultsJson, TEXT(",\n\t\t")))};
+
+		if (!FFileHelper::SaveStringToFile(Report, *Settings.OutputFilePath))
+		{
+			UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Unable to save the benchmark report to '%s'"), *Settings.OutputFilePath);
+			return;
+		}
+
+		UE_LOG(LogRuntimeAudioImporter, Log, TEXT("The benchmark report has been saved to '%s'"), *Settings.OutputFilePath);
+	}
+}
+
+static FAutoConsoleCommand CmdRuntimeAudioImporterBenchmark(
+	TEXT("RuntimeAudioImporter.Benchmark"),
+	TEXT("Benchmark the audio transcoders and the time stretcher on a synthetic signal and save the results as JSON.\n")
+	TEXT("Seconds=<duration> Channels=<count> SampleRate=<rate> Iterations=<count>: the synthetic signal and the number of measured iterations\n")
+	TEXT("LargeSamples=<count>: number of samples of the large storage format conversion cases, 100 million by default. 0 to skip them\n")
+	TEXT("MP3File=<path> FlacFile=<path>: files to benchmark decoding of, as there are no MP3 and FLAC encoders\n")
+	TEXT("The time to the first sample and the resident memory are compared between mapping the files and reading them whole\n")
+	TEXT("Output=<path>: where to save the JSON report. Saved/RuntimeAudioImporter by default\n")
+	TEXT("The allocations are counted through the same tracking allocator as RuntimeAudioImporter.TrackImportAllocations, which stays installed until exit"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunBenchmark));
+
+#endif
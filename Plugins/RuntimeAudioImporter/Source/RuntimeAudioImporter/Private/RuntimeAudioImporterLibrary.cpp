@@ -5,15 +5,26 @@
 #include "RuntimeAudioImporterDefines.h"
 #include "RuntimeAudioImporterTypes.h"
 #include "PreImportedSoundAsset.h"
+#include "PCMDiskCache.h"
+#include "DecodedAudioCacheSubsystem.h"
+#include "AudioImportStatsCollector.h"
 
 #include "Transcoders/MP3Transcoder.h"
 #include "Transcoders/WAVTranscoder.h"
 #include "Transcoders/FlacTranscoder.h"
 #include "Transcoders/VorbisTranscoder.h"
 #include "Transcoders/RAWTranscoder.h"
+#include "Transcoders/ResamplingTranscoder.h"
+#include "Transcoders/ChunkedDecoder.h"
 
 #include "Misc/FileHelper.h"
+#include "HAL/PlatformFileManager.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/Event.h"
 #include "Async/Async.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Containers/Ticker.h"
 
 URuntimeAudioImporterLibrary* URuntimeAudioImporterLibrary::CreateRuntimeAudioImporter()
 {
@@ -31,6 +42,33 @@ bool LoadAudioFileToArray(TArray<uint8>& AudioData, const FString& FilePath)
 	// Removing unused two unitialized bytes
 	AudioData.RemoveAt(AudioData.Num() - 2, 2);
 
+	FAudioImportStatsCollector::AddCopiedBytes(AudioData.Num());
+
+	return true;
+}
+
+bool LoadAudioFileToBuffer(FRuntimeBulkDataBuffer<uint8>& AudioData, const FString& FilePath)
+{
+	// Mapping the file instead of reading it so that the audio data is paged in lazily while being decoded
+	TUniquePtr<IMappedFileHandle> MappedFileHandle{FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FilePath)};
+	if (MappedFileHandle.IsValid())
+	{
+		TUniquePtr<IMappedFileRegion> MappedFileRegion{MappedFileHandle->MapRegion()};
+		if (MappedFileRegion.IsValid())
+		{
+			AudioData = FRuntimeBulkDataBuffer<uint8>(MoveTemp(MappedFileHandle), MoveTemp(MappedFileRegion));
+			return true;
+		}
+	}
+
+	// Memory mapping is not supported by all platforms, so falling back to reading the whole file
+	TArray<uint8> AudioDataArray;
+	if (!LoadAudioFileToArray(AudioDataArray, FilePath))
+	{
+		return false;
+	}
+
+	AudioData = FRuntimeBulkDataBuffer<uint8>(MoveTemp(AudioDataArray));
 	return true;
 }
 
@@ -43,20 +81,447 @@ void URuntimeAudioImporterLibrary::ImportAudioFromFile(const FString& FilePath,
 		return;
 	}
 
+	TSharedPtr<FAudioImportStatsCollector, ESPMode::ThreadSafe> StatsCollector = MakeShared<FAudioImportStatsCollector, ESPMode::ThreadSafe>();
+
+	// Sound waves imported from the same file share the decoded audio data instead of decoding it again
+	FString CacheKey;
+	if (UDecodedAudioCacheSubsystem* DecodedAudioCache = UDecodedAudioCacheSubsystem::Get())
+	{
+		CacheKey = UDecodedAudioCacheSubsystem::MakeFileCacheKey(FilePath, PCMStorageFormat, TargetSampleRate);
+
+		FDecodedAudioStruct DecodedAudioInfo;
+		if (!CacheKey.IsEmpty() && DecodedAudioCache->Find(CacheKey, DecodedAudioInfo))
+		{
+			ImportAudioFromDecodedInfo(MoveTemp(DecodedAudioInfo), StatsCollector);
+			return;
+		}
+	}
+
 	// Getting the audio format
 	Format = Format == EAudioFormat::Auto ? GetAudioFormat(FilePath) : Format;
 	Format = Format == EAudioFormat::Invalid ? EAudioFormat::Auto : Format;
 
-	TArray<uint8> AudioBuffer;
+	FRuntimeBulkDataBuffer<uint8> AudioBuffer;
 
 	// Filling AudioBuffer with a binary file
-	if (!LoadAudioFileToArray(AudioBuffer, *FilePath))
 	{
-		OnResult_Internal(nullptr, ETranscodingStatus::LoadFileToArrayError);
+		FAudioImportStageScope StageScope(StatsCollector, EAudioImportStage::Read);
+
+		if (!LoadAudioFileToBuffer(AudioBuffer, *FilePath))
+		{
+			OnResult_Internal(nullptr, ETranscodingStatus::LoadFileToArrayError, StatsCollector);
+			return;
+		}
+	}
+
+	ImportAudioFromEncodedBuffer(MoveTemp(AudioBuffer), Format, CacheKey, StatsCollector);
+}
+
+TUniquePtr<FChunkedAudioDecoder> CreateChunkedDecoder(EAudioFormat AudioFormat, const uint8* AudioData, int64 AudioDataSize)
+{
+	switch (AudioFormat)
+	{
+	case EAudioFormat::Mp3:
+		{
+			return MP3Transcoder::CreateChunkedDecoder(AudioData, AudioDataSize);
+		}
+	case EAudioFormat::Wav:
+		{
+			return WAVTranscoder::CreateChunkedDecoder(AudioData, AudioDataSize);
+		}
+	case EAudioFormat::Flac:
+		{
+			return FlacTranscoder::CreateChunkedDecoder(AudioData, AudioDataSize);
+		}
+	case EAudioFormat::OggVorbis:
+		{
+			return VorbisTranscoder::CreateChunkedDecoder(AudioData, AudioDataSize);
+		}
+	default:
+		{
+			UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Undefined audio data format for decoding"));
+			return nullptr;
+		}
+	}
+}
+
+void URuntimeAudioImporterLibrary::ImportAudioFromFileStreamed(const FString& FilePath, EAudioFormat Format, int32 NumOfFramesPerChunk)
+{
+	// Checking if the file exists
+	if (!FPaths::FileExists(FilePath))
+	{
+		OnResult_Internal(nullptr, ETranscodingStatus::AudioDoesNotExist);
+		return;
+	}
+
+	TSharedPtr<FAudioImportStatsCollector, ESPMode::ThreadSafe> StatsCollector = MakeShared<FAudioImportStatsCollector, ESPMode::ThreadSafe>();
+
+	// Getting the audio format
+	Format = Format == EAudioFormat::Auto ? GetAudioFormat(FilePath) : Format;
+	Format = Format == EAudioFormat::Invalid ? EAudioFormat::Auto : Format;
+
+	FRuntimeBulkDataBuffer<uint8> AudioBuffer;
+
+	// Filling AudioBuffer with a binary file
+	{
+		FAudioImportStageScope StageScope(StatsCollector, EAudioImportStage::Read);
+
+		if (!LoadAudioFileToBuffer(AudioBuffer, *FilePath))
+		{
+			OnResult_Internal(nullptr, ETranscodingStatus::LoadFileToArrayError, StatsCollector);
+			return;
+		}
+	}
+
+	ImportAudioFromEncodedBufferStreamed(MoveTemp(AudioBuffer), Format, NumOfFramesPerChunk, StatsCollector);
+}
+
+/** Shared state of the batch import */
+struct FBatchImportState
+{
+	FBatchImportState(const TArray<FString>& FilePaths, EPCMStorageFormat PCMStorageFormat, int32 TargetSampleRate, int64 MaxBytesInFlight, const TSharedRef<FAudioImportCancellationToken, ESPMode::ThreadSafe>& CancellationToken)
+		: FilePaths(FilePaths)
+	  , PCMStorageFormat(PCMStorageFormat)
+	  , TargetSampleRate(TargetSampleRate)
+	  , CancellationToken(CancellationToken)
+	  , MaxBytesInFlight(MaxBytesInFlight)
+	{
+		FilePercentages.SetNumZeroed(FilePaths.Num());
+		PendingFilePercentages.SetNumZeroed(FilePaths.Num());
+	}
+
+	/**
+	 * Reserve the amount of decoded audio data the file is about to hold, waiting until it fits into the budget
+	 *
+	 * @param NumOfBytes Estimated size of the decoded audio data
+	 * @return False if the batch import was cancelled while waiting, in which case nothing is reserved
+	 */
+	bool AcquireBudget(int64 NumOfBytes)
+	{
+		while (!CancellationToken->IsCancelled())
+		{
+			{
+				FScopeLock Lock(&BudgetGuard);
+
+				// A file exceeding the whole budget on its own is still decoded once nothing else is in flight, otherwise it would never be imported
+				if (BytesInFlight == 0 || BytesInFlight + NumOfBytes <= MaxBytesInFlight)
+				{
+					BytesInFlight += NumOfBytes;
+					return true;
+				}
+
+				// Reset under the lock, so that any release after the check wakes the worker up
+				BudgetReleasedEvent->Reset();
+			}
+
+			// The timeout bounds how late the cancellation is noticed, as well as a wake-up missed because another waiting worker has reset the event in the meantime
+			BudgetReleasedEvent->Wait(BudgetWaitTimeoutMs);
+		}
+
+		return false;
+	}
+
+	/**
+	 * Release the amount of decoded audio data reserved by AcquireBudget
+	 *
+	 * @param NumOfBytes Estimated size of the decoded audio data
+	 */
+	void ReleaseBudget(int64 NumOfBytes)
+	{
+		{
+			FScopeLock Lock(&BudgetGuard);
+			BytesInFlight -= NumOfBytes;
+		}
+
+		BudgetReleasedEvent->Trigger();
+	}
+
+	/** Paths to the audio files to import */
+	const TArray<FString> FilePaths;
+
+	/** Import settings captured when the batch import started, since the workers must not read them from the importer while they may be changed */
+	const EPCMStorageFormat PCMStorageFormat;
+	const int32 TargetSampleRate;
+
+	/** Token for cancelling the whole batch import */
+	const TSharedRef<FAudioImportCancellationToken, ESPMode::ThreadSafe> CancellationToken;
+
+	/** Index of the next file to be picked up by a worker */
+	TAtomic<int32> NextFileIndex{0};
+
+	/** Import progress of each file, as last broadcast. Accessed only from the game thread */
+	TArray<int32> FilePercentages;
+
+	/** The latest import progress of each file, not broadcast yet. Written atomically by the workers */
+	TArray<int32> PendingFilePercentages;
+
+	/** Whether a broadcast of the pending progress is scheduled */
+	TAtomic<bool> bProgressBroadcastPending{false};
+
+	/** Number of files whose import is complete. Accessed only from the game thread */
+	int32 NumOfFinishedFiles{0};
+
+private:
+	/** The maximum amount of decoded audio data held at the same time */
+	const int64 MaxBytesInFlight;
+
+	/** The amount of decoded audio data currently held */
+	int64 BytesInFlight{0};
+
+	/** Guards BytesInFlight */
+	FCriticalSection BudgetGuard;
+
+	/** Triggered whenever the budget is released, waking up the workers waiting for it */
+	FEventRef BudgetReleasedEvent{EEventMode::ManualReset};
+
+	/** The longest a worker waits for the budget before checking for the cancellation again, in milliseconds */
+	static constexpr uint32 BudgetWaitTimeoutMs{100};
+};
+
+void URuntimeAudioImporterLibrary::ImportAudioFromFiles(const TArray<FString>& FilePaths, int32 NumOfWorkers, int32 MaxDecodedMegabytesInFlight)
+{
+	// An empty batch is complete right away, which is still reported so that the completion handlers run
+	if (FilePaths.Num() == 0)
+	{
+		UE_LOG(LogRuntimeAudioImporter, Warning, TEXT("The batch of audio files to import is empty"));
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis = MakeWeakObjectPtr(this)]()
+		{
+			if (!WeakThis.IsValid())
+			{
+				return;
+			}
+
+			FBatchImportProgress Progress;
+			{
+				Progress.bFinished = true;
+				Progress.TotalPercentage = 100;
+			}
+
+			if (WeakThis->OnBatchProgressNative.IsBound())
+			{
+				WeakThis->OnBatchProgressNative.Broadcast(WeakThis.Get(), Progress);
+			}
+
+			if (WeakThis->OnBatchProgress.IsBound())
+			{
+				WeakThis->OnBatchProgress.Broadcast(WeakThis.Get(), Progress);
+			}
+		});
+
 		return;
 	}
 
-	ImportAudioFromBuffer(MoveTemp(AudioBuffer), Format);
+	// The workers block while waiting for the budget, so there are never more of them than there are task graph threads to run them
+	NumOfWorkers = FMath::Clamp(NumOfWorkers, 1, FMath::Min(FilePaths.Num(), FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads(), 1)));
+
+	const TSharedRef<FBatchImportState, ESPMode::ThreadSafe> State = MakeShared<FBatchImportState, ESPMode::ThreadSafe>(FilePaths, PCMStorageFormat, TargetSampleRate, FMath::Max<int64>(MaxDecodedMegabytesInFlight, 1) * 1024 * 1024, GetCancellationToken());
+
+	UE_LOG(LogRuntimeAudioImporter, Log, TEXT("Importing a batch of '%d' audio files using '%d' workers"), FilePaths.Num(), NumOfWorkers);
+
+	// The files are shared out through a single atomic index: each worker keeps picking up the next file not yet taken by any other worker, so that the workers finishing early take over the remaining files
+	for (int32 WorkerIndex = 0; WorkerIndex < NumOfWorkers; ++WorkerIndex)
+	{
+		AsyncTask(ENamedThreads::AnyBackgroundHiPriTask, [WeakThis = MakeWeakObjectPtr(this), State]()
+		{
+			while (WeakThis.IsValid())
+			{
+				const int32 FileIndex{State->NextFileIndex++};
+
+				if (FileIndex >= State->FilePaths.Num())
+				{
+					break;
+				}
+
+				// The remaining files are still reported so that the batch completes
+				if (State->CancellationToken->IsCancelled())
+				{
+					OnBatchProgress_Internal(WeakThis, State, FileIndex, 100, nullptr, ETranscodingStatus::Cancelled, true);
+					continue;
+				}
+
+				ImportFileFromBatch(WeakThis, State, FileIndex);
+			}
+		});
+	}
+}
+
+void URuntimeAudioImporterLibrary::ImportFileFromBatch(const TWeakObjectPtr<URuntimeAudioImporterLibrary>& WeakThis, const TSharedRef<FBatchImportState, ESPMode::ThreadSafe>& State, int32 FileIndex)
+{
+	// Decoded size is estimated with this ratio for the formats whose length cannot be determined without decoding
+	constexpr int64 UnknownLengthCompressionRatio{8};
+	constexpr uint32 NumOfFramesPerChunk{65536};
+
+	const FString& FilePath{State->FilePaths[FileIndex]};
+
+	if (!FPaths::FileExists(FilePath))
+	{
+		OnBatchProgress_Internal(WeakThis, State, FileIndex, 100, nullptr, ETranscodingStatus::AudioDoesNotExist, true);
+		return;
+	}
+
+	FRuntimeBulkDataBuffer<uint8> AudioData;
+
+	if (!LoadAudioFileToBuffer(AudioData, FilePath))
+	{
+		OnBatchProgress_Internal(WeakThis, State, FileIndex, 100, nullptr, ETranscodingStatus::LoadFileToArrayError, true);
+		return;
+	}
+
+	EAudioFormat AudioFormat{GetAudioFormat(FilePath)};
+	AudioFormat = AudioFormat == EAudioFormat::Invalid ? EAudioFormat::Auto : AudioFormat;
+
+	if (AudioFormat == EAudioFormat::Wav && !WAVTranscoder::CheckAndFixWavDurationErrors(AudioData))
+	{
+		OnBatchProgress_Internal(WeakThis, State, FileIndex, 100, nullptr, ETranscodingStatus::FailedToReadAudioDataArray, true);
+		return;
+	}
+
+	if (AudioFormat == EAudioFormat::Auto)
+	{
+		AudioFormat = GetAudioFormat(AudioData.GetView().GetData(), AudioData.GetView().Num());
+	}
+
+	if (AudioFormat == EAudioFormat::Invalid)
+	{
+		UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Undefined audio data format for import of '%s'"), *FilePath);
+		OnBatchProgress_Internal(WeakThis, State, FileIndex, 100, nullptr, ETranscodingStatus::InvalidAudioFormat, true);
+		return;
+	}
+
+	TUniquePtr<FChunkedAudioDecoder> Decoder{CreateChunkedDecoder(AudioFormat, AudioData.GetView().GetData(), AudioData.GetView().Num())};
+
+	if (!Decoder.IsValid())
+	{
+		OnBatchProgress_Internal(WeakThis, State, FileIndex, 100, nullptr, ETranscodingStatus::FailedToReadAudioDataArray, true);
+		return;
+	}
+
+	OnBatchProgress_Internal(WeakThis, State, FileIndex, 5, nullptr, ETranscodingStatus::SuccessfulImport, false);
+
+	const uint64 NumOfFrames{Decoder->GetNumOfFrames()};
+	const bool bLengthKnown{NumOfFrames > 0 && NumOfFrames <= TNumericLimits<uint32>::Max()};
+	const uint32 NumOfChannels{Decoder->GetSoundWaveBasicInfo().NumOfChannels};
+
+	FDecodedAudioStruct DecodedAudioInfo;
+	DecodedAudioInfo.PCMInfo.StorageFormat = State->PCMStorageFormat;
+
+	const int64 SampleSize{DecodedAudioInfo.PCMInfo.GetSampleSize()};
+	const int64 EstimatedPCMDataSize{bLengthKnown ? static_cast<int64>(NumOfFrames) * NumOfChannels * SampleSize : AudioData.GetView().Num() * UnknownLengthCompressionRatio};
+
+	if (!State->AcquireBudget(EstimatedPCMDataSize))
+	{
+		OnBatchProgress_Internal(WeakThis, State, FileIndex, 100, nullptr, ETranscodingStatus::Cancelled, true);
+		return;
+	}
+
+	// The audio data decoded as a whole can be loaded from the decoded PCM disk cache instead
+	if (bLengthKnown && !(PCMDiskCache::IsEnabled() && AudioFormat != EAudioFormat::Wav))
+	{
+		uint8* PCMData = static_cast<uint8*>(FMemory::Malloc(EstimatedPCMDataSize));
+
+		uint32 NumOfDecodedFrames{0};
+		int32 LastPercentage{5};
+
+		// Decoding in chunks to be able to report the progress of the file and to stop as soon as the cancellation is requested or the importer is destroyed
+		while (NumOfDecodedFrames < NumOfFrames && !State->CancellationToken->IsCancelled() && WeakThis.IsValid())
+		{
+			const uint32 NumOfChunkFrames{Decoder->ReadFramesInFormat(PCMData + static_cast<int64>(NumOfDecodedFrames) * NumOfChannels * SampleSize, FMath::Min<uint32>(NumOfFramesPerChunk, NumOfFrames - NumOfDecodedFrames), State->PCMStorageFormat)};
+
+			if (NumOfChunkFrames == 0)
+			{
+				break;
+			}
+
+			NumOfDecodedFrames += NumOfChunkFrames;
+
+			const int32 Percentage{5 + static_cast<int32>(static_cast<uint64>(NumOfDecodedFrames) * 90 / NumOfFrames)};
+			if (Percentage != LastPercentage)
+			{
+				LastPercentage = Percentage;
+				OnBatchProgress_Internal(WeakThis, State, FileIndex, Percentage, nullptr, ETranscodingStatus::SuccessfulImport, false);
+			}
+		}
+
+		if (NumOfDecodedFrames == 0 || State->CancellationToken->IsCancelled() || !WeakThis.IsValid())
+		{
+			FMemory::Free(PCMData);
+			State->ReleaseBudget(EstimatedPCMDataSize);
+			OnBatchProgress_Internal(WeakThis, State, FileIndex, 100, nullptr, State->CancellationToken->IsCancelled() ? ETranscodingStatus::Cancelled : ETranscodingStatus::FailedToReadAudioDataArray, true);
+			return;
+		}
+
+		DecodedAudioInfo.SoundWaveBasicInfo = Decoder->GetSoundWaveBasicInfo();
+		DecodedAudioInfo.PCMInfo.PCMData = FRuntimeBulkDataBuffer<uint8>(PCMData, static_cast<int64>(NumOfDecodedFrames) * NumOfChannels * SampleSize);
+		DecodedAudioInfo.PCMInfo.PCMNumOfFrames = NumOfDecodedFrames;
+
+		// The decoder may produce fewer frames than it reported, so the duration is taken from the frames actually decoded
+		DecodedAudioInfo.SoundWaveBasicInfo.Duration = static_cast<float>(NumOfDecodedFrames) / DecodedAudioInfo.SoundWaveBasicInfo.SampleRate;
+	}
+	else
+	{
+		Decoder.Reset();
+
+		FEncodedAudioStruct EncodedAudioInfo(MoveTemp(AudioData), AudioFormat);
+
+		FAudioDecodingProgress DecodingProgress;
+		DecodingProgress.OnPercentageChanged = [WeakThis, &State, FileIndex](int32 Percentage)
+		{
+			if (WeakThis.IsValid())
+			{
+				OnBatchProgress_Internal(WeakThis, State, FileIndex, 5 + Percentage * 90 / 100, nullptr, ETranscodingStatus::SuccessfulImport, false);
+			}
+		};
+
+		// The importer may have been destroyed while decoding
+		if (!DecodeAudioData(EncodedAudioInfo, DecodedAudioInfo, &State->CancellationToken.Get(), &DecodingProgress) || !WeakThis.IsValid())
+		{
+			State->ReleaseBudget(EstimatedPCMDataSize);
+			OnBatchProgress_Internal(WeakThis, State, FileIndex, 100, nullptr, State->CancellationToken->IsCancelled() ? ETranscodingStatus::Cancelled : ETranscodingStatus::FailedToReadAudioDataArray, true);
+			return;
+		}
+	}
+
+	Decoder.Reset();
+	AudioData.Empty();
+
+	if (State->TargetSampleRate > 0 && !ResamplingTranscoder::ResampleDecodedAudio(DecodedAudioInfo, State->TargetSampleRate))
+	{
+		State->ReleaseBudget(EstimatedPCMDataSize);
+		OnBatchProgress_Internal(WeakThis, State, FileIndex, 100, nullptr, ETranscodingStatus::FailedToReadAudioDataArray, true);
+		return;
+	}
+
+	AsyncTask(ENamedThreads::GameThread, [WeakThis, State, FileIndex, EstimatedPCMDataSize, DecodedAudioInfo = MoveTemp(DecodedAudioInfo)]() mutable
+	{
+		// The decoded audio data is either moved to the sound wave or released below, so it no longer counts against the budget
+		State->ReleaseBudget(EstimatedPCMDataSize);
+
+		if (!WeakThis.IsValid())
+		{
+			return;
+		}
+
+		if (State->CancellationToken->IsCancelled())
+		{
+			OnBatchProgress_Internal(WeakThis, State, FileIndex, 100, nullptr, ETranscodingStatus::Cancelled, true);
+			return;
+		}
+
+		UImportedSoundWave* SoundWaveRef = WeakThis->CreateImportedSoundWave();
+
+		if (SoundWaveRef == nullptr)
+		{
+			UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Something went wrong while creating the imported sound wave"));
+			OnBatchProgress_Internal(WeakThis, State, FileIndex, 100, nullptr, ETranscodingStatus::SoundWaveDeclarationError, true);
+			return;
+		}
+
+		FillSoundWaveBasicInfo(SoundWaveRef, DecodedAudioInfo);
+		FillPCMData(SoundWaveRef, MoveTemp(DecodedAudioInfo));
+
+		OnBatchProgress_Internal(WeakThis, State, FileIndex, 100, SoundWaveRef, ETranscodingStatus::SuccessfulImport, true);
+	});
 }
 
 void URuntimeAudioImporterLibrary::ImportAudioFromRAWFile(const FString& FilePath, ERAWAudioFormat Format, int32 SampleRate, int32 NumOfChannels)
@@ -78,9 +543,12 @@ void URuntimeAudioImporterLibrary::ImportAudioFromRAWFile(const FString& FilePat
 
 	OnProgress_Internal(35);
 
-	AsyncTask(ENamedThreads::AnyBackgroundHiPriTask, [this, AudioBuffer = MoveTemp(AudioBuffer), Format, SampleRate, NumOfChannels]()
+	AsyncTask(ENamedThreads::AnyBackgroundHiPriTask, [WeakThis = MakeWeakObjectPtr(this), AudioBuffer = MoveTemp(AudioBuffer), Format, SampleRate, NumOfChannels]()
 	{
-		ImportAudioFromRAWBuffer(AudioBuffer, Format, SampleRate, NumOfChannels);
+		if (WeakThis.IsValid())
+		{
+			WeakThis->ImportAudioFromRAWBuffer(AudioBuffer, Format, SampleRate, NumOfChannels);
+		}
 	});
 }
 
@@ -131,129 +599,650 @@ void URuntimeAudioImporterLibrary::ImportAudioFromRAWBuffer(TArray<uint8> RAWBuf
 
 void URuntimeAudioImporterLibrary::ImportAudioFromPreImportedSound(UPreImportedSoundAsset* PreImportedSoundAssetRef)
 {
-	ImportAudioFromBuffer(PreImportedSoundAssetRef->AudioDataArray, PreImportedSoundAssetRef->AudioFormat);
+	if (!PreImportedSoundAssetRef->HasDecodedPCMData())
+	{
+		ImportAudioFromBuffer(PreImportedSoundAssetRef->AudioDataArray, PreImportedSoundAssetRef->AudioFormat);
+		return;
+	}
+
+	OnProgress_Internal(5);
+
+	TSharedPtr<FAudioImportStatsCollector, ESPMode::ThreadSafe> StatsCollector = MakeShared<FAudioImportStatsCollector, ESPMode::ThreadSafe>();
+
+	// The stored PCM data is shared with the sound wave without being decoded or copied
+	PreImportedSoundAssetRef->LoadDecodedAudioData([WeakThis = MakeWeakObjectPtr(this), WeakPreImportedSoundAsset = MakeWeakObjectPtr(PreImportedSoundAssetRef), CancellationToken = GetCancellationToken(), StatsCollector](bool bSucceeded, FDecodedAudioStruct&& DecodedAudioInfo)
+	{
+		if (!WeakThis.IsValid())
+		{
+			return;
+		}
+
+		if (CancellationToken->IsCancelled())
+		{
+			WeakThis->OnResult_Internal(nullptr, ETranscodingStatus::Cancelled, StatsCollector);
+			return;
+		}
+
+		if (!bSucceeded)
+		{
+			if (!WeakPreImportedSoundAsset.IsValid())
+			{
+				WeakThis->OnResult_Internal(nullptr, ETranscodingStatus::FailedToReadAudioDataArray, StatsCollector);
+				return;
+			}
+
+			UE_LOG(LogRuntimeAudioImporter, Warning, TEXT("Falling back to decoding the audio data of the pre-imported sound asset '%s'"), *WeakPreImportedSoundAsset->GetName());
+			WeakThis->ImportAudioFromEncodedBuffer(FRuntimeBulkDataBuffer<uint8>(TArray<uint8>(WeakPreImportedSoundAsset->AudioDataArray)), WeakPreImportedSoundAsset->AudioFormat, FString(), StatsCollector);
+			return;
+		}
+
+		if (DecodedAudioInfo.PCMInfo.StorageFormat == WeakThis->PCMStorageFormat && (WeakThis->TargetSampleRate <= 0 || static_cast<uint32>(WeakThis->TargetSampleRate) == DecodedAudioInfo.SoundWaveBasicInfo.SampleRate))
+		{
+			WeakThis->ImportAudioFromDecodedInfo(MoveTemp(DecodedAudioInfo), StatsCollector);
+			return;
+		}
+
+		// The stored PCM data does not match the requested storage format or sample rate, so it is converted in the background
+		AsyncTask(ENamedThreads::AnyBackgroundHiPriTask, [WeakThis, CancellationToken, StorageFormat = WeakThis->PCMStorageFormat, TargetSampleRate = WeakThis->TargetSampleRate, DecodedAudioInfo = MoveTemp(DecodedAudioInfo), StatsCollector]() mutable
+		{
+			{
+				FAudioImportStageScope StageScope(StatsCollector, EAudioImportStage::Convert);
+
+				RAWTranscoder::ConvertPCMStorageFormat(DecodedAudioInfo.PCMInfo, StorageFormat);
+
+				if (TargetSampleRate > 0 && !ResamplingTranscoder::ResampleDecodedAudio(DecodedAudioInfo, TargetSampleRate))
+				{
+					if (WeakThis.IsValid())
+					{
+						WeakThis->OnResult_Internal(nullptr, ETranscodingStatus::FailedToReadAudioDataArray, StatsCollector);
+					}
+					return;
+				}
+			}
+
+			AsyncTask(ENamedThreads::GameThread, [WeakThis, CancellationToken, DecodedAudioInfo = MoveTemp(DecodedAudioInfo), StatsCollector]() mutable
+			{
+				if (!WeakThis.IsValid())
+				{
+					return;
+				}
+
+				if (CancellationToken->IsCancelled())
+				{
+					WeakThis->OnResult_Internal(nullptr, ETranscodingStatus::Cancelled, StatsCollector);
+					return;
+				}
+
+				WeakThis->ImportAudioFromDecodedInfo(MoveTemp(DecodedAudioInfo), StatsCollector);
+			});
+		});
+	});
 }
 
 void URuntimeAudioImporterLibrary::ImportAudioFromBuffer(TArray<uint8> AudioData, EAudioFormat AudioFormat)
 {
+	ImportAudioFromEncodedBuffer(FRuntimeBulkDataBuffer<uint8>(MoveTemp(AudioData)), AudioFormat);
+}
+
+void URuntimeAudioImporterLibrary::ImportAudioFromEncodedBuffer(FRuntimeBulkDataBuffer<uint8>&& AudioData, EAudioFormat AudioFormat, const FString& CacheKey, TSharedPtr<FAudioImportStatsCollector, ESPMode::ThreadSafe> StatsCollector)
+{
+	if (!StatsCollector.IsValid())
+	{
+		StatsCollector = MakeShared<FAudioImportStatsCollector, ESPMode::ThreadSafe>();
+	}
+
+	{
+		FAudioImportStageScope StageScope(StatsCollector, EAudioImportStage::Copy);
+
+		if (AudioFormat == EAudioFormat::Wav)
+		{
+			const uint8* OriginalAudioData{AudioData.GetView().GetData()};
+
+			if (!WAVTranscoder::CheckAndFixWavDurationErrors(AudioData)) return;
+
+			// Read-only audio data is copied to be fixed
+			if (AudioData.GetView().GetData() != OriginalAudioData)
+			{
+				FAudioImportStatsCollector::AddCopiedBytes(AudioData.GetView().Num());
+			}
+		}
+
+		if (AudioFormat == EAudioFormat::Auto)
+		{
+			AudioFormat = GetAudioFormat(AudioData.GetView().GetData(), AudioData.GetView().Num());
+		}
+	}
+
+	AsyncTask(ENamedThreads::AnyBackgroundHiPriTask, [WeakThis = MakeWeakObjectPtr(this), CancellationToken = GetCancellationToken(), StorageFormat = PCMStorageFormat, TargetSampleRate = TargetSampleRate, AudioData = MoveTemp(AudioData), AudioFormat, CacheKey, StatsCollector]() mutable
+	{
+		if (!WeakThis.IsValid())
+		{
+			return;
+		}
+
+		if (CancellationToken->IsCancelled())
+		{
+			WeakThis->OnResult_Internal(nullptr, ETranscodingStatus::Cancelled, StatsCollector);
+			return;
+		}
+
+		WeakThis->OnProgress_Internal(5);
+
+		if (AudioFormat == EAudioFormat::Invalid)
+		{
+			UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Undefined audio data format for import"));
+			WeakThis->OnResult_Internal(nullptr, ETranscodingStatus::InvalidAudioFormat, StatsCollector);
+			return;
+		}
+
+		// The audio data is decoded in place, without being copied
+		FEncodedAudioStruct EncodedAudioInfo(MoveTemp(AudioData), AudioFormat);
+
+		FDecodedAudioStruct DecodedAudioInfo;
+		DecodedAudioInfo.PCMInfo.StorageFormat = StorageFormat;
+
+		// Decoding takes the most of the import time, so it covers the most of the progress
+		FAudioDecodingProgress DecodingProgress;
+		DecodingProgress.OnPercentageChanged = [WeakThis](int32 Percentage)
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->OnProgress_Internal(5 + Percentage * 90 / 100);
+			}
+		};
+
+		bool bDecoded;
+		{
+			FAudioImportStageScope StageScope(StatsCollector, EAudioImportStage::Decode);
+			bDecoded = DecodeAudioData(EncodedAudioInfo, DecodedAudioInfo, &CancellationToken.Get(), &DecodingProgress);
+		}
+
+		// The importer may have been destroyed while decoding
+		if (!WeakThis.IsValid())
+		{
+			return;
+		}
+
+		if (!bDecoded)
+		{
+			WeakThis->OnResult_Internal(nullptr, CancellationToken->IsCancelled() ? ETranscodingStatus::Cancelled : ETranscodingStatus::FailedToReadAudioDataArray, StatsCollector);
+			return;
+		}
+
+		if (TargetSampleRate > 0)
+		{
+			FAudioImportStageScope StageScope(StatsCollector, EAudioImportStage::Convert);
+
+			const uint32 SourceSampleRate{DecodedAudioInfo.SoundWaveBasicInfo.SampleRate};
+
+			if (!ResamplingTranscoder::ResampleDecodedAudio(DecodedAudioInfo, TargetSampleRate))
+			{
+				WeakThis->OnResult_Internal(nullptr, ETranscodingStatus::FailedToReadAudioDataArray, StatsCollector);
+				return;
+			}
+
+			if (DecodedAudioInfo.SoundWaveBasicInfo.SampleRate != SourceSampleRate)
+			{
+				FAudioImportStatsCollector::AddCopiedBytes(DecodedAudioInfo.PCMInfo.PCMData.GetView().Num());
+			}
+		}
+
+		// The sound wave shares the decoded audio data with the cache afterwards
+		UDecodedAudioCacheSubsystem* DecodedAudioCache = UDecodedAudioCacheSubsystem::Get();
+		if (DecodedAudioCache != nullptr && !CacheKey.IsEmpty())
+		{
+			DecodedAudioCache->Add(CacheKey, DecodedAudioInfo);
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, CancellationToken, DecodedAudioInfo = MoveTemp(DecodedAudioInfo), StatsCollector]() mutable
+		{
+			if (!WeakThis.IsValid())
+			{
+				return;
+			}
+
+			if (CancellationToken->IsCancelled())
+			{
+				WeakThis->OnResult_Internal(nullptr, ETranscodingStatus::Cancelled, StatsCollector);
+				return;
+			}
+
+			WeakThis->ImportAudioFromDecodedInfo(MoveTemp(DecodedAudioInfo), StatsCollector);
+		});
+	});
+}
+
+void URuntimeAudioImporterLibrary::ImportAudioFromBufferStreamed(TArray<uint8> AudioData, EAudioFormat AudioFormat, int32 NumOfFramesPerChunk)
+{
+	ImportAudioFromEncodedBufferStreamed(FRuntimeBulkDataBuffer<uint8>(MoveTemp(AudioData)), AudioFormat, NumOfFramesPerChunk);
+}
+
+void URuntimeAudioImporterLibrary::ImportAudioFromEncodedBufferStreamed(FRuntimeBulkDataBuffer<uint8>&& AudioData, EAudioFormat AudioFormat, int32 NumOfFramesPerChunk, TSharedPtr<FAudioImportStatsCollector, ESPMode::ThreadSafe> StatsCollector)
+{
+	if (!StatsCollector.IsValid())
+	{
+		StatsCollector = MakeShared<FAudioImportStatsCollector, ESPMode::ThreadSafe>();
+	}
+
+	if (NumOfFramesPerChunk <= 0)
+	{
+		UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Unable to import audio in streaming mode with '%d' frames per chunk"), NumOfFramesPerChunk);
+		OnResult_Internal(nullptr, ETranscodingStatus::FailedToReadAudioDataArray, StatsCollector);
+		return;
+	}
+
 	if (AudioFormat == EAudioFormat::Wav && !WAVTranscoder::CheckAndFixWavDurationErrors(AudioData)) return;
 
 	if (AudioFormat == EAudioFormat::Auto)
 	{
-		AudioFormat = GetAudioFormat(AudioData.GetData(), AudioData.Num());
+		AudioFormat = GetAudioFormat(AudioData.GetView().GetData(), AudioData.GetView().Num());
 	}
 
-	AsyncTask(ENamedThreads::AnyBackgroundHiPriTask, [this, AudioData = MoveTemp(AudioData), AudioFormat]()
+	AsyncTask(ENamedThreads::AnyBackgroundHiPriTask, [WeakThis = MakeWeakObjectPtr(this), CancellationToken = GetCancellationToken(), StorageFormat = PCMStorageFormat, AudioData = MoveTemp(AudioData), AudioFormat, NumOfFramesPerChunk, StatsCollector]() mutable
 	{
-		OnProgress_Internal(5);
+		if (!WeakThis.IsValid())
+		{
+			return;
+		}
+
+		if (CancellationToken->IsCancelled())
+		{
+			WeakThis->OnResult_Internal(nullptr, ETranscodingStatus::Cancelled, StatsCollector);
+			return;
+		}
+
+		WeakThis->OnProgress_Internal(5);
 
 		if (AudioFormat == EAudioFormat::Invalid)
 		{
 			UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Undefined audio data format for import"));
-			OnResult_Internal(nullptr, ETranscodingStatus::InvalidAudioFormat);
+			WeakThis->OnResult_Internal(nullptr, ETranscodingStatus::InvalidAudioFormat, StatsCollector);
+			return;
+		}
+
+		// Decoding the first chunk is accounted for, while the chunks decoded in the background after the result are not
+		TOptional<FAudioImportStageScope> DecodeStageScope;
+		DecodeStageScope.Emplace(StatsCollector, EAudioImportStage::Decode);
+
+		// The decoder reads directly from the audio data, which is kept alive until the decoding is finished
+		TUniquePtr<FChunkedAudioDecoder> Decoder{CreateChunkedDecoder(AudioFormat, AudioData.GetView().GetData(), AudioData.GetView().Num())};
+
+		if (!Decoder.IsValid())
+		{
+			WeakThis->OnResult_Internal(nullptr, ETranscodingStatus::FailedToReadAudioDataArray, StatsCollector);
 			return;
 		}
 
-		uint8* EncodedAudioDataPtr = static_cast<uint8*>(FMemory::Memcpy(FMemory::Malloc(AudioData.Num()), AudioData.GetData(), AudioData.Num()));
+		const FSoundWaveBasicStruct SoundWaveBasicInfo{Decoder->GetSoundWaveBasicInfo()};
+		const uint64 NumOfFrames{Decoder->GetNumOfFrames()};
+
+		// The whole PCM buffer is allocated up front, which is not possible if the length of the audio data is unknown
+		if (NumOfFrames == 0 || NumOfFrames > TNumericLimits<uint32>::Max())
+		{
+			UE_LOG(LogRuntimeAudioImporter, Warning, TEXT("Unable to determine the length of the audio data for streaming import. Falling back to regular import"));
+
+			Decoder.Reset();
+			DecodeStageScope.Reset();
+			WeakThis->ImportAudioFromEncodedBuffer(MoveTemp(AudioData), AudioFormat, FString(), StatsCollector);
+			return;
+		}
+
+		FDecodedAudioStruct DecodedAudioInfo;
+		DecodedAudioInfo.PCMInfo.StorageFormat = StorageFormat;
+
+		const int64 PCMDataSize{static_cast<int64>(NumOfFrames) * SoundWaveBasicInfo.NumOfChannels * DecodedAudioInfo.PCMInfo.GetSampleSize()};
+		uint8* PCMData = static_cast<uint8*>(FMemory::Malloc(PCMDataSize));
+
+		// Decoding only the first chunk so that playback can start as soon as possible
+		const uint32 NumOfFirstChunkFrames{Decoder->ReadFramesInFormat(PCMData, FMath::Min<uint64>(NumOfFramesPerChunk, NumOfFrames), StorageFormat)};
+
+		if (!WeakThis.IsValid() || CancellationToken->IsCancelled() || NumOfFirstChunkFrames == 0)
+		{
+			FMemory::Free(PCMData);
+
+			if (WeakThis.IsValid())
+			{
+				if (NumOfFirstChunkFrames == 0)
+				{
+					UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Something went wrong while decoding the first chunk of the audio data"));
+				}
+
+				WeakThis->OnResult_Internal(nullptr, CancellationToken->IsCancelled() ? ETranscodingStatus::Cancelled : ETranscodingStatus::FailedToReadAudioDataArray, StatsCollector);
+			}
+			return;
+		}
+
+		DecodeStageScope.Reset();
+
+		{
+			DecodedAudioInfo.SoundWaveBasicInfo = SoundWaveBasicInfo;
+			DecodedAudioInfo.PCMInfo.PCMData = FRuntimeBulkDataBuffer<uint8>(PCMData, PCMDataSize);
+			DecodedAudioInfo.PCMInfo.PCMNumOfFrames = static_cast<uint32>(NumOfFrames);
+		}
+
+		WeakThis->OnProgress_Internal(10);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, CancellationToken, AudioData = MoveTemp(AudioData), AudioFormat, Decoder = MoveTemp(Decoder), DecodedAudioInfo = MoveTemp(DecodedAudioInfo), NumOfFirstChunkFrames, NumOfFramesPerChunk, StatsCollector]() mutable
+		{
+			if (!WeakThis.IsValid())
+			{
+				return;
+			}
+
+			if (CancellationToken->IsCancelled())
+			{
+				WeakThis->OnResult_Internal(nullptr, ETranscodingStatus::Cancelled, StatsCollector);
+				return;
+			}
+
+			UImportedSoundWave* SoundWaveRef;
+
+			{
+				FAudioImportStageScope StageScope(StatsCollector, EAudioImportStage::Attach);
+
+				SoundWaveRef = WeakThis->CreateImportedSoundWave();
+
+				if (SoundWaveRef == nullptr)
+				{
+					UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Something went wrong while creating the imported sound wave"));
+					WeakThis->OnResult_Internal(nullptr, ETranscodingStatus::SoundWaveDeclarationError, StatsCollector);
+					return;
+				}
 
-		FEncodedAudioStruct EncodedAudioInfo(EncodedAudioDataPtr, AudioData.Num(), AudioFormat);
+				FillSoundWaveBasicInfo(SoundWaveRef, DecodedAudioInfo);
 
-		OnProgress_Internal(10);
+				// Moving PCM data instead of copying it, since the decoder keeps writing the remaining chunks directly into the sound wave's buffer
+				FillPCMData(SoundWaveRef, MoveTemp(DecodedAudioInfo));
+				SoundWaveRef->NumOfDecodedFrames = NumOfFirstChunkFrames;
+			}
 
-		FDecodedAudioStruct DecodedAudioInfo;
-		if (!DecodeAudioData(EncodedAudioInfo, DecodedAudioInfo))
-		{
-			OnResult_Internal(nullptr, ETranscodingStatus::FailedToReadAudioDataArray);
-			return;
-		}
+			// The decoder keeps writing into the PCM data the sound wave was created with, even once the sound wave stops playing it (e.g. after switching to a queued sound wave). Sharing it keeps it alive until the decoding is finished
+			FPCMStruct TargetPCMInfo{SoundWaveRef->SharePCMData()};
 
-		OnProgress_Internal(65);
+			// Preventing the sound wave from being garbage collected while the remaining chunks are being decoded into it
+			SoundWaveRef->AddToRoot();
 
-		AsyncTask(ENamedThreads::GameThread, [this, DecodedAudioInfo = MoveTemp(DecodedAudioInfo)]()
-		{
-			ImportAudioFromDecodedInfo(DecodedAudioInfo);
+			UE_LOG(LogRuntimeAudioImporter, Log, TEXT("The first chunk of the audio data was successfully imported, the rest is being decoded in the background. Information about imported data:\n%s"), *DecodedAudioInfo.SoundWaveBasicInfo.ToString());
+			WeakThis->OnResult_Internal(SoundWaveRef, ETranscodingStatus::SuccessfulImport, StatsCollector);
+
+			AsyncTask(ENamedThreads::AnyBackgroundHiPriTask, [WeakThis, CancellationToken, SoundWaveRef, AudioData = MoveTemp(AudioData), AudioFormat, Decoder = MoveTemp(Decoder), TargetPCMInfo = MoveTemp(TargetPCMInfo), NumOfChannels = DecodedAudioInfo.SoundWaveBasicInfo.NumOfChannels, StorageFormat = DecodedAudioInfo.PCMInfo.StorageFormat, NumOfFramesPerChunk]() mutable
+			{
+				uint32 NumOfDecodedFrames{SoundWaveRef->NumOfDecodedFrames};
+
+				// The decoding target is captured once, since the PCM data of the sound wave may be replaced while decoding
+				uint8* TargetPCMData{TargetPCMInfo.PCMData.GetView().GetData()};
+				const uint32 NumOfTargetFrames{TargetPCMInfo.PCMNumOfFrames};
+				int32 LastPercentage{0};
+				bool bCancelled{false};
+
+				// The chunks are decoded outside the lock, since the playback locks the PCM data as well and must not wait for the decoder
+				const int64 ChunkFrameSize{static_cast<int64>(NumOfChannels) * (StorageFormat == EPCMStorageFormat::Int16 ? sizeof(int16) : sizeof(float))};
+				TArray<uint8> ChunkPCMData;
+				ChunkPCMData.SetNumUninitialized(NumOfFramesPerChunk * ChunkFrameSize);
+
+				// A second decoder prefetches the PCM data at the seek target, so that the playback does not wait for the main decoder to get there. Created on the first seek beyond the decoded frames
+				TUniquePtr<FChunkedAudioDecoder> PrefetchDecoder;
+				bool bPrefetching{false};
+
+				// How far the prefetch decoder keeps ahead of the playback before the main decoder takes its turn
+				const uint32 NumOfPrefetchAheadFrames{static_cast<uint32>(NumOfFramesPerChunk) * 4};
+
+				while (true)
+				{
+					// Checking for the cancellation between chunks
+					if (CancellationToken->IsCancelled())
+					{
+						bCancelled = true;
+						break;
+					}
+
+					// Seeking the prefetch decoder to the requested frame, unless the main decoder is about to get there anyway
+					const int64 PrefetchFrame{SoundWaveRef->PendingPrefetchFrame.Exchange(-1)};
+					if (PrefetchFrame > static_cast<int64>(NumOfDecodedFrames) + NumOfFramesPerChunk)
+					{
+						if (!PrefetchDecoder.IsValid())
+						{
+							PrefetchDecoder = CreateChunkedDecoder(AudioFormat, AudioData.GetView().GetData(), AudioData.GetView().Num());
+						}
+
+						if (PrefetchDecoder.IsValid() && PrefetchDecoder->SeekToFrame(PrefetchFrame))
+						{
+							FScopeLock Lock(&SoundWaveRef->DataGuard);
+
+							SoundWaveRef->PrefetchedStartFrame = static_cast<uint32>(PrefetchFrame);
+							SoundWaveRef->PrefetchedEndFrame = static_cast<uint32>(PrefetchFrame);
+							bPrefetching = true;
+						}
+					}
+
+					// Prefetching while the playback is within the prefetched frames and close to their end
+					bool bPrefetchChunk{false};
+					if (bPrefetching)
+					{
+						FScopeLock Lock(&SoundWaveRef->DataGuard);
+
+						const uint32 PlaybackFrame{static_cast<uint32>(SoundWaveRef->CurrentNumOfFrames)};
+						const uint32 PrefetchedStartFrame{SoundWaveRef->PrefetchedStartFrame};
+						const uint32 PrefetchedEndFrame{SoundWaveRef->PrefetchedEndFrame};
+
+						bPrefetchChunk = PrefetchedStartFrame == PrefetchedEndFrame || (PlaybackFrame >= PrefetchedStartFrame && PlaybackFrame + NumOfPrefetchAheadFrames > PrefetchedEndFrame);
+					}
+
+					FChunkedAudioDecoder& ChunkDecoder = bPrefetchChunk ? *PrefetchDecoder : *Decoder;
+					const uint32 NumOfChunkFrames{ChunkDecoder.ReadFramesInFormat(ChunkPCMData.GetData(), NumOfFramesPerChunk, StorageFormat)};
+
+					FScopeLock Lock(&SoundWaveRef->DataGuard);
+
+					FPCMStruct& PCMBufferInfo = SoundWaveRef->PCMBufferInfo;
+
+					// Stopping if the sound wave no longer plays the PCM data being decoded (e.g. its memory has been released or it has switched to a queued sound wave), or if the PCM data has been completely decoded
+					if (PCMBufferInfo.PCMData.GetView().GetData() != TargetPCMData || NumOfDecodedFrames >= NumOfTargetFrames)
+					{
+						break;
+					}
+
+					if (bPrefetchChunk)
+					{
+						const uint32 PrefetchedEndFrame{SoundWaveRef->PrefetchedEndFrame};
+
+						// The rest is left to the main decoder once the prefetch decoder runs out of frames
+						if (NumOfChunkFrames == 0 || PrefetchedEndFrame >= NumOfTargetFrames)
+						{
+							bPrefetching = false;
+							continue;
+						}
+
+						const uint32 NumOfPrefetchedFrames{FMath::Min<uint32>(NumOfChunkFrames, NumOfTargetFrames - PrefetchedEndFrame)};
+						FMemory::Memcpy(TargetPCMData + PrefetchedEndFrame * ChunkFrameSize, ChunkPCMData.GetData(), NumOfPrefetchedFrames * ChunkFrameSize);
+
+						SoundWaveRef->PrefetchedEndFrame = PrefetchedEndFrame + NumOfPrefetchedFrames;
+						continue;
+					}
+
+					// The length reported by the decoder may be slightly inaccurate, in which case the sound wave is truncated to the frames actually decoded
+					if (NumOfChunkFrames == 0)
+					{
+						UE_LOG(LogRuntimeAudioImporter, Warning, TEXT("The decoder produced '%d' frames instead of the expected '%d'"), NumOfDecodedFrames, NumOfTargetFrames);
+						SoundWaveRef->TruncatePCMData(NumOfDecodedFrames);
+						break;
+					}
+
+					const uint32 NumOfCopiedFrames{FMath::Min<uint32>(NumOfChunkFrames, NumOfTargetFrames - NumOfDecodedFrames)};
+					FMemory::Memcpy(TargetPCMData + NumOfDecodedFrames * ChunkFrameSize, ChunkPCMData.GetData(), NumOfCopiedFrames * ChunkFrameSize);
+
+					NumOfDecodedFrames += NumOfCopiedFrames;
+
+					// Once the main decoder reaches the prefetched frames, they become part of the decoded frames and the prefetch decoder continues from their end
+					const uint32 PrefetchedStartFrame{SoundWaveRef->PrefetchedStartFrame};
+					const uint32 PrefetchedEndFrame{SoundWaveRef->PrefetchedEndFrame};
+					if (PrefetchedStartFrame != PrefetchedEndFrame && NumOfDecodedFrames >= PrefetchedStartFrame)
+					{
+						if (NumOfDecodedFrames < PrefetchedEndFrame)
+						{
+							NumOfDecodedFrames = PrefetchedEndFrame;
+							Swap(Decoder, PrefetchDecoder);
+						}
+
+						SoundWaveRef->PrefetchedStartFrame = 0;
+						SoundWaveRef->PrefetchedEndFrame = 0;
+						bPrefetching = false;
+					}
+
+					SoundWaveRef->NumOfDecodedFrames = NumOfDecodedFrames;
+
+					const int32 Percentage{static_cast<int32>(static_cast<uint64>(NumOfDecodedFrames) * 100 / NumOfTargetFrames)};
+					if (Percentage != LastPercentage && WeakThis.IsValid())
+					{
+						LastPercentage = Percentage;
+						WeakThis->OnProgress_Internal(Percentage);
+					}
+				}
+
+				// The decoders no longer read the audio data, so they can be released before the audio data itself
+				Decoder.Reset();
+				PrefetchDecoder.Reset();
+				AudioData.Empty();
+				TargetPCMInfo.PCMData.Empty();
+
+				// The sound wave may already be playing, so instead of releasing the partially decoded PCM data it is truncated to the frames decoded so far
+				if (bCancelled)
+				{
+					SoundWaveRef->TruncatePCMData(NumOfDecodedFrames);
+				}
+
+				// The result has already been broadcast along with the first chunk, so the end of the decoding is reported through a separate delegate
+				AsyncTask(ENamedThreads::GameThread, [WeakThis, SoundWaveRef, bCancelled]()
+				{
+					UE_LOG(LogRuntimeAudioImporter, Log, TEXT("Streaming decoding of the sound wave '%s' has been %s"), *SoundWaveRef->GetName(), bCancelled ? TEXT("cancelled") : TEXT("completed"));
+
+					if (WeakThis.IsValid())
+					{
+						if (WeakThis->OnStreamingFinishedNative.IsBound())
+						{
+							WeakThis->OnStreamingFinishedNative.Broadcast(WeakThis.Get(), SoundWaveRef, bCancelled);
+						}
+
+						if (WeakThis->OnStreamingFinished.IsBound())
+						{
+							WeakThis->OnStreamingFinished.Broadcast(WeakThis.Get(), SoundWaveRef, bCancelled);
+						}
+					}
+
+					SoundWaveRef->RemoveFromRoot();
+				});
+			});
 		});
 	});
 }
 
-void URuntimeAudioImporterLibrary::TranscodeRAWDataFromBuffer(TArray<uint8> RAWData_From, ERAWAudioFormat RAWFrom, TArray<uint8>& RAWData_To, ERAWAudioFormat RAWTo)
+void URuntimeAudioImporterLibrary::CancelImport()
 {
-	TArray<uint8> IntermediateRAWBuffer;
+	FScopeLock Lock(&CancellationTokenGuard);
 
-	// Transcoding of all formats to unsigned 8-bit PCM format (intermediate)
-	switch (RAWFrom)
+	UE_LOG(LogRuntimeAudioImporter, Log, TEXT("Cancelling the imports in progress"));
+
+	// The imports in progress hold the current token, while the imports started later get a new one
+	CancellationToken->Cancel();
+	CancellationToken = MakeShared<FAudioImportCancellationToken, ESPMode::ThreadSafe>();
+}
+
+void URuntimeAudioImporterLibrary::TranscodeRAWDataFromBuffer(const TArray<uint8>& RAWData_From, ERAWAudioFormat FormatFrom, TArray<uint8>& RAWData_To, ERAWAudioFormat FormatTo)
+{
+	if (&RAWData_From == &RAWData_To)
 	{
-	case ERAWAudioFormat::Int16:
-		{
-			RAWTranscoder::TranscodeRAWData<int16, uint8>(RAWData_From, IntermediateRAWBuffer);
-			break;
-		}
-	case ERAWAudioFormat::Int32:
-		{
-			RAWTranscoder::TranscodeRAWData<int32, uint8>(RAWData_From, IntermediateRAWBuffer);
-			break;
-		}
-	case ERAWAudioFormat::UInt8:
-		{
-			IntermediateRAWBuffer = RAWData_From;
-			break;
-		}
-	case ERAWAudioFormat::Float32:
-		{
-			RAWTranscoder::TranscodeRAWData<float, uint8>(RAWData_From, IntermediateRAWBuffer);
-			break;
-		}
+		TranscodeRAWDataInPlace(RAWData_To, FormatFrom, FormatTo);
+		return;
 	}
 
-	RAWData_From.Empty();
+	const int64 NumOfSamples{RAWData_From.Num() / RAWTranscoder::GetSampleSize(FormatFrom)};
+	const int64 RAWDataSize_To{NumOfSamples * RAWTranscoder::GetSampleSize(FormatTo)};
 
-	// Transcoding unsigned 8-bit PCM to the specified format
-	switch (RAWTo)
+	if (RAWDataSize_To > MAX_int32)
 	{
-	case ERAWAudioFormat::Int16:
-		{
-			RAWTranscoder::TranscodeRAWData<uint8, int16>(IntermediateRAWBuffer, RAWData_To);
-			break;
-		}
-	case ERAWAudioFormat::Int32:
-		{
-			RAWTranscoder::TranscodeRAWData<uint8, int32>(IntermediateRAWBuffer, RAWData_To);
-			break;
-		}
-	case ERAWAudioFormat::UInt8:
-		{
-			RAWData_To = IntermediateRAWBuffer;
-			break;
-		}
-	case ERAWAudioFormat::Float32:
-		{
-			RAWTranscoder::TranscodeRAWData<uint8, float>(IntermediateRAWBuffer, RAWData_To);
-			break;
-		}
+		UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Unable to transcode RAW data: the transcoded data size '%lld' exceeds the maximum array size"), RAWDataSize_To);
+		RAWData_To.Empty();
+		return;
+	}
+
+	// Transcoding directly to the required format, without any intermediate buffers
+	RAWData_To.SetNumUninitialized(static_cast<int32>(RAWDataSize_To));
+	RAWTranscoder::TranscodeSamples(RAWData_From.GetData(), FormatFrom, RAWData_To.GetData(), FormatTo, NumOfSamples);
+}
+
+void URuntimeAudioImporterLibrary::TranscodeRAWDataInPlace(TArray<uint8>& RAWData, ERAWAudioFormat FormatFrom, ERAWAudioFormat FormatTo)
+{
+	const int64 NumOfSamples{RAWData.Num() / RAWTranscoder::GetSampleSize(FormatFrom)};
+	const int64 RAWDataSize_From{NumOfSamples * RAWTranscoder::GetSampleSize(FormatFrom)};
+	const int64 RAWDataSize_To{NumOfSamples * RAWTranscoder::GetSampleSize(FormatTo)};
+
+	if (RAWDataSize_To > MAX_int32)
+	{
+		UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Unable to transcode RAW data: the transcoded data size '%lld' exceeds the maximum array size"), RAWDataSize_To);
+		return;
+	}
+
+	// Growing the array beforehand if the transcoded samples are larger, and shrinking it afterwards (without reallocating) if they are smaller
+	if (RAWDataSize_To > RAWDataSize_From)
+	{
+		RAWData.SetNumUninitialized(static_cast<int32>(RAWDataSize_To));
 	}
+
+	RAWTranscoder::TranscodeSamples(RAWData.GetData(), FormatFrom, RAWData.GetData(), FormatTo, NumOfSamples);
+
+	RAWData.SetNum(static_cast<int32>(RAWDataSize_To), false);
 }
 
 bool URuntimeAudioImporterLibrary::TranscodeRAWDataFromFile(const FString& FilePathFrom, ERAWAudioFormat FormatFrom, const FString& FilePathTo, ERAWAudioFormat FormatTo)
 {
-	TArray<uint8> RAWBufferFrom;
+	IPlatformFile& PlatformFile{FPlatformFileManager::Get().GetPlatformFile()};
 
-	// Loading a file into a byte array
-	if (!LoadAudioFileToArray(RAWBufferFrom, *FilePathFrom))
+	const TUniquePtr<IFileHandle> FileHandleFrom{PlatformFile.OpenRead(*FilePathFrom)};
+	if (!FileHandleFrom.IsValid())
 	{
 		UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Something went wrong when reading RAW data on the path '%s'"), *FilePathFrom);
 		return false;
 	}
 
-	TArray<uint8> RAWBufferTo;
-	TranscodeRAWDataFromBuffer(RAWBufferFrom, FormatFrom, RAWBufferTo, FormatTo);
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(FilePathTo));
 
-	// Writing a file to a specified location
-	if (!FFileHelper::SaveArrayToFile(MoveTemp(RAWBufferTo), *FilePathTo))
+	const TUniquePtr<IFileHandle> FileHandleTo{PlatformFile.OpenWrite(*FilePathTo)};
+	if (!FileHandleTo.IsValid())
 	{
 		UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Something went wrong when saving RAW data to the path '%s'"), *FilePathTo);
 		return false;
 	}
 
+	const int64 SampleSizeFrom{RAWTranscoder::GetSampleSize(FormatFrom)};
+	const int64 SampleSizeTo{RAWTranscoder::GetSampleSize(FormatTo)};
+
+	// Only whole samples are transcoded
+	const int64 NumOfSamples{FileHandleFrom->Size() / SampleSizeFrom};
+
+	// Transcoding the file chunk by chunk in a single buffer, so that the memory usage is constant regardless of the file size
+	constexpr int64 NumOfChunkSamples{256 * 1024};
+
+	TArray<uint8> ChunkData;
+	ChunkData.SetNumUninitialized(static_cast<int32>(FMath::Min(NumOfSamples, NumOfChunkSamples) * FMath::Max(SampleSizeFrom, SampleSizeTo)));
+
+	for (int64 SampleIndex = 0; SampleIndex < NumOfSamples; SampleIndex += NumOfChunkSamples)
+	{
+		const int64 NumOfSamplesInChunk{FMath::Min(NumOfChunkSamples, NumOfSamples - SampleIndex)};
+
+		if (!FileHandleFrom->Read(ChunkData.GetData(), NumOfSamplesInChunk * SampleSizeFrom))
+		{
+			UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Something went wrong when reading RAW data on the path '%s'"), *FilePathFrom);
+			return false;
+		}
+
+		RAWTranscoder::TranscodeSamples(ChunkData.GetData(), FormatFrom, ChunkData.GetData(), FormatTo, NumOfSamplesInChunk);
+
+		if (!FileHandleTo->Write(ChunkData.GetData(), NumOfSamplesInChunk * SampleSizeTo))
+		{
+			UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Something went wrong when saving RAW data to the path '%s'"), *FilePathTo);
+			return false;
+		}
+	}
+
 	return true;
 }
 
@@ -282,7 +1271,12 @@ bool URuntimeAudioImporterLibrary::ExportSoundWaveToBuffer(UImportedSoundWave* I
 	// Filling in decoded audio info
 	FDecodedAudioStruct DecodedAudioInfo;
 	{
-		DecodedAudioInfo.PCMInfo = ImporterSoundWave->PCMBufferInfo;
+		// Referenced without being copied, since the encoders only read it
+		DecodedAudioInfo.PCMInfo = ImporterSoundWave->SharePCMData();
+
+		// The encoders take 32-bit float data
+		RAWTranscoder::ConvertPCMStorageFormat(DecodedAudioInfo.PCMInfo, EPCMStorageFormat::Float32);
+
 		FSoundWaveBasicStruct SoundWaveBasicInfo;
 		{
 			SoundWaveBasicInfo.NumOfChannels = ImporterSoundWave->NumChannels;
@@ -309,37 +1303,48 @@ bool URuntimeAudioImporterLibrary::ExportSoundWaveToBuffer(UImportedSoundWave* I
 	return true;
 }
 
-void URuntimeAudioImporterLibrary::ImportAudioFromDecodedInfo(const FDecodedAudioStruct& DecodedAudioInfo)
+void URuntimeAudioImporterLibrary::ImportAudioFromDecodedInfo(FDecodedAudioStruct&& DecodedAudioInfo, const TSharedPtr<FAudioImportStatsCollector, ESPMode::ThreadSafe>& StatsCollector)
 {
-	UImportedSoundWave* SoundWaveRef = CreateImportedSoundWave();
+	// Logged before the PCM data is moved to the sound wave
+	const FString DecodedAudioInfoString{DecodedAudioInfo.ToString()};
 
-	if (SoundWaveRef == nullptr)
+	UImportedSoundWave* SoundWaveRef;
 	{
-		UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Something went wrong while creating the imported sound wave"));
-		OnResult_Internal(nullptr, ETranscodingStatus::SoundWaveDeclarationError);
-		return;
-	}
+		FAudioImportStageScope StageScope(StatsCollector, EAudioImportStage::Attach);
+
+		SoundWaveRef = CreateImportedSoundWave();
 
-	DefineSoundWave(SoundWaveRef, DecodedAudioInfo);
+		if (SoundWaveRef == nullptr)
+		{
+			UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Something went wrong while creating the imported sound wave"));
+			OnResult_Internal(nullptr, ETranscodingStatus::SoundWaveDeclarationError, StatsCollector);
+			return;
+		}
+
+		const uint8* DecodedPCMData{DecodedAudioInfo.PCMInfo.PCMData.GetView().GetData()};
+		const int64 DecodedPCMDataSize{DecodedAudioInfo.PCMInfo.PCMData.GetView().Num()};
+
+		DefineSoundWave(SoundWaveRef, MoveTemp(DecodedAudioInfo));
+
+		// Overridden DefineSoundWave may still copy the PCM data
+		if (SoundWaveRef->PCMBufferInfo.PCMData.GetView().GetData() != DecodedPCMData)
+		{
+			FAudioImportStatsCollector::AddCopiedBytes(DecodedPCMDataSize);
+		}
+	}
 
-	UE_LOG(LogRuntimeAudioImporter, Log, TEXT("The audio data was successfully imported. Information about imported data:\n%s"), *DecodedAudioInfo.ToString());
+	UE_LOG(LogRuntimeAudioImporter, Log, TEXT("The audio data was successfully imported. Information about imported data:\n%s"), *DecodedAudioInfoString);
 	OnProgress_Internal(100);
-	OnResult_Internal(SoundWaveRef, ETranscodingStatus::SuccessfulImport);
+	OnResult_Internal(SoundWaveRef, ETranscodingStatus::SuccessfulImport, StatsCollector);
 }
 
-void URuntimeAudioImporterLibrary::DefineSoundWave(UImportedSoundWave* SoundWaveRef, const FDecodedAudioStruct& DecodedAudioInfo)
+void URuntimeAudioImporterLibrary::DefineSoundWave(UImportedSoundWave* SoundWaveRef, FDecodedAudioStruct&& DecodedAudioInfo)
 {
-	OnProgress_Internal(70);
-
 	// Filling in a sound wave basic information (e.g. duration, number of channels, etc)
 	FillSoundWaveBasicInfo(SoundWaveRef, DecodedAudioInfo);
 
-	OnProgress_Internal(75);
-
 	// Filling in PCM data buffer
-	FillPCMData(SoundWaveRef, DecodedAudioInfo);
-
-	OnProgress_Internal(95);
+	FillPCMData(SoundWaveRef, MoveTemp(DecodedAudioInfo));
 }
 
 void URuntimeAudioImporterLibrary::FillSoundWaveBasicInfo(UImportedSoundWave* SoundWaveRef, const FDecodedAudioStruct& DecodedAudioInfo)
@@ -359,10 +1364,18 @@ void URuntimeAudioImporterLibrary::FillSoundWaveBasicInfo(UImportedSoundWave* So
 	SoundWaveRef->DecompressionType = EDecompressionType::DTYPE_Procedural;
 }
 
-void URuntimeAudioImporterLibrary::FillPCMData(UImportedSoundWave* SoundWaveRef, const FDecodedAudioStruct& DecodedAudioInfo)
+void URuntimeAudioImporterLibrary::FillPCMData(UImportedSoundWave* SoundWaveRef, FDecodedAudioStruct&& DecodedAudioInfo)
 {
-	SoundWaveRef->PCMBufferInfo = DecodedAudioInfo.PCMInfo;
+#if DO_CHECK
+	const uint8* DecodedPCMData{DecodedAudioInfo.PCMInfo.PCMData.GetView().GetData()};
+#endif
+
 	SoundWaveRef->RawPCMDataSize = DecodedAudioInfo.PCMInfo.PCMData.GetView().Num();
+	SoundWaveRef->NumOfDecodedFrames = DecodedAudioInfo.PCMInfo.PCMNumOfFrames;
+	SoundWaveRef->PCMBufferInfo = MoveTemp(DecodedAudioInfo.PCMInfo);
+
+	// The sound wave plays from the exact buffer the decoder allocated
+	checkf(SoundWaveRef->PCMBufferInfo.PCMData.GetView().GetData() == DecodedPCMData, TEXT("The PCM data was copied while being moved to the sound wave '%s'"), *SoundWaveRef->GetName());
 }
 
 EAudioFormat URuntimeAudioImporterLibrary::GetAudioFormat(const FString& FilePath)
@@ -399,26 +1412,59 @@ EAudioFormat URuntimeAudioImporterLibrary::GetAudioFormatAdvanced(const TArray<u
 	return GetAudioFormat(AudioData.GetData(), AudioData.Num());
 }
 
-EAudioFormat URuntimeAudioImporterLibrary::GetAudioFormat(const uint8* AudioData, int32 AudioDataSize)
+/** Sniffed formats with at least this confidence are trusted without initializing a decoder */
+constexpr uint8 SniffedAudioFormatMinConfidence{75};
+
+bool CheckAudioFormat(EAudioFormat AudioFormat, const uint8* AudioData, int32 AudioDataSize)
 {
-	if (MP3Transcoder::CheckAudioFormat(AudioData, AudioDataSize))
+	switch (AudioFormat)
 	{
-		return EAudioFormat::Mp3;
+	case EAudioFormat::Mp3:
+		{
+			return MP3Transcoder::CheckAudioFormat(AudioData, AudioDataSize);
+		}
+	case EAudioFormat::Wav:
+		{
+			return WAVTranscoder::CheckAudioFormat(AudioData, AudioDataSize);
+		}
+	case EAudioFormat::Flac:
+		{
+			return FlacTranscoder::CheckAudioFormat(AudioData, AudioDataSize);
+		}
+	case EAudioFormat::OggVorbis:
+		{
+			return VorbisTranscoder::CheckAudioFormat(AudioData, AudioDataSize);
+		}
+	default:
+		{
+			return false;
+		}
 	}
+}
+
+EAudioFormat URuntimeAudioImporterLibrary::GetAudioFormat(const uint8* AudioData, int32 AudioDataSize)
+{
+	// Sniffing the header first, which is much cheaper than initializing the decoders
+	uint8 Confidence;
+	const EAudioFormat SniffedAudioFormat{SniffAudioFormat(AudioData, AudioDataSize, Confidence)};
 
-	if (WAVTranscoder::CheckAudioFormat(AudioData, AudioDataSize))
+	if (Confidence >= SniffedAudioFormatMinConfidence)
 	{
-		return EAudioFormat::Wav;
+		return SniffedAudioFormat;
 	}
 
-	if (FlacTranscoder::CheckAudioFormat(AudioData, AudioDataSize))
+	// Falling back to initializing the decoders, starting with the most likely format
+	if (SniffedAudioFormat != EAudioFormat::Invalid && CheckAudioFormat(SniffedAudioFormat, AudioData, AudioDataSize))
 	{
-		return EAudioFormat::Flac;
+		return SniffedAudioFormat;
 	}
 
-	if (VorbisTranscoder::CheckAudioFormat(AudioData, AudioDataSize))
+	for (const EAudioFormat AudioFormat : {EAudioFormat::Mp3, EAudioFormat::Wav, EAudioFormat::Flac, EAudioFormat::OggVorbis})
 	{
-		return EAudioFormat::OggVorbis;
+		if (AudioFormat != SniffedAudioFormat && CheckAudioFormat(AudioFormat, AudioData, AudioDataSize))
+		{
+			return AudioFormat;
+		}
 	}
 
 	UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Unable to determine audio data format"));
@@ -426,13 +1472,93 @@ EAudioFormat URuntimeAudioImporterLibrary::GetAudioFormat(const uint8* AudioData
 	return EAudioFormat::Invalid;
 }
 
+EAudioFormat URuntimeAudioImporterLibrary::SniffAudioFormat(const uint8* AudioData, int64 AudioDataSize, uint8& Confidence)
+{
+	const TTuple<EAudioFormat, uint8> SniffedAudioFormats[]{
+		{EAudioFormat::Mp3, MP3Transcoder::SniffAudioFormat(AudioData, AudioDataSize)},
+		{EAudioFormat::Wav, WAVTranscoder::SniffAudioFormat(AudioData, AudioDataSize)},
+		{EAudioFormat::Flac, FlacTranscoder::SniffAudioFormat(AudioData, AudioDataSize)},
+		{EAudioFormat::OggVorbis, VorbisTranscoder::SniffAudioFormat(AudioData, AudioDataSize)}
+	};
+
+	EAudioFormat AudioFormat{EAudioFormat::Invalid};
+	Confidence = 0;
+
+	for (const TTuple<EAudioFormat, uint8>& SniffedAudioFormat : SniffedAudioFormats)
+	{
+		if (SniffedAudioFormat.Value > Confidence)
+		{
+			AudioFormat = SniffedAudioFormat.Key;
+			Confidence = SniffedAudioFormat.Value;
+		}
+	}
+
+	return AudioFormat;
+}
+
+bool URuntimeAudioImporterLibrary::ProbeAudioInfo(const uint8* AudioData, int64 AudioDataSize, EAudioFormat& AudioFormat, FSoundWaveBasicStruct& SoundWaveBasicInfo)
+{
+	if (AudioFormat == EAudioFormat::Auto)
+	{
+		AudioFormat = GetAudioFormat(AudioData, static_cast<int32>(AudioDataSize));
+	}
+
+	// Initializing the chunked decoder only reads the headers (and the frame headers in the case of MP3), without decoding the audio data
+	const TUniquePtr<FChunkedAudioDecoder> Decoder{CreateChunkedDecoder(AudioFormat, AudioData, AudioDataSize)};
+
+	if (!Decoder.IsValid())
+	{
+		return false;
+	}
+
+	SoundWaveBasicInfo = Decoder->GetSoundWaveBasicInfo();
+
+	return true;
+}
+
+bool URuntimeAudioImporterLibrary::ValidateAudioData(const uint8* AudioData, int64 AudioDataSize, EAudioFormat AudioFormat)
+{
+	const TUniquePtr<FChunkedAudioDecoder> Decoder{CreateChunkedDecoder(AudioFormat, AudioData, AudioDataSize)};
+
+	if (!Decoder.IsValid())
+	{
+		return false;
+	}
+
+	constexpr uint32 NumOfFramesPerChunk{static_cast<uint32>(FAudioImportCancellationToken::NumOfFramesPerCheck)};
+
+	TArray<float> PCMData;
+	PCMData.SetNumUninitialized(NumOfFramesPerChunk * Decoder->GetSoundWaveBasicInfo().NumOfChannels);
+
+	uint64 NumOfDecodedFrames{0};
+
+	while (const uint32 NumOfChunkFrames = Decoder->ReadFrames(PCMData.GetData(), NumOfFramesPerChunk))
+	{
+		NumOfDecodedFrames += NumOfChunkFrames;
+	}
+
+	if (NumOfDecodedFrames == 0)
+	{
+		UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Unable to decode any frames of the audio data"));
+		return false;
+	}
+
+	// The length stored in the headers may be slightly inaccurate, which does not prevent the audio data from being played
+	if (Decoder->GetNumOfFrames() > 0 && NumOfDecodedFrames != Decoder->GetNumOfFrames())
+	{
+		UE_LOG(LogRuntimeAudioImporter, Warning, TEXT("Decoded '%llu' frames of the audio data instead of the expected '%llu'"), NumOfDecodedFrames, Decoder->GetNumOfFrames());
+	}
+
+	return true;
+}
+
 void URuntimeAudioImporterLibrary::ImportAudioFromFloat32Buffer(uint8* PCMData, const int32 PCMDataSize, const int32 SampleRate, const int32 NumOfChannels)
 {
 	FDecodedAudioStruct DecodedAudioInfo;
 
 	// Filling in the required information
 	{
-		DecodedAudioInfo.PCMInfo.PCMData = FBulkDataBuffer<uint8>(PCMData, PCMDataSize);
+		DecodedAudioInfo.PCMInfo.PCMData = FRuntimeBulkDataBuffer<uint8>(PCMData, PCMDataSize);
 		DecodedAudioInfo.PCMInfo.PCMNumOfFrames = PCMDataSize / sizeof(float) / NumOfChannels;
 
 		DecodedAudioInfo.SoundWaveBasicInfo.NumOfChannels = NumOfChannels;
@@ -440,10 +1566,41 @@ void URuntimeAudioImporterLibrary::ImportAudioFromFloat32Buffer(uint8* PCMData,
 		DecodedAudioInfo.SoundWaveBasicInfo.Duration = static_cast<float>(DecodedAudioInfo.PCMInfo.PCMNumOfFrames) / SampleRate;
 	}
 
-	OnProgress_Internal(50);
+	// Resampling and converting the whole PCM data may take a while, so it is done in the background
+	AsyncTask(ENamedThreads::AnyBackgroundHiPriTask, [WeakThis = MakeWeakObjectPtr(this), CancellationToken = GetCancellationToken(), StorageFormat = PCMStorageFormat, TargetSampleRate = TargetSampleRate, DecodedAudioInfo = MoveTemp(DecodedAudioInfo)]() mutable
+	{
+		if (!WeakThis.IsValid())
+		{
+			return;
+		}
+
+		if (TargetSampleRate > 0 && !ResamplingTranscoder::ResampleDecodedAudio(DecodedAudioInfo, TargetSampleRate))
+		{
+			WeakThis->OnResult_Internal(nullptr, ETranscodingStatus::FailedToReadAudioDataArray);
+			return;
+		}
+
+		RAWTranscoder::ConvertPCMStorageFormat(DecodedAudioInfo.PCMInfo, StorageFormat);
+
+		WeakThis->OnProgress_Internal(50);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, CancellationToken, DecodedAudioInfo = MoveTemp(DecodedAudioInfo)]() mutable
+		{
+			if (!WeakThis.IsValid())
+			{
+				return;
+			}
+
+			if (CancellationToken->IsCancelled())
+			{
+				WeakThis->OnResult_Internal(nullptr, ETranscodingStatus::Cancelled);
+				return;
+			}
 
-	// Finalizing import
-	ImportAudioFromDecodedInfo(DecodedAudioInfo);
+			// Finalizing import
+			WeakThis->ImportAudioFromDecodedInfo(MoveTemp(DecodedAudioInfo));
+		});
+	});
 }
 
 FString URuntimeAudioImporterLibrary::ConvertSecondsToString(int32 Seconds)
@@ -467,18 +1624,30 @@ FString URuntimeAudioImporterLibrary::ConvertSecondsToString(int32 Seconds)
 	return FinalString;
 }
 
-bool URuntimeAudioImporterLibrary::DecodeAudioData(FEncodedAudioStruct& EncodedAudioInfo, FDecodedAudioStruct& DecodedAudioInfo)
+bool URuntimeAudioImporterLibrary::DecodeAudioData(FEncodedAudioStruct& EncodedAudioInfo, FDecodedAudioStruct& DecodedAudioInfo, const FAudioImportCancellationToken* CancellationToken, FAudioDecodingProgress* Progress)
 {
 	if (EncodedAudioInfo.AudioFormat == EAudioFormat::Auto)
 	{
 		EncodedAudioInfo.AudioFormat = GetAudioFormat(EncodedAudioInfo.AudioData.GetView().GetData(), EncodedAudioInfo.AudioData.GetView().Num());
 	}
 
+	// Uncompressed WAV data is decoded faster than it is hashed, so it is not worth caching
+	FString CacheKey;
+	if (PCMDiskCache::IsEnabled() && EncodedAudioInfo.AudioFormat != EAudioFormat::Wav && EncodedAudioInfo.AudioFormat != EAudioFormat::Invalid)
+	{
+		CacheKey = PCMDiskCache::GetCacheKey(EncodedAudioInfo.AudioData.GetView().GetData(), EncodedAudioInfo.AudioData.GetView().Num(), DecodedAudioInfo.PCMInfo.StorageFormat);
+
+		if (PCMDiskCache::Load(CacheKey, DecodedAudioInfo))
+		{
+			return true;
+		}
+	}
+
 	switch (EncodedAudioInfo.AudioFormat)
 	{
 	case EAudioFormat::Mp3:
 		{
-			if (!MP3Transcoder::Decode(EncodedAudioInfo, DecodedAudioInfo))
+			if (!MP3Transcoder::Decode(EncodedAudioInfo, DecodedAudioInfo, CancellationToken, Progress))
 			{
 				UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Something went wrong while decoding Mp3 audio data"));
 				return false;
@@ -487,7 +1656,7 @@ bool URuntimeAudioImporterLibrary::DecodeAudioData(FEncodedAudioStruct& EncodedA
 		}
 	case EAudioFormat::Wav:
 		{
-			if (!WAVTranscoder::Decode(EncodedAudioInfo, DecodedAudioInfo))
+			if (!WAVTranscoder::Decode(EncodedAudioInfo, DecodedAudioInfo, CancellationToken, Progress))
 			{
 				UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Something went wrong while decoding Wav audio data"));
 				return false;
@@ -496,7 +1665,7 @@ bool URuntimeAudioImporterLibrary::DecodeAudioData(FEncodedAudioStruct& EncodedA
 		}
 	case EAudioFormat::Flac:
 		{
-			if (!FlacTranscoder::Decode(EncodedAudioInfo, DecodedAudioInfo))
+			if (!FlacTranscoder::Decode(EncodedAudioInfo, DecodedAudioInfo, CancellationToken, Progress))
 			{
 				UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Something went wrong while decoding Flac audio data"));
 				return false;
@@ -505,7 +1674,7 @@ bool URuntimeAudioImporterLibrary::DecodeAudioData(FEncodedAudioStruct& EncodedA
 		}
 	case EAudioFormat::OggVorbis:
 		{
-			if (!VorbisTranscoder::Decode(EncodedAudioInfo, DecodedAudioInfo))
+			if (!VorbisTranscoder::Decode(EncodedAudioInfo, DecodedAudioInfo, CancellationToken, Progress))
 			{
 				UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Something went wrong while decoding Vorbis audio data"));
 				return false;
@@ -519,6 +1688,11 @@ bool URuntimeAudioImporterLibrary::DecodeAudioData(FEncodedAudioStruct& EncodedA
 		}
 	}
 
+	if (!CacheKey.IsEmpty())
+	{
+		PCMDiskCache::Store(CacheKey, DecodedAudioInfo);
+	}
+
 	return true;
 }
 
@@ -577,36 +1751,166 @@ UImportedSoundWave* URuntimeAudioImporterLibrary::CreateImportedSoundWave() cons
 
 void URuntimeAudioImporterLibrary::OnProgress_Internal(int32 Percentage)
 {
-	AsyncTask(ENamedThreads::GameThread, [this, Percentage]()
+	// Only the latest percentage is broadcast, so the decoding threads do not flood the game thread with progress updates
+	PendingPercentage = Percentage;
+
+	if (!bProgressBroadcastPending.Exchange(true))
+	{
+		// The core ticker is ticked once per frame, so the progress is broadcast at most once per frame
+		FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakThis = MakeWeakObjectPtr(this)](float DeltaTime)
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->BroadcastPendingProgress();
+			}
+
+			return false;
+		}));
+	}
+}
+
+void URuntimeAudioImporterLibrary::BroadcastPendingProgress()
+{
+	if (!bProgressBroadcastPending.Exchange(false))
+	{
+		return;
+	}
+
+	const int32 Percentage{PendingPercentage};
+
+	if (OnProgress.IsBound())
+	{
+		OnProgress.Broadcast(Percentage);
+	}
+
+	if (OnProgressNative.IsBound())
+	{
+		OnProgressNative.Broadcast(Percentage);
+	}
+}
+
+void URuntimeAudioImporterLibrary::OnBatchProgress_Internal(const TWeakObjectPtr<URuntimeAudioImporterLibrary>& WeakThis, const TSharedRef<FBatchImportState, ESPMode::ThreadSafe>& State, int32 FileIndex, int32 FilePercentage, UImportedSoundWave* SoundWaveRef, ETranscodingStatus Status, bool bFinished)
+{
+	// The intermediate progress of all files is coalesced into a single broadcast per frame, while each finished file is broadcast on its own
+	if (!bFinished)
 	{
-		if (OnProgress.IsBound())
+		FPlatformAtomics::AtomicStore(&State->PendingFilePercentages[FileIndex], FilePercentage);
+
+		if (!State->bProgressBroadcastPending.Exchange(true))
 		{
-			OnProgress.Broadcast(Percentage);
+			FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakThis, State](float DeltaTime)
+			{
+				State->bProgressBroadcastPending = false;
+
+				if (WeakThis.IsValid())
+				{
+					for (int32 PendingFileIndex = 0; PendingFileIndex < State->FilePaths.Num(); ++PendingFileIndex)
+					{
+						// The progress of a file is never broadcast backwards, e.g. after the file has finished
+						const int32 PendingFilePercentage{FPlatformAtomics::AtomicRead(&State->PendingFilePercentages[PendingFileIndex])};
+						if (PendingFilePercentage > State->FilePercentages[PendingFileIndex])
+						{
+							WeakThis->BroadcastBatchProgress(State, PendingFileIndex, PendingFilePercentage, nullptr, ETranscodingStatus::SuccessfulImport, false);
+						}
+					}
+				}
+
+				return false;
+			}));
 		}
 
-		if (OnProgressNative.IsBound())
+		return;
+	}
+
+	AsyncTask(ENamedThreads::GameThread, [WeakThis, State, FileIndex, FilePercentage, SoundWaveRef, Status]()
+	{
+		if (WeakThis.IsValid())
 		{
-			OnProgressNative.Broadcast(Percentage);
+			WeakThis->BroadcastBatchProgress(State, FileIndex, FilePercentage, SoundWaveRef, Status, true);
 		}
 	});
 }
 
-void URuntimeAudioImporterLibrary::OnResult_Internal(UImportedSoundWave* SoundWaveRef, ETranscodingStatus Status)
+void URuntimeAudioImporterLibrary::BroadcastBatchProgress(const TSharedRef<FBatchImportState, ESPMode::ThreadSafe>& State, int32 FileIndex, int32 FilePercentage, UImportedSoundWave* SoundWaveRef, ETranscodingStatus Status, bool bFinished)
+{
+	State->FilePercentages[FileIndex] = FilePercentage;
+
+	if (bFinished)
+	{
+		++State->NumOfFinishedFiles;
+	}
+
+	int64 SumOfPercentages{0};
+	for (const int32 Percentage : State->FilePercentages)
+	{
+		SumOfPercentages += Percentage;
+	}
+
+	FBatchImportProgress Progress;
+	{
+		Progress.FileIndex = FileIndex;
+		Progress.FilePath = State->FilePaths[FileIndex];
+		Progress.FilePercentage = FilePercentage;
+		Progress.bFinished = bFinished;
+		Progress.Status = Status;
+		Progress.SoundWave = SoundWaveRef;
+		Progress.NumOfFinishedFiles = State->NumOfFinishedFiles;
+		Progress.NumOfFiles = State->FilePaths.Num();
+		Progress.TotalPercentage = static_cast<int32>(SumOfPercentages / State->FilePaths.Num());
+	}
+
+	if (bFinished && Status != ETranscodingStatus::SuccessfulImport && Status != ETranscodingStatus::Cancelled)
+	{
+		UE_LOG(LogRuntimeAudioImporter, Error, TEXT("Failed to import '%s' from the batch with status '%s'"), *Progress.FilePath, *UEnum::GetValueAsString(Status));
+	}
+
+	if (OnBatchProgressNative.IsBound())
+	{
+		OnBatchProgressNative.Broadcast(this, Progress);
+	}
+
+	if (OnBatchProgress.IsBound())
+	{
+		OnBatchProgress.Broadcast(this, Progress);
+	}
+
+	if (bFinished && Progress.NumOfFinishedFiles == Progress.NumOfFiles)
+	{
+		UE_LOG(LogRuntimeAudioImporter, Log, TEXT("The batch of '%d' audio files has been imported"), Progress.NumOfFiles);
+	}
+}
+
+void URuntimeAudioImporterLibrary::OnResult_Internal(UImportedSoundWave* SoundWaveRef, ETranscodingStatus Status, const TSharedPtr<FAudioImportStatsCollector, ESPMode::ThreadSafe>& StatsCollector)
 {
-	AsyncTask(ENamedThreads::GameThread, [this, SoundWaveRef, Status]()
+	AsyncTask(ENamedThreads::GameThread, [WeakThis = MakeWeakObjectPtr(this), SoundWaveRef, Status, StatsCollector]()
 	{
+		if (!WeakThis.IsValid())
+		{
+			return;
+		}
+
+		// The latest progress is broadcast before the result, even if the import has finished within the same frame
+		WeakThis->BroadcastPendingProgress();
+
+		WeakThis->LastImportStats = StatsCollector.IsValid() ? StatsCollector->Finish() : FAudioImportStats();
+
+		if (StatsCollector.IsValid())
+		{
+			UE_LOG(LogRuntimeAudioImporter, Verbose, TEXT("Import statistics:\n%s"), *WeakThis->LastImportStats.ToString());
+		}
+
 		bool bBroadcasted{false};
 
-		if (OnResultNative.IsBound())
+		if (WeakThis->OnResultNative.IsBound())
 		{
 			bBroadcasted = true;
-			OnResultNative.Broadcast(this, SoundWaveRef, Status);
+			WeakThis->OnResultNative.Broadcast(WeakThis.Get(), SoundWaveRef, Status);
 		}
 
-		if (OnResult.IsBound())
+		if (WeakThis->OnResult.IsBound())
 		{
 			bBroadcasted = true;
-			OnResult.Broadcast(this, SoundWaveRef, Status);
+			WeakThis->OnResult.Broadcast(WeakThis.Get(), SoundWaveRef, Status);
 		}
 
 		if (!bBroadcasted)
@@ -615,3 +1919,9 @@ void URuntimeAudioImporterLibrary::OnResult_Internal(UImportedSoundWave* SoundWa
 		}
 	});
 }
+
+TSharedRef<FAudioImportCancellationToken, ESPMode::ThreadSafe> URuntimeAudioImporterLibrary::GetCancellationToken() const
+{
+	FScopeLock Lock(&CancellationTokenGuard);
+	return CancellationToken;
+}
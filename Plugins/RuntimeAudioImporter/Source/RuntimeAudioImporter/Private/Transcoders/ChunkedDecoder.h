@@ -0,0 +1,82 @@
+﻿// Georgy Treshchev 2022.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RuntimeAudioImporterTypes.h"
+#include "Transcoders/RAWTranscoder.h"
+
+/**
+ * Base class for decoders that read PCM data in chunks instead of decoding the whole audio data at once
+ *
+ * @note The encoded audio data must remain valid for the entire lifetime of the decoder
+ */
+class RUNTIMEAUDIOIMPORTER_API FChunkedAudioDecoder
+{
+public:
+	virtual ~FChunkedAudioDecoder() = default;
+
+	/**
+	 * Read the next chunk of 32-bit float PCM frames
+	 *
+	 * @param PCMData Pointer to memory location to write the interleaved PCM data to. Must be able to hold NumOfFramesToRead * NumOfChannels samples
+	 * @param NumOfFramesToRead The maximum number of frames to read
+	 * @return The number of frames actually read. Less than NumOfFramesToRead only when the end of the audio data is reached
+	 */
+	virtual uint32 ReadFrames(float* PCMData, uint32 NumOfFramesToRead) = 0;
+
+	/**
+	 * Seek to the specified PCM frame
+	 *
+	 * @param FrameIndex Index of the frame from which to continue reading
+	 * @return Whether the seeking was successful or not
+	 */
+	virtual bool SeekToFrame(uint64 FrameIndex) = 0;
+
+	/**
+	 * Read the next chunk of PCM frames in the specified storage format
+	 *
+	 * @param PCMData Pointer to memory location to write the interleaved PCM data to. Must be able to hold NumOfFramesToRead * NumOfChannels samples of the storage format
+	 * @param NumOfFramesToRead The maximum number of frames to read
+	 * @param StorageFormat The storage format to write the PCM data in
+	 * @return The number of frames actually read
+	 */
+	uint32 ReadFramesInFormat(uint8* PCMData, uint32 NumOfFramesToRead, EPCMStorageFormat StorageFormat)
+	{
+		if (StorageFormat == EPCMStorageFormat::Float32)
+		{
+			return ReadFrames(reinterpret_cast<float*>(PCMData), NumOfFramesToRead);
+		}
+
+		// Decoding into an intermediate float buffer, since the decoders produce 32-bit float data
+		IntermediatePCMData.SetNumUninitialized(NumOfFramesToRead * SoundWaveBasicInfo.NumOfChannels, false);
+
+		const uint32 NumOfReadFrames{ReadFrames(IntermediatePCMData.GetData(), NumOfFramesToRead)};
+		RAWTranscoder::ConvertFloatToInt16(IntermediatePCMData.GetData(), reinterpret_cast<int16*>(PCMData), static_cast<int64>(NumOfReadFrames) * SoundWaveBasicInfo.NumOfChannels);
+
+		return NumOfReadFrames;
+	}
+
+	/** Get basic audio information (e.g. duration, number of channels, etc) */
+	const FSoundWaveBasicStruct& GetSoundWaveBasicInfo() const
+	{
+		return SoundWaveBasicInfo;
+	}
+
+	/** Get the total number of PCM frames. Zero if the length of the audio data cannot be determined without decoding it */
+	uint64 GetNumOfFrames() const
+	{
+		return NumOfFrames;
+	}
+
+protected:
+	/** Basic audio information, filled in by the derived decoders during initialization */
+	FSoundWaveBasicStruct SoundWaveBasicInfo;
+
+	/** Total number of PCM frames, filled in by the derived decoders during initialization */
+	uint64 NumOfFrames = 0;
+
+private:
+	/** Intermediate float PCM data used when reading in a different storage format */
+	TArray<float> IntermediatePCMData;
+};
@@ -1,8 +1,11 @@
 ﻿// Georgy Treshchev 2022.
 
 #include "Transcoders/FlacTranscoder.h"
+#include "Transcoders/MP3Transcoder.h"
 #include "RuntimeAudioImporterDefines.h"
 #include "RuntimeAudioImporterTypes.h"
+#include "Transcoders/ChunkedDecoder.h"
+#include "Transcoders/ParallelDecoding.h"
 
 #define INCLUDE_FLAC
 #include "TranscodersIncludes.h"
@@ -17,10 +20,34 @@ bool FlacTranscoder::CheckAudioFormat(const uint8* AudioData, int32 AudioDataSiz
 		return false;
 	}
 
+	drflac_close(FLAC);
+
 	return true;
 }
 
-bool FlacTranscoder::Decode(const FEncodedAudioStruct& EncodedData, FDecodedAudioStruct& DecodedData)
+uint8 FlacTranscoder::SniffAudioFormat(const uint8* AudioData, int64 AudioDataSize)
+{
+	// The decoder skips ID3 tags preceding the native stream marker, so skipping them here as well
+	const int64 MarkerOffset{MP3Transcoder::GetID3TagSize(AudioData, AudioDataSize)};
+	if (MarkerOffset + 4 <= AudioDataSize && FMemory::Memcmp(AudioData + MarkerOffset, "fLaC", 4) == 0)
+	{
+		return 100;
+	}
+
+	// Ogg-encapsulated stream, where the first packet starts with the FLAC mapping header. It follows the 27-byte page header and the segment table
+	if (AudioDataSize >= 27 && FMemory::Memcmp(AudioData, "OggS", 4) == 0)
+	{
+		const int64 PacketOffset{27 + static_cast<int64>(AudioData[26])};
+		if (PacketOffset + 5 <= AudioDataSize && FMemory::Memcmp(AudioData + PacketOffset, "\x7F" "FLAC", 5) == 0)
+		{
+			return 100;
+		}
+	}
+
+	return 0;
+}
+
+bool FlacTranscoder::Decode(const FEncodedAudioStruct& EncodedData, FDecodedAudioStruct& DecodedData, const FAudioImportCancellationToken* CancellationToken, FAudioDecodingProgress* Progress)
 {
 	RuntimeAudioImporter_TranscoderLogs::PrintLog(FString::Printf(TEXT("Decoding Flac audio data to uncompressed audio format.\nEncoded audio info: %s"), *EncodedData.ToString()));
 	
@@ -33,16 +60,112 @@ bool FlacTranscoder::Decode(const FEncodedAudioStruct& EncodedData, FDecodedAudi
 		return false;
 	}
 
-	// Allocating memory for PCM data
-	uint8* TempPCMData = static_cast<uint8*>(FMemory::Malloc(FLAC_Decoder->totalPCMFrameCount * FLAC_Decoder->channels * sizeof(float)));
+	const uint64 NumOfFrames{FLAC_Decoder->totalPCMFrameCount};
+	const uint32 NumOfChannels{FLAC_Decoder->channels};
+	const EPCMStorageFormat StorageFormat{DecodedData.PCMInfo.StorageFormat};
+	const uint32 SampleSize{DecodedData.PCMInfo.GetSampleSize()};
+
+	if (Progress != nullptr)
+	{
+		Progress->SetNumOfFrames(NumOfFrames);
+	}
+
+	// Filling in PCM data in the requested storage format
+	auto ReadPCMFrames = [StorageFormat, NumOfChannels, SampleSize, CancellationToken, Progress](drflac* Decoder, uint64 NumOfFramesToRead, uint8* PCMData, uint64 StartFrame) -> uint64
+	{
+		uint64 NumOfReadFrames{0};
+
+		// Reading in chunks to be able to stop as soon as the cancellation is requested
+		while (NumOfReadFrames < NumOfFramesToRead && (CancellationToken == nullptr || !CancellationToken->IsCancelled()))
+		{
+			uint8* FramesPCMData = PCMData + static_cast<int64>(StartFrame + NumOfReadFrames) * NumOfChannels * SampleSize;
+			const uint64 NumOfChunkFrames{FMath::Min(NumOfFramesToRead - NumOfReadFrames, FAudioImportCancellationToken::NumOfFramesPerCheck)};
+
+			const uint64 NumOfReadChunkFrames{
+				StorageFormat == EPCMStorageFormat::Int16
+					? drflac_read_pcm_frames_s16(Decoder, NumOfChunkFrames, reinterpret_cast<drflac_int16*>(FramesPCMData))
+					: drflac_read_pcm_frames_f32(Decoder, NumOfChunkFrames, reinterpret_cast<float*>(FramesPCMData))
+			};
+
+			if (NumOfReadChunkFrames == 0)
+			{
+				break;
+			}
+
+			NumOfReadFrames += NumOfReadChunkFrames;
+
+			if (Progress != nullptr)
+			{
+				Progress->AddDecodedFrames(NumOfReadChunkFrames);
+			}
+		}
+
+		return NumOfReadFrames;
+	};
+
+	// Allocating memory for PCM data. The size is computed in 64 bits, since long multichannel audio data exceeds 2 GB once decoded
+	const int64 FrameSize{static_cast<int64>(NumOfChannels) * SampleSize};
+	uint8* TempPCMData = static_cast<uint8*>(FMemory::Malloc(static_cast<int64>(NumOfFrames) * FrameSize));
+
+	const int32 NumOfSegments{ParallelDecoding::GetNumOfSegments(NumOfFrames)};
+
+	// Each segment is decoded by its own decoder instance into a disjoint region of the PCM data
+	const EParallelDecodingResult ParallelDecodingResult{NumOfSegments > 1 ? ParallelDecoding::DecodeSegments(NumOfFrames, NumOfSegments, CancellationToken, Progress, [&EncodedData, &ReadPCMFrames, TempPCMData](uint64 StartFrame, uint64 NumOfSegmentFrames) -> uint64
+	{
+		drflac* Segment_Decoder{drflac_open_memory(EncodedData.AudioData.GetView().GetData(), EncodedData.AudioData.GetView().Num(), nullptr)};
+
+		if (Segment_Decoder == nullptr)
+		{
+			return 0;
+		}
+
+		uint64 NumOfDecodedFrames{0};
+
+		// Seeking is sample-exact, so the segment boundaries do not have to be aligned to FLAC frames
+		if (drflac_seek_to_pcm_frame(Segment_Decoder, StartFrame))
+		{
+			NumOfDecodedFrames = ReadPCMFrames(Segment_Decoder, NumOfSegmentFrames, TempPCMData, StartFrame);
+		}
+
+		drflac_close(Segment_Decoder);
+
+		return NumOfDecodedFrames;
+	}) : EParallelDecodingResult::Failed};
+
+	if (ParallelDecodingResult == EParallelDecodingResult::Decoded)
+	{
+		DecodedData.PCMInfo.PCMNumOfFrames = NumOfFrames;
+
+		if (ParallelDecoding::ShouldValidate())
+		{
+			uint8* SerialPCMData = static_cast<uint8*>(FMemory::Malloc(static_cast<int64>(NumOfFrames) * FrameSize));
+			const uint64 NumOfSerialFrames{ReadPCMFrames(FLAC_Decoder, NumOfFrames, SerialPCMData, 0)};
+
+			ParallelDecoding::Validate(TempPCMData, SerialPCMData, FMath::Min(NumOfFrames, NumOfSerialFrames) * FrameSize);
+
+			FMemory::Free(SerialPCMData);
+		}
+	}
+	else if (ParallelDecodingResult == EParallelDecodingResult::Failed)
+	{
+		// Filling in PCM data and getting the number of frames
+		DecodedData.PCMInfo.PCMNumOfFrames = ReadPCMFrames(FLAC_Decoder, NumOfFrames, TempPCMData, 0);
+	}
+
+	if (CancellationToken != nullptr && CancellationToken->IsCancelled())
+	{
+		RuntimeAudioImporter_TranscoderLogs::PrintLog(TEXT("Decoding of FLAC audio data has been cancelled"));
 
-	// Filling in PCM data and getting the number of frames
-	DecodedData.PCMInfo.PCMNumOfFrames = drflac_read_pcm_frames_f32(FLAC_Decoder, FLAC_Decoder->totalPCMFrameCount, reinterpret_cast<float*>(TempPCMData));
+		FMemory::Free(TempPCMData);
+		drflac_close(FLAC_Decoder);
+
+		return false;
+	}
 
 	// Getting PCM data size
-	const int32 TempPCMDataSize = static_cast<int32>(DecodedData.PCMInfo.PCMNumOfFrames * FLAC_Decoder->channels * sizeof(float));
+	const int64 TempPCMDataSize{static_cast<int64>(DecodedData.PCMInfo.PCMNumOfFrames) * FrameSize};
 
-	DecodedData.PCMInfo.PCMData = FBulkDataBuffer<uint8>(TempPCMData, TempPCMDataSize);
+	DecodedData.PCMInfo.PCMData = FRuntimeBulkDataBuffer<uint8>(TempPCMData, TempPCMDataSize);
 
 	// Getting basic audio information
 	{
@@ -58,3 +181,67 @@ bool FlacTranscoder::Decode(const FEncodedAudioStruct& EncodedData, FDecodedAudi
 
 	return true;
 }
+
+
+/**
+ * Decoder that reads FLAC data in chunks using the dr_flac pull API
+ */
+class FFlacChunkedDecoder final : public FChunkedAudioDecoder
+{
+public:
+	virtual ~FFlacChunkedDecoder() override
+	{
+		if (FLAC_Decoder != nullptr)
+		{
+			drflac_close(FLAC_Decoder);
+		}
+	}
+
+	/**
+	 * Initialize transcoding of audio data in memory
+	 */
+	bool Initialize(const uint8* AudioData, int64 AudioDataSize)
+	{
+		FLAC_Decoder = drflac_open_memory(AudioData, AudioDataSize, nullptr);
+
+		if (FLAC_Decoder == nullptr)
+		{
+			return false;
+		}
+
+		// May be zero if the stream info does not specify the total number of frames
+		NumOfFrames = FLAC_Decoder->totalPCMFrameCount;
+
+		SoundWaveBasicInfo.NumOfChannels = FLAC_Decoder->channels;
+		SoundWaveBasicInfo.SampleRate = FLAC_Decoder->sampleRate;
+		SoundWaveBasicInfo.Duration = static_cast<float>(NumOfFrames) / FLAC_Decoder->sampleRate;
+
+		return true;
+	}
+
+	virtual uint32 ReadFrames(float* PCMData, uint32 NumOfFramesToRead) override
+	{
+		return static_cast<uint32>(drflac_read_pcm_frames_f32(FLAC_Decoder, NumOfFramesToRead, PCMData));
+	}
+
+	virtual bool SeekToFrame(uint64 FrameIndex) override
+	{
+		return drflac_seek_to_pcm_frame(FLAC_Decoder, FrameIndex) == DRFLAC_TRUE;
+	}
+
+private:
+	drflac* FLAC_Decoder{nullptr};
+};
+
+TUniquePtr<FChunkedAudioDecoder> FlacTranscoder::CreateChunkedDecoder(const uint8* AudioData, int64 AudioDataSize)
+{
+	TUniquePtr<FFlacChunkedDecoder> Decoder{MakeUnique<FFlacChunkedDecoder>()};
+
+	if (!Decoder->Initialize(AudioData, AudioDataSize))
+	{
+		RuntimeAudioImporter_TranscoderLogs::PrintError(TEXT("Unable to initialize FLAC Decoder"));
+		return nullptr;
+	}
+
+	return Decoder;
+}
@@ -3,6 +3,9 @@
 #include "Transcoders/MP3Transcoder.h"
 #include "RuntimeAudioImporterDefines.h"
 #include "RuntimeAudioImporterTypes.h"
+#include "Transcoders/ChunkedDecoder.h"
+#include "Transcoders/ProgressiveDecoder.h"
+#include "Transcoders/RAWTranscoder.h"
 
 #define INCLUDE_MP3
 #include "TranscodersIncludes.h"
@@ -17,10 +20,132 @@ bool MP3Transcoder::CheckAudioFormat(const uint8* AudioData, int32 AudioDataSize
 		return false;
 	}
 
+	drmp3_uninit(&MP3);
+
 	return true;
 }
 
-bool MP3Transcoder::Decode(const FEncodedAudioStruct& EncodedData, FDecodedAudioStruct& DecodedData)
+namespace
+{
+	/** The maximum number of bytes after the ID3 tags in which to look for an MPEG audio frame */
+	constexpr int64 MP3SniffingWindowSize{4096};
+
+	/**
+	 * Get the length of the MPEG audio frame from its header
+	 *
+	 * @return The frame length in bytes, zero if the header is invalid, or -1 if the length is unknown (free format bitrate)
+	 */
+	int64 GetMPEGFrameLength(const uint8* FrameHeader)
+	{
+		// 11-bit frame sync
+		if (FrameHeader[0] != 0xFF || (FrameHeader[1] & 0xE0) != 0xE0)
+		{
+			return 0;
+		}
+
+		// Version: 0 - MPEG 2.5, 1 - reserved, 2 - MPEG 2, 3 - MPEG 1. Layer: 0 - reserved, 1 - Layer III, 2 - Layer II, 3 - Layer I
+		const uint8 Version{static_cast<uint8>((FrameHeader[1] >> 3) & 0x03)};
+		const uint8 Layer{static_cast<uint8>((FrameHeader[1] >> 1) & 0x03)};
+		const uint8 BitrateIndex{static_cast<uint8>(FrameHeader[2] >> 4)};
+		const uint8 SampleRateIndex{static_cast<uint8>((FrameHeader[2] >> 2) & 0x03)};
+		const uint8 Padding{static_cast<uint8>((FrameHeader[2] >> 1) & 0x01)};
+
+		if (Version == 1 || Layer == 0 || BitrateIndex == 15 || SampleRateIndex == 3)
+		{
+			return 0;
+		}
+
+		if (BitrateIndex == 0)
+		{
+			return -1;
+		}
+
+		/** Bitrates in kbps for MPEG 1 and MPEG 2/2.5, for Layers I, II and III */
+		static const uint16 Bitrates[2][3][15]{
+			{
+				{0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448},
+				{0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384},
+				{0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320}
+			},
+			{
+				{0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256},
+				{0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160},
+				{0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160}
+			}
+		};
+		static const int64 SampleRates[3]{44100, 48000, 32000};
+
+		const bool bMPEG1{Version == 3};
+		const int32 LayerIndex{3 - Layer};
+		const int64 Bitrate{Bitrates[bMPEG1 ? 0 : 1][LayerIndex][BitrateIndex] * 1000};
+		const int64 SampleRate{SampleRates[SampleRateIndex] >> (bMPEG1 ? 0 : Version == 2 ? 1 : 2)};
+
+		if (LayerIndex == 0)
+		{
+			return (12 * Bitrate / SampleRate + Padding) * 4;
+		}
+
+		if (LayerIndex == 2 && !bMPEG1)
+		{
+			return 72 * Bitrate / SampleRate + Padding;
+		}
+
+		return 144 * Bitrate / SampleRate + Padding;
+	}
+}
+
+uint8 MP3Transcoder::SniffAudioFormat(const uint8* AudioData, int64 AudioDataSize)
+{
+	const int64 ID3TagSize{GetID3TagSize(AudioData, AudioDataSize)};
+
+	const int64 LastHeaderOffset{FMath::Min(AudioDataSize - 4, ID3TagSize + MP3SniffingWindowSize)};
+	for (int64 HeaderOffset = ID3TagSize; HeaderOffset <= LastHeaderOffset; ++HeaderOffset)
+	{
+		const int64 FrameLength{GetMPEGFrameLength(AudioData + HeaderOffset)};
+		if (FrameLength == 0)
+		{
+			continue;
+		}
+
+		// A single frame sync can easily occur by chance, so confirming it with the header of the next frame
+		if (FrameLength > 0 && HeaderOffset + FrameLength + 4 <= AudioDataSize)
+		{
+			if (GetMPEGFrameLength(AudioData + HeaderOffset + FrameLength) == 0)
+			{
+				continue;
+			}
+
+			return HeaderOffset == ID3TagSize ? 100 : 90;
+		}
+
+		// The frame cannot be confirmed (free format bitrate or truncated data)
+		return ID3TagSize > 0 ? 60 : 40;
+	}
+
+	// ID3 tags are mostly used with MP3, but other formats (e.g. FLAC) may have them too
+	return ID3TagSize > 0 ? 30 : 0;
+}
+
+int64 MP3Transcoder::GetID3TagSize(const uint8* AudioData, int64 AudioDataSize)
+{
+	int64 TagSize{0};
+
+	// There may be several consecutive tags
+	while (TagSize + 10 <= AudioDataSize && AudioData[TagSize] == 'I' && AudioData[TagSize + 1] == 'D' && AudioData[TagSize + 2] == '3')
+	{
+		const uint8* TagHeader{AudioData + TagSize};
+
+		// The size is stored as a 28-bit synchsafe integer and does not include the header and the optional footer
+		const int64 TagBodySize{(TagHeader[6] & 0x7F) << 21 | (TagHeader[7] & 0x7F) << 14 | (TagHeader[8] & 0x7F) << 7 | (TagHeader[9] & 0x7F)};
+		const bool bHasFooter{(TagHeader[5] & 0x10) != 0};
+
+		TagSize += 10 + TagBodySize + (bHasFooter ? 10 : 0);
+	}
+
+	return TagSize;
+}
+
+bool MP3Transcoder::Decode(const FEncodedAudioStruct& EncodedData, FDecodedAudioStruct& DecodedData, const FAudioImportCancellationToken* CancellationToken, FAudioDecodingProgress* Progress)
 {
 	RuntimeAudioImporter_TranscoderLogs::PrintLog(FString::Printf(TEXT("Decoding MP3 audio data to uncompressed audio format.\nEncoded audio info: %s"), *EncodedData.ToString()));
 	
@@ -33,20 +158,66 @@ bool MP3Transcoder::Decode(const FEncodedAudioStruct& EncodedData, FDecodedAudio
 		return false;
 	}
 
-	// Allocating memory for PCM data
-	uint8* TempPCMData = static_cast<uint8*>(FMemory::Malloc(drmp3_get_pcm_frame_count(&MP3_Decoder) * MP3_Decoder.channels * sizeof(float)));
+	const uint64 NumOfFrames{drmp3_get_pcm_frame_count(&MP3_Decoder)};
+	const uint32 SampleSize{DecodedData.PCMInfo.GetSampleSize()};
+
+	// Allocating memory for PCM data. The size is computed in 64 bits, since long multichannel audio data exceeds 2 GB once decoded
+	const int64 FrameSize{static_cast<int64>(MP3_Decoder.channels) * SampleSize};
+	uint8* TempPCMData = static_cast<uint8*>(FMemory::Malloc(static_cast<int64>(NumOfFrames) * FrameSize));
+
+	uint64 NumOfDecodedFrames{0};
+
+	if (Progress != nullptr)
+	{
+		Progress->SetNumOfFrames(NumOfFrames);
+	}
+
+	// Filling in PCM data in the requested storage format in chunks, to be able to stop as soon as the cancellation is requested
+	while (NumOfDecodedFrames < NumOfFrames)
+	{
+		if (CancellationToken != nullptr && CancellationToken->IsCancelled())
+		{
+			RuntimeAudioImporter_TranscoderLogs::PrintLog(TEXT("Decoding of MP3 audio data has been cancelled"));
+
+			FMemory::Free(TempPCMData);
+			drmp3_uninit(&MP3_Decoder);
+
+			return false;
+		}
+
+		uint8* ChunkPCMData = TempPCMData + static_cast<int64>(NumOfDecodedFrames) * FrameSize;
+		const uint64 NumOfChunkFrames{FMath::Min(NumOfFrames - NumOfDecodedFrames, FAudioImportCancellationToken::NumOfFramesPerCheck)};
+
+		const uint64 NumOfDecodedChunkFrames{
+			DecodedData.PCMInfo.StorageFormat == EPCMStorageFormat::Int16
+				? drmp3_read_pcm_frames_s16(&MP3_Decoder, NumOfChunkFrames, reinterpret_cast<drmp3_int16*>(ChunkPCMData))
+				: drmp3_read_pcm_frames_f32(&MP3_Decoder, NumOfChunkFrames, reinterpret_cast<float*>(ChunkPCMData))
+		};
 
-	// Filling in PCM data and getting the number of frames
-	DecodedData.PCMInfo.PCMNumOfFrames = drmp3_read_pcm_frames_f32(&MP3_Decoder, drmp3_get_pcm_frame_count(&MP3_Decoder), reinterpret_cast<float*>(TempPCMData));
+		if (NumOfDecodedChunkFrames == 0)
+		{
+			break;
+		}
+
+		NumOfDecodedFrames += NumOfDecodedChunkFrames;
+
+		if (Progress != nullptr)
+		{
+			Progress->AddDecodedFrames(NumOfDecodedChunkFrames);
+		}
+	}
+
+	// Getting the number of frames
+	DecodedData.PCMInfo.PCMNumOfFrames = NumOfDecodedFrames;
 
 	// Getting PCM data size
-	const int32 TempPCMDataSize = static_cast<int32>(DecodedData.PCMInfo.PCMNumOfFrames * MP3_Decoder.channels * sizeof(float));
+	const int64 TempPCMDataSize{static_cast<int64>(DecodedData.PCMInfo.PCMNumOfFrames) * FrameSize};
 
-	DecodedData.PCMInfo.PCMData = FBulkDataBuffer<uint8>(TempPCMData, TempPCMDataSize);
+	DecodedData.PCMInfo.PCMData = FRuntimeBulkDataBuffer<uint8>(TempPCMData, TempPCMDataSize);
 
 	// Getting basic audio information
 	{
-		DecodedData.SoundWaveBasicInfo.Duration = static_cast<float>(drmp3_get_pcm_frame_count(&MP3_Decoder)) / MP3_Decoder.sampleRate;
+		DecodedData.SoundWaveBasicInfo.Duration = static_cast<float>(NumOfFrames) / MP3_Decoder.sampleRate;
 		DecodedData.SoundWaveBasicInfo.NumOfChannels = MP3_Decoder.channels;
 		DecodedData.SoundWaveBasicInfo.SampleRate = MP3_Decoder.sampleRate;
 	}
@@ -58,3 +229,234 @@ bool MP3Transcoder::Decode(const FEncodedAudioStruct& EncodedData, FDecodedAudio
 
 	return true;
 }
+
+
+/**
+ * Decoder that reads MP3 data in chunks using the dr_mp3 pull API
+ */
+class FMP3ChunkedDecoder final : public FChunkedAudioDecoder
+{
+public:
+	virtual ~FMP3ChunkedDecoder() override
+	{
+		if (bInitialized)
+		{
+			drmp3_uninit(&MP3_Decoder);
+		}
+	}
+
+	/**
+	 * Initialize transcoding of audio data in memory
+	 */
+	bool Initialize(const uint8* AudioData, int64 AudioDataSize)
+	{
+		if (!drmp3_init_memory(&MP3_Decoder, AudioData, AudioDataSize, nullptr))
+		{
+			return false;
+		}
+
+		bInitialized = true;
+
+		// Getting the number of frames requires scanning the MP3 frame headers, but not decoding them
+		NumOfFrames = drmp3_get_pcm_frame_count(&MP3_Decoder);
+
+		SoundWaveBasicInfo.NumOfChannels = MP3_Decoder.channels;
+		SoundWaveBasicInfo.SampleRate = MP3_Decoder.sampleRate;
+		SoundWaveBasicInfo.Duration = static_cast<float>(NumOfFrames) / MP3_Decoder.sampleRate;
+
+		return true;
+	}
+
+	virtual uint32 ReadFrames(float* PCMData, uint32 NumOfFramesToRead) override
+	{
+		return static_cast<uint32>(drmp3_read_pcm_frames_f32(&MP3_Decoder, NumOfFramesToRead, PCMData));
+	}
+
+	virtual bool SeekToFrame(uint64 FrameIndex) override
+	{
+		// Without a seek table, every seek decodes from the start of the stream. The table is only built once it is needed
+		if (!bSeekTableBuilt)
+		{
+			bSeekTableBuilt = true;
+
+			drmp3_uint32 NumOfSeekPoints{static_cast<drmp3_uint32>(FMath::Clamp<uint64>(NumOfFrames / FMath::Max<uint32>(MP3_Decoder.sampleRate, 1), 1, 4096))};
+			SeekPoints.SetNumUninitialized(NumOfSeekPoints);
+
+			if (drmp3_calculate_seek_points(&MP3_Decoder, &NumOfSeekPoints, SeekPoints.GetData()) && NumOfSeekPoints > 0)
+			{
+				SeekPoints.SetNum(NumOfSeekPoints, false);
+				drmp3_bind_seek_table(&MP3_Decoder, NumOfSeekPoints, SeekPoints.GetData());
+			}
+			else
+			{
+				SeekPoints.Empty();
+			}
+		}
+
+		return drmp3_seek_to_pcm_frame(&MP3_Decoder, FrameIndex) == DRMP3_TRUE;
+	}
+
+private:
+	drmp3 MP3_Decoder;
+	bool bInitialized{false};
+
+	/** Seek points bound to the decoder, roughly one per second of audio */
+	TArray<drmp3_seek_point> SeekPoints;
+	bool bSeekTableBuilt{false};
+};
+
+TUniquePtr<FChunkedAudioDecoder> MP3Transcoder::CreateChunkedDecoder(const uint8* AudioData, int64 AudioDataSize)
+{
+	TUniquePtr<FMP3ChunkedDecoder> Decoder{MakeUnique<FMP3ChunkedDecoder>()};
+
+	if (!Decoder->Initialize(AudioData, AudioDataSize))
+	{
+		RuntimeAudioImporter_TranscoderLogs::PrintError(TEXT("Unable to initialize MP3 Decoder"));
+		return nullptr;
+	}
+
+	return Decoder;
+}
+
+
+/**
+ * Decoder that decodes MP3 data frame by frame as it arrives, using the dr_mp3 low-level frame API
+ *
+ * @note The dr_mp3 callback API is not suitable for growing streams, since it treats the first short read as the end of the stream and skips the incomplete frames
+ */
+class FMP3ProgressiveDecoder final : public FProgressiveAudioDecoder
+{
+public:
+	FMP3ProgressiveDecoder()
+	{
+		drmp3dec_init(&MP3_Decoder);
+	}
+
+	virtual void AppendEncodedData(const uint8* AudioData, int64 AudioDataSize) override
+	{
+		// Removing the consumed data only once it makes up most of the buffer, so that the remaining data is not moved on every append
+		if (NumOfConsumedBytes > 0 && NumOfConsumedBytes >= EncodedData.Num() / 2)
+		{
+			EncodedData.RemoveAt(0, NumOfConsumedBytes, false);
+			NumOfConsumedBytes = 0;
+		}
+
+		EncodedData.Append(AudioData, AudioDataSize);
+	}
+
+	virtual uint32 DecodeFrames(TArray<uint8>& PCMData, EPCMStorageFormat StorageFormat, bool bEndOfStream) override
+	{
+		PCMData.Reset();
+
+		// ID3 tags may contain false frame syncs, so they are skipped as a whole before looking for the frames
+		if (!bID3TagsSkipped)
+		{
+			// The size of the tags is only known once their headers are complete
+			if (EncodedData.Num() - NumOfConsumedBytes < MP3StreamLookaheadSize && !bEndOfStream)
+			{
+				return 0;
+			}
+
+			NumOfBytesToSkip = MP3Transcoder::GetID3TagSize(EncodedData.GetData() + NumOfConsumedBytes, EncodedData.Num() - NumOfConsumedBytes);
+			bID3TagsSkipped = true;
+		}
+
+		const int64 NumOfSkippedBytes{FMath::Min<int64>(NumOfBytesToSkip, EncodedData.Num() - NumOfConsumedBytes)};
+		NumOfConsumedBytes += NumOfSkippedBytes;
+		NumOfBytesToSkip -= NumOfSkippedBytes;
+
+		uint32 NumOfDecodedFrames{0};
+
+		while (true)
+		{
+			const int64 NumOfAvailableBytes{EncodedData.Num() - NumOfConsumedBytes};
+
+			// The decoder discards an incomplete frame as invalid data, so waiting until the frame and the header of the next one are surely complete
+			if (NumOfAvailableBytes <= 0 || (!bEndOfStream && NumOfAvailableBytes < MP3StreamLookaheadSize))
+			{
+				break;
+			}
+
+			drmp3d_sample_t FramePCMData[DRMP3_MAX_SAMPLES_PER_FRAME];
+			drmp3dec_frame_info FrameInfo;
+
+			const int32 NumOfFrameSamples{drmp3dec_decode_frame(&MP3_Decoder, EncodedData.GetData() + NumOfConsumedBytes, static_cast<int32>(FMath::Min<int64>(NumOfAvailableBytes, TNumericLimits<int32>::Max())), FramePCMData, &FrameInfo)};
+
+			// No frame found in the remaining data
+			if (FrameInfo.frame_bytes == 0)
+			{
+				if (bEndOfStream)
+				{
+					NumOfConsumedBytes = EncodedData.Num();
+				}
+				break;
+			}
+
+			NumOfConsumedBytes += FrameInfo.frame_bytes;
+
+			// Skipped invalid data, or a frame that only fills in the bit reservoir
+			if (NumOfFrameSamples == 0)
+			{
+				continue;
+			}
+
+			if (!bFormatKnown)
+			{
+				SoundWaveBasicInfo.NumOfChannels = FrameInfo.channels;
+				SoundWaveBasicInfo.SampleRate = FrameInfo.hz;
+				SoundWaveBasicInfo.Duration = 0;
+				bFormatKnown = true;
+			}
+
+			// The sound wave cannot change its format in the middle of the playback
+			if (static_cast<uint32>(FrameInfo.channels) != SoundWaveBasicInfo.NumOfChannels || static_cast<uint32>(FrameInfo.hz) != SoundWaveBasicInfo.SampleRate)
+			{
+				RuntimeAudioImporter_TranscoderLogs::PrintWarning(FString::Printf(TEXT("Skipping the MP3 frame with %d channels and %d sample rate, since the stream started with %d channels and %d sample rate"), FrameInfo.channels, FrameInfo.hz, SoundWaveBasicInfo.NumOfChannels, SoundWaveBasicInfo.SampleRate));
+				continue;
+			}
+
+			const int64 NumOfSamples{static_cast<int64>(NumOfFrameSamples) * FrameInfo.channels};
+
+			if (StorageFormat == EPCMStorageFormat::Int16)
+			{
+				PCMData.Append(reinterpret_cast<const uint8*>(FramePCMData), NumOfSamples * sizeof(int16));
+			}
+			else
+			{
+				const int64 PCMDataSize{PCMData.Num()};
+				PCMData.AddUninitialized(NumOfSamples * sizeof(float));
+				RAWTranscoder::ConvertInt16ToFloat(FramePCMData, reinterpret_cast<float*>(PCMData.GetData() + PCMDataSize), NumOfSamples);
+			}
+
+			NumOfDecodedFrames += NumOfFrameSamples;
+		}
+
+		return NumOfDecodedFrames;
+	}
+
+private:
+	/**
+	 * The number of bytes that must be available before decoding the next frame in the middle of the stream. Enough for two frames of the largest (free format) size
+	 * and the header following them, which the decoder needs to confirm the frame sync
+	 */
+	static constexpr int64 MP3StreamLookaheadSize{2 * 2304 + 4};
+
+	drmp3dec MP3_Decoder;
+
+	/** Appended encoded data, including the already consumed part */
+	TArray64<uint8> EncodedData;
+
+	/** The number of bytes at the beginning of the encoded data that have already been decoded or skipped */
+	int64 NumOfConsumedBytes{0};
+
+	/** The number of bytes of the ID3 tags that have not been appended yet */
+	int64 NumOfBytesToSkip{0};
+
+	/** Whether the size of the ID3 tags has been determined */
+	bool bID3TagsSkipped{false};
+};
+
+TUniquePtr<FProgressiveAudioDecoder> MP3Transcoder::CreateProgressiveDecoder()
+{
+	return MakeUnique<FMP3ProgressiveDecoder>();
+}
@@ -6,14 +6,48 @@
 
 struct FDecodedAudioStruct;
 struct FEncodedAudioStruct;
+struct FAudioImportCancellationToken;
+struct FAudioDecodingProgress;
+class FChunkedAudioDecoder;
+class FProgressiveAudioDecoder;
 
 class RUNTIMEAUDIOIMPORTER_API MP3Transcoder
 {
 public:
 	static bool CheckAudioFormat(const uint8* AudioData, int32 AudioDataSize);
 
+	/**
+	 * Estimate whether the given audio data is MP3 by looking only at its header (ID3 tag and the first MPEG audio frames)
+	 *
+	 * @return Confidence from 0 (not MP3) to 100 (definitely MP3)
+	 */
+	static uint8 SniffAudioFormat(const uint8* AudioData, int64 AudioDataSize);
+
+	/**
+	 * Get the size of the ID3v2 tags at the beginning of the audio data
+	 *
+	 * @return The size of the tags in bytes, or zero if there are none
+	 */
+	static int64 GetID3TagSize(const uint8* AudioData, int64 AudioDataSize);
+
 	/**
 	 * Decode compressed MP3 data to PCM format
+	 *
+	 * @param CancellationToken Optional token checked between decoded chunks. The decoding fails if the cancellation is requested
+	 * @param Progress Optional progress updated between decoded chunks
+	 */
+	static bool Decode(const FEncodedAudioStruct& EncodedData, FDecodedAudioStruct& DecodedData, const FAudioImportCancellationToken* CancellationToken = nullptr, FAudioDecodingProgress* Progress = nullptr);
+
+	/**
+	 * Create a decoder that reads MP3 data in chunks instead of decoding it all at once
+	 *
+	 * @note The audio data must remain valid for the entire lifetime of the decoder
+	 * @return The initialized decoder, or nullptr if the audio data cannot be decoded
+	 */
+	static TUniquePtr<FChunkedAudioDecoder> CreateChunkedDecoder(const uint8* AudioData, int64 AudioDataSize);
+
+	/**
+	 * Create a decoder that receives MP3 data progressively (e.g. from a growing byte stream) and decodes the MPEG audio frames as soon as they are complete
 	 */
-	static bool Decode(const FEncodedAudioStruct& EncodedData, FDecodedAudioStruct& DecodedData);
+	static TUniquePtr<FProgressiveAudioDecoder> CreateProgressiveDecoder();
 };
@@ -0,0 +1,102 @@
+﻿// Georgy Treshchev 2022.
+
+#include "Transcoders/ParallelDecoding.h"
+#include "RuntimeAudioImporterDefines.h"
+#include "RuntimeAudioImporterTypes.h"
+#include "AudioImportStatsCollector.h"
+
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+
+static TAutoConsoleVariable<int32> CVarParallelDecoding(
+	TEXT("RuntimeAudioImporter.ParallelDecoding"),
+	1,
+	TEXT("Whether to decode large FLAC and WAV audio data in parallel segments.\n")
+	TEXT("0: Serial decoding\n")
+	TEXT("1: Parallel decoding\n")
+	TEXT("2: Parallel decoding validated against serial decoding (slow, for debugging only)"));
+
+static TAutoConsoleVariable<int32> CVarParallelDecodingMinFramesPerSegment(
+	TEXT("RuntimeAudioImporter.ParallelDecodingMinFramesPerSegment"),
+	1 << 20,
+	TEXT("The minimum number of PCM frames per segment for parallel decoding. Audio data shorter than two segments is decoded serially"));
+
+int32 ParallelDecoding::GetNumOfSegments(uint64 NumOfFrames)
+{
+	if (CVarParallelDecoding.GetValueOnAnyThread() <= 0 || !FApp::ShouldUseThreadingForPerformance())
+	{
+		return 1;
+	}
+
+	const uint64 MinFramesPerSegment{static_cast<uint64>(FMath::Max(CVarParallelDecodingMinFramesPerSegment.GetValueOnAnyThread(), 1))};
+	const uint64 MaxNumOfSegments{static_cast<uint64>(FTaskGraphInterface::Get().GetNumWorkerThreads() + 1)};
+
+	return static_cast<int32>(FMath::Max<uint64>(FMath::Min<uint64>(NumOfFrames / MinFramesPerSegment, MaxNumOfSegments), 1));
+}
+
+EParallelDecodingResult ParallelDecoding::DecodeSegments(uint64 NumOfFrames, int32 NumOfSegments, const FAudioImportCancellationToken* CancellationToken, FAudioDecodingProgress* Progress, TFunctionRef<uint64(uint64 StartFrame, uint64 NumOfSegmentFrames)> DecodeSegment)
+{
+	TAtomic<bool> bSucceeded{true};
+
+	// The segments decoded on the worker threads are accounted for by the import stage that started the decoding
+	FAudioImportStageCounters* StageCounters{FAudioImportStageScope::GetCurrentStageCounters()};
+
+	ParallelFor(NumOfSegments, [NumOfFrames, NumOfSegments, &DecodeSegment, &bSucceeded, StageCounters](int32 SegmentIndex)
+	{
+		FAudioImportStageScope StageScope(StageCounters);
+
+		const uint64 StartFrame{NumOfFrames * SegmentIndex / NumOfSegments};
+		const uint64 EndFrame{NumOfFrames * (SegmentIndex + 1) / NumOfSegments};
+
+		if (DecodeSegment(StartFrame, EndFrame - StartFrame) != EndFrame - StartFrame)
+		{
+			bSucceeded = false;
+		}
+	});
+
+	// The segments stop early once the cancellation is requested, which is not a reason to decode the audio data again
+	if (CancellationToken != nullptr && CancellationToken->IsCancelled())
+	{
+		RuntimeAudioImporter_TranscoderLogs::PrintLog(TEXT("Decoding of audio data in parallel segments has been cancelled"));
+		return EParallelDecodingResult::Cancelled;
+	}
+
+	if (!bSucceeded)
+	{
+		RuntimeAudioImporter_TranscoderLogs::PrintWarning(TEXT("Unable to decode audio data in parallel segments, falling back to serial decoding"));
+
+		if (Progress != nullptr)
+		{
+			Progress->ResetDecodedFrames();
+		}
+
+		return EParallelDecodingResult::Failed;
+	}
+
+	RuntimeAudioImporter_TranscoderLogs::PrintLog(FString::Printf(TEXT("Decoded '%llu' frames in '%d' parallel segments"), NumOfFrames, NumOfSegments));
+
+	return EParallelDecodingResult::Decoded;
+}
+
+bool ParallelDecoding::ShouldValidate()
+{
+	return CVarParallelDecoding.GetValueOnAnyThread() >= 2;
+}
+
+bool ParallelDecoding::Validate(const uint8* ParallelPCMData, const uint8* SerialPCMData, uint64 PCMDataSize)
+{
+	for (uint64 ByteIndex = 0; ByteIndex < PCMDataSize; ++ByteIndex)
+	{
+		if (ParallelPCMData[ByteIndex] != SerialPCMData[ByteIndex])
+		{
+			RuntimeAudioImporter_TranscoderLogs::PrintError(FString::Printf(TEXT("Parallel decoding mismatch at byte '%llu' of '%llu'"), ByteIndex, PCMDataSize));
+			return false;
+		}
+	}
+
+	RuntimeAudioImporter_TranscoderLogs::PrintLog(FString::Printf(TEXT("Parallel decoding matches serial decoding for all '%llu' bytes"), PCMDataSize));
+
+	return true;
+}
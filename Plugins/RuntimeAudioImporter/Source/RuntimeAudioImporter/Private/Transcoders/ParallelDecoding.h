@@ -0,0 +1,63 @@
+﻿// Georgy Treshchev 2022.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FAudioImportCancellationToken;
+struct FAudioDecodingProgress;
+
+/** Possible results of the parallel decoding */
+enum class EParallelDecodingResult : uint8
+{
+	/** All segments were completely decoded */
+	Decoded,
+
+	/** Some of the segments could not be decoded, so the audio data should be decoded serially instead */
+	Failed,
+
+	/** The cancellation was requested while decoding, so the audio data should not be decoded at all */
+	Cancelled
+};
+
+/**
+ * Helpers for decoding independently seekable audio data (e.g. FLAC, PCM WAV) by splitting it into segments decoded concurrently
+ */
+class RUNTIMEAUDIOIMPORTER_API ParallelDecoding
+{
+public:
+	/**
+	 * Get the number of segments to split the audio data into
+	 *
+	 * @param NumOfFrames Total number of PCM frames
+	 * @return The number of segments. One if the audio data should be decoded serially
+	 */
+	static int32 GetNumOfSegments(uint64 NumOfFrames);
+
+	/**
+	 * Decode the segments concurrently
+	 *
+	 * @param NumOfFrames Total number of PCM frames
+	 * @param NumOfSegments The number of segments to split the audio data into
+	 * @param CancellationToken Optional token checked by the segments. Also checked once the segments are decoded, to tell the cancellation apart from a failure
+	 * @param Progress Optional progress updated by the segments. The decoded frames are discarded if the decoding fails, so that the serial decoding does not count them again
+	 * @param DecodeSegment Decodes the specified range of frames into the corresponding region of the PCM data, using its own decoder instance. Returns the number of decoded frames
+	 * @return Whether all segments were completely decoded, failed or were cancelled
+	 */
+	static EParallelDecodingResult DecodeSegments(uint64 NumOfFrames, int32 NumOfSegments, const FAudioImportCancellationToken* CancellationToken, FAudioDecodingProgress* Progress, TFunctionRef<uint64(uint64 StartFrame, uint64 NumOfSegmentFrames)> DecodeSegment);
+
+	/**
+	 * Whether the output of the parallel decoding should be validated against the serial decoding
+	 */
+	static bool ShouldValidate();
+
+	/**
+	 * Compare the output of the parallel decoding against the serial decoding and log the result
+	 *
+	 * @param ParallelPCMData PCM data decoded in parallel
+	 * @param SerialPCMData PCM data decoded serially
+	 * @param PCMDataSize Size of the PCM data to compare
+	 * @return Whether the PCM data is sample-exact or not
+	 */
+	static bool Validate(const uint8* ParallelPCMData, const uint8* SerialPCMData, uint64 PCMDataSize);
+};
@@ -0,0 +1,52 @@
+﻿// Georgy Treshchev 2022.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RuntimeAudioImporterTypes.h"
+
+/**
+ * Base class for decoders that receive the encoded audio data progressively (e.g. from a growing byte stream) and decode it as it arrives
+ */
+class RUNTIMEAUDIOIMPORTER_API FProgressiveAudioDecoder
+{
+public:
+	virtual ~FProgressiveAudioDecoder() = default;
+
+	/**
+	 * Append the next part of the encoded audio data. The data is copied, so it does not have to remain valid after the call
+	 *
+	 * @param AudioData Pointer to the encoded audio data
+	 * @param AudioDataSize Size of the encoded audio data
+	 */
+	virtual void AppendEncodedData(const uint8* AudioData, int64 AudioDataSize) = 0;
+
+	/**
+	 * Decode as many PCM frames as the appended encoded audio data allows
+	 *
+	 * @param PCMData Decoded interleaved PCM data in the specified storage format. Its previous content is discarded
+	 * @param StorageFormat The storage format to write the PCM data in
+	 * @param bEndOfStream Whether no more encoded audio data will be appended, in which case the remaining data is decoded without waiting for the data following it
+	 * @return The number of decoded frames
+	 */
+	virtual uint32 DecodeFrames(TArray<uint8>& PCMData, EPCMStorageFormat StorageFormat, bool bEndOfStream) = 0;
+
+	/** Get basic audio information (e.g. number of channels, sample rate). Valid only once the format is known */
+	const FSoundWaveBasicStruct& GetSoundWaveBasicInfo() const
+	{
+		return SoundWaveBasicInfo;
+	}
+
+	/** Whether the format of the audio data is known, which is the case once the first frame is decoded */
+	bool IsFormatKnown() const
+	{
+		return bFormatKnown;
+	}
+
+protected:
+	/** Basic audio information, filled in by the derived decoders once the first frame is decoded. The duration is always zero, since the length of the stream is unknown */
+	FSoundWaveBasicStruct SoundWaveBasicInfo;
+
+	/** Whether the basic audio information has been filled in */
+	bool bFormatKnown = false;
+};
@@ -1,3 +1,482 @@
 ﻿// Georgy Treshchev 2022.
 
 #include "RAWTranscoder.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+#define RAW_TRANSCODER_NEON 1
+// Double precision vectors are only available on AArch64
+#define RAW_TRANSCODER_NEON_FLOAT64 PLATFORM_64BITS
+#include <arm_neon.h>
+#elif PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+#define RAW_TRANSCODER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+void RAWTranscoder::ConvertFloatToInt16(const float* InSamples, int16* OutSamples, int64 NumOfSamples)
+{
+	TranscodeSamples(InSamples, OutSamples, NumOfSamples, FSampleMapping{32767., 0., -32767., 32767.});
+}
+
+void RAWTranscoder::ConvertInt16ToFloat(const int16* InSamples, float* OutSamples, int64 NumOfSamples)
+{
+	TranscodeSamples(InSamples, OutSamples, NumOfSamples, FSampleMapping{1. / 32768., 0., -1., 1.});
+}
+
+void RAWTranscoder::TranscodeSamples(const int16* InSamples, float* OutSamples, int64 NumOfSamples, const FSampleMapping& Mapping)
+{
+	const float Scale{static_cast<float>(Mapping.Scale)};
+	const float Offset{static_cast<float>(Mapping.Offset)};
+	const float Min{static_cast<float>(Mapping.Min)};
+	const float Max{static_cast<float>(Mapping.Max)};
+
+	int64 SampleIndex = 0;
+
+#if RAW_TRANSCODER_SSE2
+	const __m128 ScaleVector{_mm_set1_ps(Scale)};
+	const __m128 OffsetVector{_mm_set1_ps(Offset)};
+	const __m128 MinVector{_mm_set1_ps(Min)};
+	const __m128 MaxVector{_mm_set1_ps(Max)};
+
+	for (; SampleIndex + 8 <= NumOfSamples; SampleIndex += 8)
+	{
+		const __m128i Samples{_mm_loadu_si128(reinterpret_cast<const __m128i*>(InSamples + SampleIndex))};
+
+		// Sign-extending to 32-bit integers by moving the samples to the upper halves and arithmetically shifting them back
+		const __m128 LowSamples{_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(Samples, Samples), 16))};
+		const __m128 HighSamples{_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(Samples, Samples), 16))};
+
+		_mm_storeu_ps(OutSamples + SampleIndex, _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(LowSamples, ScaleVector), OffsetVector), MinVector), MaxVector));
+		_mm_storeu_ps(OutSamples + SampleIndex + 4, _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(HighSamples, ScaleVector), OffsetVector), MinVector), MaxVector));
+	}
+#elif RAW_TRANSCODER_NEON
+	const float32x4_t ScaleVector{vdupq_n_f32(Scale)};
+	const float32x4_t OffsetVector{vdupq_n_f32(Offset)};
+	const float32x4_t MinVector{vdupq_n_f32(Min)};
+	const float32x4_t MaxVector{vdupq_n_f32(Max)};
+
+	for (; SampleIndex + 8 <= NumOfSamples; SampleIndex += 8)
+	{
+		const int16x8_t Samples{vld1q_s16(InSamples + SampleIndex)};
+
+		const float32x4_t LowSamples{vcvtq_f32_s32(vmovl_s16(vget_low_s16(Samples)))};
+		const float32x4_t HighSamples{vcvtq_f32_s32(vmovl_s16(vget_high_s16(Samples)))};
+
+		vst1q_f32(OutSamples + SampleIndex, vminq_f32(vmaxq_f32(vaddq_f32(vmulq_f32(LowSamples, ScaleVector), OffsetVector), MinVector), MaxVector));
+		vst1q_f32(OutSamples + SampleIndex + 4, vminq_f32(vmaxq_f32(vaddq_f32(vmulq_f32(HighSamples, ScaleVector), OffsetVector), MinVector), MaxVector));
+	}
+#endif
+
+	// Transcoding the remaining samples (or all of them if there is no vectorized kernel for the platform)
+	for (; SampleIndex < NumOfSamples; ++SampleIndex)
+	{
+		OutSamples[SampleIndex] = FMath::Clamp(InSamples[SampleIndex] * Scale + Offset, Min, Max);
+	}
+}
+
+void RAWTranscoder::TranscodeSamples(const float* InSamples, int16* OutSamples, int64 NumOfSamples, const FSampleMapping& Mapping)
+{
+	const float Scale{static_cast<float>(Mapping.Scale)};
+	const float Offset{static_cast<float>(Mapping.Offset)};
+	const float Min{static_cast<float>(Mapping.Min)};
+	const float Max{static_cast<float>(Mapping.Max)};
+
+	// Iterating forward is safe for in-place transcoding, since every block of input samples is read before the (smaller) output samples are written
+	int64 SampleIndex = 0;
+
+#if RAW_TRANSCODER_SSE2
+	const __m128 ScaleVector{_mm_set1_ps(Scale)};
+	const __m128 OffsetVector{_mm_set1_ps(Offset)};
+	const __m128 MinVector{_mm_set1_ps(Min)};
+	const __m128 MaxVector{_mm_set1_ps(Max)};
+
+	for (; SampleIndex + 8 <= NumOfSamples; SampleIndex += 8)
+	{
+		const __m128 LowSamples{_mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(InSamples + SampleIndex), ScaleVector), OffsetVector), MinVector), MaxVector)};
+		const __m128 HighSamples{_mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(InSamples + SampleIndex + 4), ScaleVector), OffsetVector), MinVector), MaxVector)};
+
+		// Truncating like static_cast does, then packing with saturation
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(OutSamples + SampleIndex), _mm_packs_epi32(_mm_cvttps_epi32(LowSamples), _mm_cvttps_epi32(HighSamples)));
+	}
+#elif RAW_TRANSCODER_NEON
+	const float32x4_t ScaleVector{vdupq_n_f32(Scale)};
+	const float32x4_t OffsetVector{vdupq_n_f32(Offset)};
+	const float32x4_t MinVector{vdupq_n_f32(Min)};
+	const float32x4_t MaxVector{vdupq_n_f32(Max)};
+
+	for (; SampleIndex + 8 <= NumOfSamples; SampleIndex += 8)
+	{
+		const float32x4_t LowSamples{vminq_f32(vmaxq_f32(vaddq_f32(vmulq_f32(vld1q_f32(InSamples + SampleIndex), ScaleVector), OffsetVector), MinVector), MaxVector)};
+		const float32x4_t HighSamples{vminq_f32(vmaxq_f32(vaddq_f32(vmulq_f32(vld1q_f32(InSamples + SampleIndex + 4), ScaleVector), OffsetVector), MinVector), MaxVector)};
+
+		vst1q_s16(OutSamples + SampleIndex, vcombine_s16(vqmovn_s32(vcvtq_s32_f32(LowSamples)), vqmovn_s32(vcvtq_s32_f32(HighSamples))));
+	}
+#endif
+
+	for (; SampleIndex < NumOfSamples; ++SampleIndex)
+	{
+		OutSamples[SampleIndex] = static_cast<int16>(FMath::Clamp(InSamples[SampleIndex] * Scale + Offset, Min, Max));
+	}
+}
+
+void RAWTranscoder::TranscodeSamples(const int32* InSamples, float* OutSamples, int64 NumOfSamples, const FSampleMapping& Mapping)
+{
+	// Mapping in double precision like the scalar kernel does, since 32-bit samples do not fit into the float mantissa
+	int64 SampleIndex = 0;
+
+#if RAW_TRANSCODER_SSE2
+	const __m128d ScaleVector{_mm_set1_pd(Mapping.Scale)};
+	const __m128d OffsetVector{_mm_set1_pd(Mapping.Offset)};
+	const __m128d MinVector{_mm_set1_pd(Mapping.Min)};
+	const __m128d MaxVector{_mm_set1_pd(Mapping.Max)};
+
+	for (; SampleIndex + 4 <= NumOfSamples; SampleIndex += 4)
+	{
+		const __m128i Samples{_mm_loadu_si128(reinterpret_cast<const __m128i*>(InSamples + SampleIndex))};
+
+		const __m128d LowSamples{_mm_cvtepi32_pd(Samples)};
+		const __m128d HighSamples{_mm_cvtepi32_pd(_mm_shuffle_epi32(Samples, _MM_SHUFFLE(3, 2, 3, 2)))};
+
+		const __m128 LowResult{_mm_cvtpd_ps(_mm_min_pd(_mm_max_pd(_mm_add_pd(_mm_mul_pd(LowSamples, ScaleVector), OffsetVector), MinVector), MaxVector))};
+		const __m128 HighResult{_mm_cvtpd_ps(_mm_min_pd(_mm_max_pd(_mm_add_pd(_mm_mul_pd(HighSamples, ScaleVector), OffsetVector), MinVector), MaxVector))};
+
+		_mm_storeu_ps(OutSamples + SampleIndex, _mm_movelh_ps(LowResult, HighResult));
+	}
+#elif RAW_TRANSCODER_NEON_FLOAT64
+	const float64x2_t ScaleVector{vdupq_n_f64(Mapping.Scale)};
+	const float64x2_t OffsetVector{vdupq_n_f64(Mapping.Offset)};
+	const float64x2_t MinVector{vdupq_n_f64(Mapping.Min)};
+	const float64x2_t MaxVector{vdupq_n_f64(Mapping.Max)};
+
+	for (; SampleIndex + 4 <= NumOfSamples; SampleIndex += 4)
+	{
+		const int32x4_t Samples{vld1q_s32(InSamples + SampleIndex)};
+
+		const float64x2_t LowSamples{vcvtq_f64_s64(vmovl_s32(vget_low_s32(Samples)))};
+		const float64x2_t HighSamples{vcvtq_f64_s64(vmovl_s32(vget_high_s32(Samples)))};
+
+		const float32x2_t LowResult{vcvt_f32_f64(vminq_f64(vmaxq_f64(vaddq_f64(vmulq_f64(LowSamples, ScaleVector), OffsetVector), MinVector), MaxVector))};
+		const float32x2_t HighResult{vcvt_f32_f64(vminq_f64(vmaxq_f64(vaddq_f64(vmulq_f64(HighSamples, ScaleVector), OffsetVector), MinVector), MaxVector))};
+
+		vst1q_f32(OutSamples + SampleIndex, vcombine_f32(LowResult, HighResult));
+	}
+#endif
+
+	for (; SampleIndex < NumOfSamples; ++SampleIndex)
+	{
+		OutSamples[SampleIndex] = static_cast<float>(FMath::Clamp(InSamples[SampleIndex] * Mapping.Scale + Mapping.Offset, Mapping.Min, Mapping.Max));
+	}
+}
+
+void RAWTranscoder::TranscodeSamples(const float* InSamples, int32* OutSamples, int64 NumOfSamples, const FSampleMapping& Mapping)
+{
+	// Mapping in double precision, since the maximum 32-bit sample is not representable as a float and would overflow on conversion
+	int64 SampleIndex = 0;
+
+#if RAW_TRANSCODER_SSE2
+	const __m128d ScaleVector{_mm_set1_pd(Mapping.Scale)};
+	const __m128d OffsetVector{_mm_set1_pd(Mapping.Offset)};
+	const __m128d MinVector{_mm_set1_pd(Mapping.Min)};
+	const __m128d MaxVector{_mm_set1_pd(Mapping.Max)};
+
+	for (; SampleIndex + 4 <= NumOfSamples; SampleIndex += 4)
+	{
+		const __m128 Samples{_mm_loadu_ps(InSamples + SampleIndex)};
+
+		const __m128d LowSamples{_mm_cvtps_pd(Samples)};
+		const __m128d HighSamples{_mm_cvtps_pd(_mm_movehl_ps(Samples, Samples))};
+
+		const __m128i LowResult{_mm_cvttpd_epi32(_mm_min_pd(_mm_max_pd(_mm_add_pd(_mm_mul_pd(LowSamples, ScaleVector), OffsetVector), MinVector), MaxVector))};
+		const __m128i HighResult{_mm_cvttpd_epi32(_mm_min_pd(_mm_max_pd(_mm_add_pd(_mm_mul_pd(HighSamples, ScaleVector), OffsetVector), MinVector), MaxVector))};
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(OutSamples + SampleIndex), _mm_unpacklo_epi64(LowResult, HighResult));
+	}
+#elif RAW_TRANSCODER_NEON_FLOAT64
+	const float64x2_t ScaleVector{vdupq_n_f64(Mapping.Scale)};
+	const float64x2_t OffsetVector{vdupq_n_f64(Mapping.Offset)};
+	const float64x2_t MinVector{vdupq_n_f64(Mapping.Min)};
+	const float64x2_t MaxVector{vdupq_n_f64(Mapping.Max)};
+
+	for (; SampleIndex + 4 <= NumOfSamples; SampleIndex += 4)
+	{
+		const float32x4_t Samples{vld1q_f32(InSamples + SampleIndex)};
+
+		const float64x2_t LowSamples{vcvt_f64_f32(vget_low_f32(Samples))};
+		const float64x2_t HighSamples{vcvt_f64_f32(vget_high_f32(Samples))};
+
+		const int32x2_t LowResult{vmovn_s64(vcvtq_s64_f64(vminq_f64(vmaxq_f64(vaddq_f64(vmulq_f64(LowSamples, ScaleVector), OffsetVector), MinVector), MaxVector)))};
+		const int32x2_t HighResult{vmovn_s64(vcvtq_s64_f64(vminq_f64(vmaxq_f64(vaddq_f64(vmulq_f64(HighSamples, ScaleVector), OffsetVector), MinVector), MaxVector)))};
+
+		vst1q_s32(OutSamples + SampleIndex, vcombine_s32(LowResult, HighResult));
+	}
+#endif
+
+	for (; SampleIndex < NumOfSamples; ++SampleIndex)
+	{
+		OutSamples[SampleIndex] = static_cast<int32>(FMath::Clamp(InSamples[SampleIndex] * Mapping.Scale + Mapping.Offset, Mapping.Min, Mapping.Max));
+	}
+}
+
+void RAWTranscoder::TranscodeSamples(const uint8* InSamples, float* OutSamples, int64 NumOfSamples, const FSampleMapping& Mapping)
+{
+	const float Scale{static_cast<float>(Mapping.Scale)};
+	const float Offset{static_cast<float>(Mapping.Offset)};
+	const float Min{static_cast<float>(Mapping.Min)};
+	const float Max{static_cast<float>(Mapping.Max)};
+
+	int64 SampleIndex = 0;
+
+#if RAW_TRANSCODER_SSE2
+	const __m128 ScaleVector{_mm_set1_ps(Scale)};
+	const __m128 OffsetVector{_mm_set1_ps(Offset)};
+	const __m128 MinVector{_mm_set1_ps(Min)};
+	const __m128 MaxVector{_mm_set1_ps(Max)};
+	const __m128i ZeroVector{_mm_setzero_si128()};
+
+	for (; SampleIndex + 16 <= NumOfSamples; SampleIndex += 16)
+	{
+		const __m128i Samples{_mm_loadu_si128(reinterpret_cast<const __m128i*>(InSamples + SampleIndex))};
+
+		// Zero-extending to 32-bit integers by interleaving the samples with zeros
+		const __m128i LowSamples{_mm_unpacklo_epi8(Samples, ZeroVector)};
+		const __m128i HighSamples{_mm_unpackhi_epi8(Samples, ZeroVector)};
+
+		const __m128 QuarterSamples[4]{
+			_mm_cvtepi32_ps(_mm_unpacklo_epi16(LowSamples, ZeroVector)), _mm_cvtepi32_ps(_mm_unpackhi_epi16(LowSamples, ZeroVector)),
+			_mm_cvtepi32_ps(_mm_unpacklo_epi16(HighSamples, ZeroVector)), _mm_cvtepi32_ps(_mm_unpackhi_epi16(HighSamples, ZeroVector))
+		};
+
+		for (int32 QuarterIndex = 0; QuarterIndex < 4; ++QuarterIndex)
+		{
+			_mm_storeu_ps(OutSamples + SampleIndex + QuarterIndex * 4, _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(QuarterSamples[QuarterIndex], ScaleVector), OffsetVector), MinVector), MaxVector));
+		}
+	}
+#elif RAW_TRANSCODER_NEON
+	const float32x4_t ScaleVector{vdupq_n_f32(Scale)};
+	const float32x4_t OffsetVector{vdupq_n_f32(Offset)};
+	const float32x4_t MinVector{vdupq_n_f32(Min)};
+	const float32x4_t MaxVector{vdupq_n_f32(Max)};
+
+	for (; SampleIndex + 16 <= NumOfSamples; SampleIndex += 16)
+	{
+		const uint8x16_t Samples{vld1q_u8(InSamples + SampleIndex)};
+
+		const uint16x8_t LowSamples{vmovl_u8(vget_low_u8(Samples))};
+		const uint16x8_t HighSamples{vmovl_u8(vget_high_u8(Samples))};
+
+		const float32x4_t QuarterSamples[4]{
+			vcvtq_f32_u32(vmovl_u16(vget_low_u16(LowSamples))), vcvtq_f32_u32(vmovl_u16(vget_high_u16(LowSamples))),
+			vcvtq_f32_u32(vmovl_u16(vget_low_u16(HighSamples))), vcvtq_f32_u32(vmovl_u16(vget_high_u16(HighSamples)))
+		};
+
+		for (int32 QuarterIndex = 0; QuarterIndex < 4; ++QuarterIndex)
+		{
+			vst1q_f32(OutSamples + SampleIndex + QuarterIndex * 4, vminq_f32(vmaxq_f32(vaddq_f32(vmulq_f32(QuarterSamples[QuarterIndex], ScaleVector), OffsetVector), MinVector), MaxVector));
+		}
+	}
+#endif
+
+	for (; SampleIndex < NumOfSamples; ++SampleIndex)
+	{
+		OutSamples[SampleIndex] = FMath::Clamp(InSamples[SampleIndex] * Scale + Offset, Min, Max);
+	}
+}
+
+void RAWTranscoder::TranscodeSamples(const float* InSamples, uint8* OutSamples, int64 NumOfSamples, const FSampleMapping& Mapping)
+{
+	const float Scale{static_cast<float>(Mapping.Scale)};
+	const float Offset{static_cast<float>(Mapping.Offset)};
+	const float Min{static_cast<float>(Mapping.Min)};
+	const float Max{static_cast<float>(Mapping.Max)};
+
+	// Iterating forward is safe for in-place transcoding, since every block of input samples is read before the (smaller) output samples are written
+	int64 SampleIndex = 0;
+
+#if RAW_TRANSCODER_SSE2
+	const __m128 ScaleVector{_mm_set1_ps(Scale)};
+	const __m128 OffsetVector{_mm_set1_ps(Offset)};
+	const __m128 MinVector{_mm_set1_ps(Min)};
+	const __m128 MaxVector{_mm_set1_ps(Max)};
+
+	for (; SampleIndex + 16 <= NumOfSamples; SampleIndex += 16)
+	{
+		__m128i QuarterResults[4];
+		for (int32 QuarterIndex = 0; QuarterIndex < 4; ++QuarterIndex)
+		{
+			// Truncating like static_cast does. The clamped values fit into 16 bits, so the packing below never saturates them
+			QuarterResults[QuarterIndex] = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(InSamples + SampleIndex + QuarterIndex * 4), ScaleVector), OffsetVector), MinVector), MaxVector));
+		}
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(OutSamples + SampleIndex), _mm_packus_epi16(_mm_packs_epi32(QuarterResults[0], QuarterResults[1]), _mm_packs_epi32(QuarterResults[2], QuarterResults[3])));
+	}
+#elif RAW_TRANSCODER_NEON
+	const float32x4_t ScaleVector{vdupq_n_f32(Scale)};
+	const float32x4_t OffsetVector{vdupq_n_f32(Offset)};
+	const float32x4_t MinVector{vdupq_n_f32(Min)};
+	const float32x4_t MaxVector{vdupq_n_f32(Max)};
+
+	for (; SampleIndex + 16 <= NumOfSamples; SampleIndex += 16)
+	{
+		uint16x4_t QuarterResults[4];
+		for (int32 QuarterIndex = 0; QuarterIndex < 4; ++QuarterIndex)
+		{
+			QuarterResults[QuarterIndex] = vqmovun_s32(vcvtq_s32_f32(vminq_f32(vmaxq_f32(vaddq_f32(vmulq_f32(vld1q_f32(InSamples + SampleIndex + QuarterIndex * 4), ScaleVector), OffsetVector), MinVector), MaxVector)));
+		}
+
+		vst1q_u8(OutSamples + SampleIndex, vcombine_u8(vqmovn_u16(vcombine_u16(QuarterResults[0], QuarterResults[1])), vqmovn_u16(vcombine_u16(QuarterResults[2], QuarterResults[3]))));
+	}
+#endif
+
+	for (; SampleIndex < NumOfSamples; ++SampleIndex)
+	{
+		OutSamples[SampleIndex] = static_cast<uint8>(FMath::Clamp(InSamples[SampleIndex] * Scale + Offset, Min, Max));
+	}
+}
+
+namespace
+{
+	template <typename IntegralTypeFrom>
+	void TranscodeSamplesFrom(const IntegralTypeFrom* InSamples, uint8* OutSamples, ERAWAudioFormat FormatTo, int64 NumOfSamples)
+	{
+		switch (FormatTo)
+		{
+		case ERAWAudioFormat::Int16:
+			{
+				RAWTranscoder::TranscodeSamples<IntegralTypeFrom, int16>(InSamples, reinterpret_cast<int16*>(OutSamples), NumOfSamples);
+				break;
+			}
+		case ERAWAudioFormat::Int32:
+			{
+				RAWTranscoder::TranscodeSamples<IntegralTypeFrom, int32>(InSamples, reinterpret_cast<int32*>(OutSamples), NumOfSamples);
+				break;
+			}
+		case ERAWAudioFormat::UInt8:
+			{
+				RAWTranscoder::TranscodeSamples<IntegralTypeFrom, uint8>(InSamples, OutSamples, NumOfSamples);
+				break;
+			}
+		case ERAWAudioFormat::Float32:
+			{
+				RAWTranscoder::TranscodeSamples<IntegralTypeFrom, float>(InSamples, reinterpret_cast<float*>(OutSamples), NumOfSamples);
+				break;
+			}
+		}
+	}
+
+	/** Transcoding samples between two different formats stored in non-overlapping memory */
+	void TranscodeSamplesBetweenFormats(const uint8* InSamples, ERAWAudioFormat FormatFrom, uint8* OutSamples, ERAWAudioFormat FormatTo, int64 NumOfSamples)
+	{
+		switch (FormatFrom)
+		{
+		case ERAWAudioFormat::Int16:
+			{
+				TranscodeSamplesFrom(reinterpret_cast<const int16*>(InSamples), OutSamples, FormatTo, NumOfSamples);
+				break;
+			}
+		case ERAWAudioFormat::Int32:
+			{
+				TranscodeSamplesFrom(reinterpret_cast<const int32*>(InSamples), OutSamples, FormatTo, NumOfSamples);
+				break;
+			}
+		case ERAWAudioFormat::UInt8:
+			{
+				TranscodeSamplesFrom(InSamples, OutSamples, FormatTo, NumOfSamples);
+				break;
+			}
+		case ERAWAudioFormat::Float32:
+			{
+				TranscodeSamplesFrom(reinterpret_cast<const float*>(InSamples), OutSamples, FormatTo, NumOfSamples);
+				break;
+			}
+		}
+	}
+}
+
+int32 RAWTranscoder::GetSampleSize(ERAWAudioFormat Format)
+{
+	switch (Format)
+	{
+	case ERAWAudioFormat::Int16:
+		return sizeof(int16);
+	case ERAWAudioFormat::Int32:
+		return sizeof(int32);
+	case ERAWAudioFormat::UInt8:
+		return sizeof(uint8);
+	case ERAWAudioFormat::Float32:
+		return sizeof(float);
+	}
+
+	return sizeof(float);
+}
+
+void RAWTranscoder::TranscodeSamples(const uint8* InSamples, ERAWAudioFormat FormatFrom, uint8* OutSamples, ERAWAudioFormat FormatTo, int64 NumOfSamples)
+{
+	const int64 SampleSizeFrom{GetSampleSize(FormatFrom)};
+	const int64 SampleSizeTo{GetSampleSize(FormatTo)};
+
+	if (FormatFrom == FormatTo)
+	{
+		if (InSamples != OutSamples)
+		{
+			FMemory::Memcpy(OutSamples, InSamples, NumOfSamples * SampleSizeFrom);
+		}
+		return;
+	}
+
+	if (InSamples != OutSamples)
+	{
+		TranscodeSamplesBetweenFormats(InSamples, FormatFrom, OutSamples, FormatTo, NumOfSamples);
+		return;
+	}
+
+	/**
+	 * Transcoding in-place block by block through a small intermediate buffer so that the kernels never work on aliased memory.
+	 * Shrinking samples are transcoded front to back and growing ones back to front, so a written block never overwrites input samples that have not been read yet
+	 */
+	constexpr int64 NumOfBlockSamples{1024};
+	alignas(16) uint8 BlockSamples[NumOfBlockSamples * sizeof(int32)];
+
+	const int64 NumOfBlocks{(NumOfSamples + NumOfBlockSamples - 1) / NumOfBlockSamples};
+	for (int64 Index = 0; Index < NumOfBlocks; ++Index)
+	{
+		const int64 BlockIndex{SampleSizeTo <= SampleSizeFrom ? Index : NumOfBlocks - 1 - Index};
+		const int64 FirstSampleIndex{BlockIndex * NumOfBlockSamples};
+		const int64 NumOfSamplesInBlock{FMath::Min(NumOfBlockSamples, NumOfSamples - FirstSampleIndex)};
+
+		TranscodeSamplesBetweenFormats(InSamples + FirstSampleIndex * SampleSizeFrom, FormatFrom, BlockSamples, FormatTo, NumOfSamplesInBlock);
+		FMemory::Memcpy(OutSamples + FirstSampleIndex * SampleSizeTo, BlockSamples, NumOfSamplesInBlock * SampleSizeTo);
+	}
+}
+
+void RAWTranscoder::ConvertPCMStorageFormat(FPCMStruct& PCMInfo, EPCMStorageFormat StorageFormat)
+{
+	if (PCMInfo.StorageFormat == StorageFormat)
+	{
+		return;
+	}
+
+	const int64 NumOfSamples{PCMInfo.PCMData.GetView().Num() / static_cast<int64>(PCMInfo.GetSampleSize())};
+
+	switch (StorageFormat)
+	{
+	case EPCMStorageFormat::Int16:
+		{
+			const int64 PCMDataSize{NumOfSamples * static_cast<int64>(sizeof(int16))};
+			int16* PCMData = static_cast<int16*>(FMemory::Malloc(PCMDataSize));
+			ConvertFloatToInt16(reinterpret_cast<float*>(PCMInfo.PCMData.GetView().GetData()), PCMData, NumOfSamples);
+
+			PCMInfo.PCMData = FRuntimeBulkDataBuffer<uint8>(reinterpret_cast<uint8*>(PCMData), PCMDataSize);
+			break;
+		}
+	case EPCMStorageFormat::Float32:
+		{
+			const int64 PCMDataSize{NumOfSamples * static_cast<int64>(sizeof(float))};
+			float* PCMData = static_cast<float*>(FMemory::Malloc(PCMDataSize));
+			ConvertInt16ToFloat(reinterpret_cast<int16*>(PCMInfo.PCMData.GetView().GetData()), PCMData, NumOfSamples);
+
+			PCMInfo.PCMData = FRuntimeBulkDataBuffer<uint8>(reinterpret_cast<uint8*>(PCMData), PCMDataSize);
+			break;
+		}
+	}
+
+	PCMInfo.StorageFormat = StorageFormat;
+}
@@ -5,10 +5,54 @@
 #include "CoreMinimal.h"
 #include "Math/UnrealMathUtility.h"
 #include "RuntimeAudioImporterDefines.h"
+#include "RuntimeAudioImporterTypes.h"
 
 class RUNTIMEAUDIOIMPORTER_API RAWTranscoder
 {
 public:
+	/**
+	 * Convert 32-bit float samples to signed 16-bit samples. The input and output may point to the same memory
+	 *
+	 * @param InSamples Samples to convert
+	 * @param OutSamples Converted samples
+	 * @param NumOfSamples Number of samples to convert
+	 */
+	static void ConvertFloatToInt16(const float* InSamples, int16* OutSamples, int64 NumOfSamples);
+
+	/**
+	 * Convert signed 16-bit samples to 32-bit float samples
+	 *
+	 * @param InSamples Samples to convert
+	 * @param OutSamples Converted samples
+	 * @param NumOfSamples Number of samples to convert
+	 */
+	static void ConvertInt16ToFloat(const int16* InSamples, float* OutSamples, int64 NumOfSamples);
+
+	/**
+	 * Convert PCM data to the specified storage format
+	 *
+	 * @param PCMInfo PCM data to convert
+	 * @param StorageFormat The storage format to convert to
+	 */
+	static void ConvertPCMStorageFormat(FPCMStruct& PCMInfo, EPCMStorageFormat StorageFormat);
+
+	/**
+	 * Get the size of a single sample of the specified RAW format, in bytes
+	 */
+	static int32 GetSampleSize(ERAWAudioFormat Format);
+
+	/**
+	 * Transcoding samples between RAW formats specified at runtime, without any intermediate buffers
+	 *
+	 * @param InSamples Samples to transcode
+	 * @param FormatFrom Original format
+	 * @param OutSamples Transcoded samples
+	 * @param FormatTo Required format
+	 * @param NumOfSamples Number of samples to transcode
+	 * @note In-place transcoding (InSamples == OutSamples) is supported, as long as the memory is large enough to hold the samples of both formats
+	 */
+	static void TranscodeSamples(const uint8* InSamples, ERAWAudioFormat FormatFrom, uint8* OutSamples, ERAWAudioFormat FormatTo, int64 NumOfSamples);
+
 	/**
 	 * Getting the minimum and maximum values of the specified RAW format
 	 *
@@ -47,21 +91,17 @@ public:
 	/**
 	 * Transcoding one RAW Data format to another
 	 *
-	 * @param RAWData_From RAW data for transcoding
+	 * @param RAWData_From RAW data for transcoding. Must not be the same array as RAWData_To
 	 * @param RAWData_To Transcoded RAW data with the specified format
 	 */
 	template <typename IntegralTypeFrom, typename IntegralTypeTo>
-	static void TranscodeRAWData(TArray<uint8> RAWData_From, TArray<uint8>& RAWData_To)
+	static void TranscodeRAWData(const TArray<uint8>& RAWData_From, TArray<uint8>& RAWData_To)
 	{
-		IntegralTypeFrom* DataFrom = reinterpret_cast<IntegralTypeFrom*>(RAWData_From.GetData());
-		const int32 DataFrom_Size = RAWData_From.Num();
-
-		IntegralTypeTo* DataTo = nullptr;
-		int32 DataTo_Size = 0;
+		const int32 NumSamples = RAWData_From.Num() / sizeof(IntegralTypeFrom);
 
-		TranscodeRAWData<IntegralTypeFrom, IntegralTypeTo>(DataFrom, DataFrom_Size, DataTo, DataTo_Size);
+		RAWData_To.SetNumUninitialized(NumSamples * sizeof(IntegralTypeTo));
 
-		RAWData_To = TArray<uint8>(reinterpret_cast<uint8*>(DataTo), DataTo_Size);
+		TranscodeSamples<IntegralTypeFrom, IntegralTypeTo>(reinterpret_cast<const IntegralTypeFrom*>(RAWData_From.GetData()), reinterpret_cast<IntegralTypeTo*>(RAWData_To.GetData()), NumSamples);
 	}
 
 	/**
@@ -81,22 +121,106 @@ public:
 		/** Getting the required PCM size */
 		RAWDataSize_To = NumSamples * sizeof(IntegralTypeTo);
 
-		/** Creating an empty PCM buffer */
-		IntegralTypeTo* TempPCMData = static_cast<IntegralTypeTo*>(FMemory::MallocZeroed(RAWDataSize_To));
+		/** Creating a PCM buffer. There is no need to zero it since every sample is overwritten */
+		RAWData_To = static_cast<IntegralTypeTo*>(FMemory::Malloc(RAWDataSize_To));
+
+		TranscodeSamples<IntegralTypeFrom, IntegralTypeTo>(RAWData_From, RAWData_To, NumSamples);
+
+		const TTuple<float, float> MinAndMaxValuesFrom{GetRawMinAndMaxValues<IntegralTypeFrom>()};
+		const TTuple<float, float> MinAndMaxValuesTo{GetRawMinAndMaxValues<IntegralTypeTo>()};
+
+		UE_LOG(LogRuntimeAudioImporter, Log, TEXT("Transcoding RAW data of size '%d' (min: %f, max: %f) to size '%d' (min: %f, max: %f)"),
+		       static_cast<int32>(sizeof(IntegralTypeFrom)), MinAndMaxValuesFrom.Key, MinAndMaxValuesFrom.Value, static_cast<int32>(sizeof(IntegralTypeTo)), MinAndMaxValuesTo.Key, MinAndMaxValuesTo.Value);
+	}
+
+	/**
+	 * Linear mapping of sample values from one RAW format to another, clamped to the range of the target format
+	 */
+	struct FSampleMapping
+	{
+		double Scale;
+		double Offset;
+		double Min;
+		double Max;
+	};
 
+	/**
+	 * Getting the sample mapping between the specified RAW formats
+	 */
+	template <typename IntegralTypeFrom, typename IntegralTypeTo>
+	static FSampleMapping GetSampleMapping()
+	{
 		const TTuple<float, float> MinAndMaxValuesFrom{GetRawMinAndMaxValues<IntegralTypeFrom>()};
 		const TTuple<float, float> MinAndMaxValuesTo{GetRawMinAndMaxValues<IntegralTypeTo>()};
 
-		/** Iterating through the RAW Data to transcode values using a divisor */
-		for (int32 SampleIndex = 0; SampleIndex < NumSamples; ++SampleIndex)
+		FSampleMapping Mapping;
+		Mapping.Scale = (static_cast<double>(MinAndMaxValuesTo.Value) - MinAndMaxValuesTo.Key) / (static_cast<double>(MinAndMaxValuesFrom.Value) - MinAndMaxValuesFrom.Key);
+		Mapping.Offset = MinAndMaxValuesTo.Key - MinAndMaxValuesFrom.Key * Mapping.Scale;
+		Mapping.Min = MinAndMaxValuesTo.Key;
+		Mapping.Max = MinAndMaxValuesTo.Value;
+
+		/** The ranges of some integer formats slightly exceed their numeric limits, so clamping to them as well to avoid overflowing on conversion */
+		if (TIsIntegral<IntegralTypeTo>::Value)
 		{
-			TempPCMData[SampleIndex] = static_cast<IntegralTypeTo>(FMath::GetMappedRangeValueClamped(FVector2D(MinAndMaxValuesFrom.Key, MinAndMaxValuesFrom.Value), FVector2D(MinAndMaxValuesTo.Key, MinAndMaxValuesTo.Value), RAWData_From[SampleIndex]));
+			Mapping.Min = FMath::Max<double>(Mapping.Min, TNumericLimits<IntegralTypeTo>::Lowest());
+			Mapping.Max = FMath::Min<double>(Mapping.Max, TNumericLimits<IntegralTypeTo>::Max());
 		}
 
-		/** Returning the transcoded data as bytes */
-		RAWData_To = reinterpret_cast<IntegralTypeTo*>(TempPCMData);
+		return Mapping;
+	}
 
-		UE_LOG(LogRuntimeAudioImporter, Log, TEXT("Transcoding RAW data of size '%d' (min: %f, max: %f) to size '%d' (min: %f, max: %f)"),
-		       static_cast<int32>(sizeof(IntegralTypeFrom)), MinAndMaxValuesFrom.Key, MinAndMaxValuesFrom.Value, static_cast<int32>(sizeof(IntegralTypeTo)), MinAndMaxValuesTo.Key, MinAndMaxValuesTo.Value);
+	/**
+	 * Transcoding samples from one RAW format to another. The input and output may point to the same memory if the output samples are not larger than the input ones
+	 *
+	 * @param InSamples Samples to transcode
+	 * @param OutSamples Transcoded samples
+	 * @param NumOfSamples Number of samples to transcode
+	 */
+	template <typename IntegralTypeFrom, typename IntegralTypeTo>
+	static void TranscodeSamples(const IntegralTypeFrom* InSamples, IntegralTypeTo* OutSamples, int64 NumOfSamples)
+	{
+		TranscodeSamples(InSamples, OutSamples, NumOfSamples, GetSampleMapping<IntegralTypeFrom, IntegralTypeTo>());
 	}
+
+	/**
+	 * Transcoding samples using the specified mapping. Scalar kernel used for the integer to integer formats, which have no vectorized one since they are only transcoded on explicit request
+	 */
+	template <typename IntegralTypeFrom, typename IntegralTypeTo>
+	static void TranscodeSamples(const IntegralTypeFrom* InSamples, IntegralTypeTo* OutSamples, int64 NumOfSamples, const FSampleMapping& Mapping)
+	{
+		for (int64 SampleIndex = 0; SampleIndex < NumOfSamples; ++SampleIndex)
+		{
+			OutSamples[SampleIndex] = static_cast<IntegralTypeTo>(FMath::Clamp(InSamples[SampleIndex] * Mapping.Scale + Mapping.Offset, Mapping.Min, Mapping.Max));
+		}
+	}
+
+	/**
+	 * Transcoding signed 16-bit samples to 32-bit float samples using the specified mapping. Vectorized on SSE2 and NEON
+	 */
+	static void TranscodeSamples(const int16* InSamples, float* OutSamples, int64 NumOfSamples, const FSampleMapping& Mapping);
+
+	/**
+	 * Transcoding 32-bit float samples to signed 16-bit samples using the specified mapping. Vectorized on SSE2 and NEON
+	 */
+	static void TranscodeSamples(const float* InSamples, int16* OutSamples, int64 NumOfSamples, const FSampleMapping& Mapping);
+
+	/**
+	 * Transcoding signed 32-bit samples to 32-bit float samples using the specified mapping. Vectorized on SSE2 and AArch64 NEON, in double precision
+	 */
+	static void TranscodeSamples(const int32* InSamples, float* OutSamples, int64 NumOfSamples, const FSampleMapping& Mapping);
+
+	/**
+	 * Transcoding 32-bit float samples to signed 32-bit samples using the specified mapping. Vectorized on SSE2 and AArch64 NEON, in double precision
+	 */
+	static void TranscodeSamples(const float* InSamples, int32* OutSamples, int64 NumOfSamples, const FSampleMapping& Mapping);
+
+	/**
+	 * Transcoding unsigned 8-bit samples to 32-bit float samples using the specified mapping. Vectorized on SSE2 and NEON
+	 */
+	static void TranscodeSamples(const uint8* InSamples, float* OutSamples, int64 NumOfSamples, const FSampleMapping& Mapping);
+
+	/**
+	 * Transcoding 32-bit float samples to unsigned 8-bit samples using the specified mapping. Vectorized on SSE2 and NEON
+	 */
+	static void TranscodeSamples(const float* InSamples, uint8* OutSamples, int64 NumOfSamples, const FSampleMapping& Mapping);
 };
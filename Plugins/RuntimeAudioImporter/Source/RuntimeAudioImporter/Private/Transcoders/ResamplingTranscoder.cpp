@@ -0,0 +1,292 @@
+﻿// Georgy Treshchev 2022.
+
+#include "Transcoders/ResamplingTranscoder.h"
+#include "Transcoders/RAWTranscoder.h"
+#include "RuntimeAudioImporterDefines.h"
+
+#include "Async/ParallelFor.h"
+#include "Math/VectorRegister.h"
+
+namespace
+{
+	/** The maximum number of filter phases. Conversions between rates with a larger interpolation factor use the nearest phase */
+	constexpr uint32 MaxNumOfPhases{1024};
+
+	/** The number of zero crossings of the sinc function on each side of the filter, when not downsampling */
+	constexpr int32 NumOfZeroCrossings{16};
+
+	/** The maximum number of taps on each side of the filter, limiting the filter length when downsampling by a large factor */
+	constexpr int32 MaxHalfNumOfTaps{64};
+
+	/** Cutoff frequency relative to the lower of the two Nyquist frequencies, leaving room for the transition band */
+	constexpr double CutoffRatio{0.95};
+
+	/** Shape of the Kaiser window, trading the transition width for the stopband attenuation (about 90 dB) */
+	constexpr double KaiserBeta{8.6};
+
+	/** The number of output frames resampled per parallel task */
+	constexpr uint32 NumOfFramesPerTask{16384};
+
+	/**
+	 * Zeroth-order modified Bessel function of the first kind, used by the Kaiser window
+	 */
+	double BesselI0(double Value)
+	{
+		double Sum{1.};
+		double Term{1.};
+		const double HalfValueSquared{Value * Value / 4.};
+
+		for (int32 Index = 1; Index < 64 && Term > Sum * 1e-12; ++Index)
+		{
+			Term *= HalfValueSquared / (static_cast<double>(Index) * Index);
+			Sum += Term;
+		}
+
+		return Sum;
+	}
+
+	/**
+	 * Polyphase filter converting between two sample rates. Phase P holds the taps of the windowed sinc delayed by P / NumOfPhases input samples
+	 */
+	struct FPolyphaseFilter
+	{
+		FPolyphaseFilter(uint32 SourceSampleRate, uint32 TargetSampleRate)
+		{
+			const uint32 Divisor{FMath::GreatestCommonDivisor(SourceSampleRate, TargetSampleRate)};
+
+			Interpolation = TargetSampleRate / Divisor;
+			Decimation = SourceSampleRate / Divisor;
+			NumOfPhases = FMath::Min(Interpolation, MaxNumOfPhases);
+
+			// When downsampling, the cutoff is lowered to the target Nyquist frequency, and the filter is stretched accordingly
+			const double Cutoff{FMath::Min(1., static_cast<double>(TargetSampleRate) / SourceSampleRate) * CutoffRatio};
+
+			// The number of taps is kept a multiple of four, so that the dot products have no scalar remainder
+			HalfNumOfTaps = FMath::Min(FMath::CeilToInt(NumOfZeroCrossings / Cutoff), MaxHalfNumOfTaps);
+			HalfNumOfTaps = Align(HalfNumOfTaps, 2);
+			NumOfTaps = HalfNumOfTaps * 2;
+
+			Coefficients.SetNumUninitialized(NumOfPhases * NumOfTaps);
+
+			const double KaiserNormalization{1. / BesselI0(KaiserBeta)};
+
+			for (uint32 PhaseIndex = 0; PhaseIndex < NumOfPhases; ++PhaseIndex)
+			{
+				const double Delay{static_cast<double>(PhaseIndex) / NumOfPhases};
+				float* PhaseCoefficients = Coefficients.GetData() + PhaseIndex * NumOfTaps;
+
+				double Sum{0.};
+
+				for (int32 TapIndex = 0; TapIndex < NumOfTaps; ++TapIndex)
+				{
+					// Distance from the tap to the output position, in input samples
+					const double Time{(TapIndex - HalfNumOfTaps + 1) - Delay};
+					const double WindowPosition{Time / HalfNumOfTaps};
+
+					double Coefficient{0.};
+
+					if (FMath::Abs(WindowPosition) < 1.)
+					{
+						const double SincArgument{PI * Cutoff * Time};
+						const double Sinc{FMath::IsNearlyZero(SincArgument) ? 1. : FMath::Sin(SincArgument) / SincArgument};
+						const double Window{BesselI0(KaiserBeta * FMath::Sqrt(1. - WindowPosition * WindowPosition)) * KaiserNormalization};
+
+						Coefficient = Cutoff * Sinc * Window;
+					}
+
+					PhaseCoefficients[TapIndex] = static_cast<float>(Coefficient);
+					Sum += Coefficient;
+				}
+
+				// Normalizing each phase to unity gain, so that the phases do not modulate the signal level
+				for (int32 TapIndex = 0; TapIndex < NumOfTaps; ++TapIndex)
+				{
+					PhaseCoefficients[TapIndex] = static_cast<float>(PhaseCoefficients[TapIndex] / Sum);
+				}
+			}
+		}
+
+		/**
+		 * Get the input frame and the filter phase of the output frame
+		 *
+		 * @param OutFrameIndex Index of the output frame
+		 * @param InFrameIndex Index of the input frame preceding the output frame
+		 * @param PhaseIndex Index of the filter phase
+		 */
+		void GetInputPosition(uint64 OutFrameIndex, uint64& InFrameIndex, uint32& PhaseIndex) const
+		{
+			const uint64 Position{OutFrameIndex * Decimation};
+
+			InFrameIndex = Position / Interpolation;
+			PhaseIndex = static_cast<uint32>(Position % Interpolation);
+
+			if (NumOfPhases != Interpolation)
+			{
+				PhaseIndex = static_cast<uint32>((static_cast<uint64>(PhaseIndex) * NumOfPhases + Interpolation / 2) / Interpolation);
+
+				if (PhaseIndex == NumOfPhases)
+				{
+					PhaseIndex = 0;
+					++InFrameIndex;
+				}
+			}
+		}
+
+		/**
+		 * Apply the phase of the filter to the samples. Vectorized on the platforms supporting vector intrinsics
+		 *
+		 * @param Samples Planar samples starting with the first tap
+		 * @param PhaseIndex Index of the filter phase
+		 */
+		FORCEINLINE float Apply(const float* Samples, uint32 PhaseIndex) const
+		{
+			const float* PhaseCoefficients = Coefficients.GetData() + PhaseIndex * NumOfTaps;
+
+			VectorRegister4Float Sum{VectorZeroFloat()};
+
+			for (int32 TapIndex = 0; TapIndex < NumOfTaps; TapIndex += 4)
+			{
+				Sum = VectorMultiplyAdd(VectorLoad(Samples + TapIndex), VectorLoad(PhaseCoefficients + TapIndex), Sum);
+			}
+
+			alignas(16) float Lanes[4];
+			VectorStoreAligned(Sum, Lanes);
+
+			return Lanes[0] + Lanes[1] + Lanes[2] + Lanes[3];
+		}
+
+		/** Upsampling factor of the reduced rate ratio */
+		uint32 Interpolation;
+
+		/** Downsampling factor of the reduced rate ratio */
+		uint32 Decimation;
+
+		/** The number of filter phases */
+		uint32 NumOfPhases;
+
+		/** The number of taps on each side of the filter */
+		int32 HalfNumOfTaps;
+
+		/** The number of taps of each phase */
+		int32 NumOfTaps;
+
+		/** Filter coefficients, phase by phase */
+		TArray<float> Coefficients;
+	};
+}
+
+bool ResamplingTranscoder::ResampleDecodedAudio(FDecodedAudioStruct& DecodedAudioInfo, uint32 TargetSampleRate)
+{
+	const uint32 SourceSampleRate{DecodedAudioInfo.SoundWaveBasicInfo.SampleRate};
+	const uint32 NumOfChannels{DecodedAudioInfo.SoundWaveBasicInfo.NumOfChannels};
+	const uint32 NumOfFrames{DecodedAudioInfo.PCMInfo.PCMNumOfFrames};
+
+	if (SourceSampleRate == TargetSampleRate || NumOfFrames == 0)
+	{
+		return true;
+	}
+
+	if (SourceSampleRate == 0 || TargetSampleRate == 0 || NumOfChannels == 0)
+	{
+		RuntimeAudioImporter_TranscoderLogs::PrintError(FString::Printf(TEXT("Unable to resample audio data from '%u' to '%u' sample rate with '%u' channels"), SourceSampleRate, TargetSampleRate, NumOfChannels));
+		return false;
+	}
+
+	RuntimeAudioImporter_TranscoderLogs::PrintLog(FString::Printf(TEXT("Resampling audio data from '%u' to '%u' sample rate.\nDecoded audio info: %s"), SourceSampleRate, TargetSampleRate, *DecodedAudioInfo.ToString()));
+
+	FPCMStruct& PCMInfo{DecodedAudioInfo.PCMInfo};
+	const int64 NumOfSamples{static_cast<int64>(NumOfFrames) * NumOfChannels};
+
+	// Resampling is done on 32-bit float samples, so the signed 16-bit ones are converted first
+	TArray<float> FloatSamples;
+	const float* InSamples = reinterpret_cast<const float*>(PCMInfo.PCMData.GetView().GetData());
+
+	if (PCMInfo.StorageFormat == EPCMStorageFormat::Int16)
+	{
+		FloatSamples.SetNumUninitialized(NumOfSamples);
+		RAWTranscoder::ConvertInt16ToFloat(reinterpret_cast<const int16*>(PCMInfo.PCMData.GetView().GetData()), FloatSamples.GetData(), NumOfSamples);
+		InSamples = FloatSamples.GetData();
+	}
+
+	const uint32 NumOfOutFrames{GetNumOfResampledFrames(NumOfFrames, SourceSampleRate, TargetSampleRate)};
+	const int64 NumOfOutSamples{static_cast<int64>(NumOfOutFrames) * NumOfChannels};
+
+	float* OutSamples = static_cast<float*>(FMemory::Malloc(NumOfOutSamples * sizeof(float)));
+	ResampleSamples(InSamples, NumOfFrames, NumOfChannels, SourceSampleRate, TargetSampleRate, OutSamples);
+
+	FloatSamples.Empty();
+
+	int64 PCMDataSize{NumOfOutSamples * static_cast<int64>(sizeof(float))};
+
+	// Converting back to the storage format in place, since signed 16-bit samples are smaller than float ones
+	if (PCMInfo.StorageFormat == EPCMStorageFormat::Int16)
+	{
+		RAWTranscoder::ConvertFloatToInt16(OutSamples, reinterpret_cast<int16*>(OutSamples), NumOfOutSamples);
+		PCMDataSize = NumOfOutSamples * static_cast<int64>(sizeof(int16));
+	}
+
+	PCMInfo.PCMData = FRuntimeBulkDataBuffer<uint8>(reinterpret_cast<uint8*>(OutSamples), PCMDataSize);
+	PCMInfo.PCMNumOfFrames = NumOfOutFrames;
+
+	DecodedAudioInfo.SoundWaveBasicInfo.SampleRate = TargetSampleRate;
+	DecodedAudioInfo.SoundWaveBasicInfo.Duration = static_cast<float>(NumOfOutFrames) / TargetSampleRate;
+
+	RuntimeAudioImporter_TranscoderLogs::PrintLog(FString::Printf(TEXT("Successfully resampled audio data.\nDecoded audio info: %s"), *DecodedAudioInfo.ToString()));
+
+	return true;
+}
+
+void ResamplingTranscoder::ResampleSamples(const float* InSamples, uint32 NumOfInFrames, uint32 NumOfChannels, uint32 SourceSampleRate, uint32 TargetSampleRate, float* OutSamples)
+{
+	const FPolyphaseFilter Filter(SourceSampleRate, TargetSampleRate);
+	const uint32 NumOfOutFrames{GetNumOfResampledFrames(NumOfInFrames, SourceSampleRate, TargetSampleRate)};
+
+	// The samples are deinterleaved and padded with silence on both sides, so that the taps of every output frame are contiguous and within bounds
+	const int64 NumOfPlanarFrames{static_cast<int64>(NumOfInFrames) + Filter.NumOfTaps + 1};
+
+	TArray<float> PlanarSamples;
+	PlanarSamples.SetNumZeroed(NumOfPlanarFrames * NumOfChannels);
+
+	for (uint32 ChannelIndex = 0; ChannelIndex < NumOfChannels; ++ChannelIndex)
+	{
+		float* ChannelSamples = PlanarSamples.GetData() + ChannelIndex * NumOfPlanarFrames + Filter.HalfNumOfTaps;
+
+		for (uint32 FrameIndex = 0; FrameIndex < NumOfInFrames; ++FrameIndex)
+		{
+			ChannelSamples[FrameIndex] = InSamples[static_cast<int64>(FrameIndex) * NumOfChannels + ChannelIndex];
+		}
+	}
+
+	const int32 NumOfTasks{static_cast<int32>(FMath::DivideAndRoundUp(NumOfOutFrames, NumOfFramesPerTask))};
+
+	ParallelFor(NumOfTasks, [&Filter, &PlanarSamples, NumOfPlanarFrames, NumOfChannels, NumOfOutFrames, OutSamples](int32 TaskIndex)
+	{
+		const uint32 FirstOutFrame{static_cast<uint32>(TaskIndex) * NumOfFramesPerTask};
+		const uint32 LastOutFrame{FMath::Min(FirstOutFrame + NumOfFramesPerTask, NumOfOutFrames)};
+
+		for (uint32 OutFrameIndex = FirstOutFrame; OutFrameIndex < LastOutFrame; ++OutFrameIndex)
+		{
+			uint64 InFrameIndex;
+			uint32 PhaseIndex;
+			Filter.GetInputPosition(OutFrameIndex, InFrameIndex, PhaseIndex);
+
+			// The first tap is HalfNumOfTaps - 1 frames before the input frame, which is offset by the padding of HalfNumOfTaps frames
+			const float* FirstTapSamples = PlanarSamples.GetData() + InFrameIndex + 1;
+
+			for (uint32 ChannelIndex = 0; ChannelIndex < NumOfChannels; ++ChannelIndex)
+			{
+				OutSamples[static_cast<int64>(OutFrameIndex) * NumOfChannels + ChannelIndex] = Filter.Apply(FirstTapSamples + ChannelIndex * NumOfPlanarFrames, PhaseIndex);
+			}
+		}
+	});
+}
+
+uint32 ResamplingTranscoder::GetNumOfResampledFrames(uint32 NumOfFrames, uint32 SourceSampleRate, uint32 TargetSampleRate)
+{
+	if (SourceSampleRate == 0)
+	{
+		return 0;
+	}
+
+	return static_cast<uint32>(FMath::Min<uint64>(static_cast<uint64>(NumOfFrames) * TargetSampleRate / SourceSampleRate, TNumericLimits<uint32>::Max()));
+}
@@ -0,0 +1,44 @@
+﻿// Georgy Treshchev 2022.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RuntimeAudioImporterTypes.h"
+
+/**
+ * Sample rate conversion of decoded audio data using a polyphase windowed-sinc filter
+ */
+class RUNTIMEAUDIOIMPORTER_API ResamplingTranscoder
+{
+public:
+	/**
+	 * Resample the decoded audio data to the specified sample rate. The storage format of the PCM data is preserved
+	 *
+	 * @param DecodedAudioInfo Decoded audio data to resample
+	 * @param TargetSampleRate The sample rate to resample to
+	 * @return Whether the resampling was successful or not. Also successful if the audio data already has the specified sample rate
+	 */
+	static bool ResampleDecodedAudio(FDecodedAudioStruct& DecodedAudioInfo, uint32 TargetSampleRate);
+
+	/**
+	 * Resample interleaved 32-bit float PCM data
+	 *
+	 * @param InSamples Interleaved PCM data to resample
+	 * @param NumOfInFrames Number of PCM frames to resample
+	 * @param NumOfChannels Number of channels
+	 * @param SourceSampleRate The sample rate of the PCM data
+	 * @param TargetSampleRate The sample rate to resample to
+	 * @param OutSamples Resampled interleaved PCM data. Must be able to hold GetNumOfResampledFrames frames
+	 */
+	static void ResampleSamples(const float* InSamples, uint32 NumOfInFrames, uint32 NumOfChannels, uint32 SourceSampleRate, uint32 TargetSampleRate, float* OutSamples);
+
+	/**
+	 * Get the number of PCM frames after resampling
+	 *
+	 * @param NumOfFrames Number of PCM frames to resample
+	 * @param SourceSampleRate The sample rate of the PCM data
+	 * @param TargetSampleRate The sample rate to resample to
+	 * @return The number of resampled PCM frames
+	 */
+	static uint32 GetNumOfResampledFrames(uint32 NumOfFrames, uint32 SourceSampleRate, uint32 TargetSampleRate);
+};
@@ -2,7 +2,7 @@
 
 #include "VorbisTranscoder.h"
 #include "RuntimeAudioImporterTypes.h"
-#include "Transcoders/RAWTranscoder.h"
+#include "Transcoders/ChunkedDecoder.h"
 #include "GenericPlatform/GenericPlatformProperties.h"
 
 #define INCLUDE_VORBIS
@@ -20,9 +20,29 @@ bool VorbisTranscoder::CheckAudioFormat(const uint8* AudioData, int32 AudioDataS
 		return false;
 	}
 
+	stb_vorbis_close(STBVorbis);
+
 	return true;
 }
 
+uint8 VorbisTranscoder::SniffAudioFormat(const uint8* AudioData, int64 AudioDataSize)
+{
+	if (AudioDataSize < 27 || FMemory::Memcmp(AudioData, "OggS", 4) != 0)
+	{
+		return 0;
+	}
+
+	// The first packet is the Vorbis identification header. It follows the 27-byte page header and the segment table
+	const int64 PacketOffset{27 + static_cast<int64>(AudioData[26])};
+	if (PacketOffset + 7 <= AudioDataSize && FMemory::Memcmp(AudioData + PacketOffset, "\x01" "vorbis", 7) == 0)
+	{
+		return 100;
+	}
+
+	// Ogg container with some other codec (e.g. Opus or FLAC)
+	return 0;
+}
+
 bool VorbisTranscoder::Encode(const FDecodedAudioStruct& DecodedData, FEncodedAudioStruct& EncodedData, uint8 Quality)
 {
 	RuntimeAudioImporter_TranscoderLogs::PrintLog(FString::Printf(TEXT("Encoding uncompressed audio data to Vorbis audio format.\nDecoded audio info: %s.\nQuality: %d"), *DecodedData.ToString(), Quality));
@@ -179,9 +199,8 @@ bool VorbisTranscoder::Encode(const FDecodedAudioStruct& DecodedData, FEncodedAu
 
 	// Filling in the encoded audio data
 	{
-		EncodedData.AudioData = FBulkDataBuffer<uint8>(static_cast<uint8*>(FMemory::Malloc(EncodedAudioData.Num())), EncodedAudioData.Num());
+		EncodedData.AudioData = FRuntimeBulkDataBuffer<uint8>(MoveTemp(EncodedAudioData));
 		EncodedData.AudioFormat = EAudioFormat::OggVorbis;
-		FMemory::Memcpy(EncodedData.AudioData.GetView().GetData(), EncodedAudioData.GetData(), EncodedAudioData.Num());
 	}
 	
 	RuntimeAudioImporter_TranscoderLogs::PrintLog(FString::Printf(TEXT("Successfully encoded uncompressed audio data to Vorbis audio format.\nEncoded audio info: %s"), *EncodedData.ToString()));
@@ -196,7 +215,7 @@ bool VorbisTranscoder::Encode(const FDecodedAudioStruct& DecodedData, FEncodedAu
 #endif
 }
 
-bool VorbisTranscoder::Decode(const FEncodedAudioStruct& EncodedData, FDecodedAudioStruct& DecodedData)
+bool VorbisTranscoder::Decode(const FEncodedAudioStruct& EncodedData, FDecodedAudioStruct& DecodedData, const FAudioImportCancellationToken* CancellationToken, FAudioDecodingProgress* Progress)
 {
 	RuntimeAudioImporter_TranscoderLogs::PrintLog(FString::Printf(TEXT("Decoding Vorbis audio data to uncompressed audio format.\nEncoded audio info: %s"), *EncodedData.ToString()));
 	
@@ -209,71 +228,105 @@ bool VorbisTranscoder::Decode(const FEncodedAudioStruct& EncodedData, FDecodedAu
 		return false;
 	}
 
-	const int32 SamplesLimit{Vorbis_Decoder->channels * 4096};
 	const int32 NumOfChannels{Vorbis_Decoder->channels};
 	const int32 SampleRate{static_cast<int32>(Vorbis_Decoder->sample_rate)};
+	const EPCMStorageFormat StorageFormat{DecodedData.PCMInfo.StorageFormat};
+	const uint32 SampleSize{DecodedData.PCMInfo.GetSampleSize()};
 
-	int32 SamplesOffset = 0;
-	int32 NumOfFrames = 0;
+	// The length is determined by the last Ogg page without decoding the audio data, so that the PCM data is allocated once with its exact size
+	const uint32 StreamLength{stb_vorbis_stream_length_in_samples(Vorbis_Decoder)};
+	const bool bLengthKnown{StreamLength > 0 && StreamLength < 0xfffffffe};
 
-	int32 TotalSamples = SamplesLimit;
+	// The PCM data grows only if the length is unknown, e.g. because the last Ogg page is missing
+	uint64 FrameCapacity{bLengthKnown ? StreamLength : FAudioImportCancellationToken::NumOfFramesPerCheck};
+	uint8* PCMData = static_cast<uint8*>(FMemory::Malloc(FrameCapacity * NumOfChannels * SampleSize));
 
-	int16* Int16RAWBuffer = static_cast<int16*>(FMemory::Malloc(TotalSamples * sizeof(int16)));
-	if (Int16RAWBuffer == nullptr)
+	if (Progress != nullptr && bLengthKnown)
 	{
-		RuntimeAudioImporter_TranscoderLogs::PrintError(TEXT("Failed to allocate memory for OGG Vorbis Decoder"));
-		stb_vorbis_close(Vorbis_Decoder);
-		return false;
+		Progress->SetNumOfFrames(StreamLength);
 	}
 
+	// Decoding straight to the storage format, without any intermediate buffers
+	auto ReadSamples = [Vorbis_Decoder, NumOfChannels, StorageFormat](uint8* ChunkPCMData, int32 NumOfSamples) -> int32
+	{
+		return StorageFormat == EPCMStorageFormat::Int16
+			       ? stb_vorbis_get_samples_short_interleaved(Vorbis_Decoder, NumOfChannels, reinterpret_cast<int16*>(ChunkPCMData), NumOfSamples)
+			       : stb_vorbis_get_samples_float_interleaved(Vorbis_Decoder, NumOfChannels, reinterpret_cast<float*>(ChunkPCMData), NumOfSamples);
+	};
+
+	uint64 NumOfFrames{0};
+
+	// Decoding in chunks to be able to stop as soon as the cancellation is requested
 	while (true)
 	{
-		const int32 CurrentFrames = stb_vorbis_get_frame_short_interleaved(Vorbis_Decoder, NumOfChannels, Int16RAWBuffer + SamplesOffset, TotalSamples - SamplesOffset);
+		if (CancellationToken != nullptr && CancellationToken->IsCancelled())
+		{
+			RuntimeAudioImporter_TranscoderLogs::PrintLog(TEXT("Decoding of Vorbis audio data has been cancelled"));
 
-		if (CurrentFrames == 0) break;
+			FMemory::Free(PCMData);
+			stb_vorbis_close(Vorbis_Decoder);
 
-		NumOfFrames += CurrentFrames;
-		SamplesOffset += CurrentFrames * NumOfChannels;
+			return false;
+		}
 
-		if (SamplesOffset + SamplesLimit > TotalSamples)
+		if (NumOfFrames == FrameCapacity)
 		{
-			TotalSamples *= 2;
+			// Checking for the remaining frames in a small buffer first, so that the PCM data does not grow if its length was exact
+			constexpr int32 NumOfOverflowFrames{1024};
+			TArray<uint8> OverflowPCMData;
+			OverflowPCMData.SetNumUninitialized(NumOfOverflowFrames * NumOfChannels * SampleSize);
 
-			int16* Int16RAWBufferFrame = static_cast<int16*>(FMemory::Realloc(Int16RAWBuffer, TotalSamples * sizeof(int16)));
+			const int32 NumOfOverflowChunkFrames{ReadSamples(OverflowPCMData.GetData(), NumOfOverflowFrames * NumOfChannels)};
 
-			if (Int16RAWBufferFrame == nullptr)
+			if (NumOfOverflowChunkFrames == 0)
 			{
-				RuntimeAudioImporter_TranscoderLogs::PrintError(TEXT("Failed to allocate memory for OGG Vorbis Decoder"));
-
-				FMemory::Free(Int16RAWBuffer);
-				stb_vorbis_close(Vorbis_Decoder);
-
-				return false;
+				break;
 			}
 
-			Int16RAWBuffer = Int16RAWBufferFrame;
+			FrameCapacity *= 2;
+			PCMData = static_cast<uint8*>(FMemory::Realloc(PCMData, FrameCapacity * NumOfChannels * SampleSize));
+
+			FMemory::Memcpy(PCMData + NumOfFrames * NumOfChannels * SampleSize, OverflowPCMData.GetData(), static_cast<int64>(NumOfOverflowChunkFrames) * NumOfChannels * SampleSize);
+			NumOfFrames += NumOfOverflowChunkFrames;
+			continue;
 		}
-	}
 
-	stb_vorbis_close(Vorbis_Decoder);
+		uint8* ChunkPCMData = PCMData + NumOfFrames * NumOfChannels * SampleSize;
+		const uint64 NumOfChunkFramesToRead{FMath::Min(FrameCapacity - NumOfFrames, FAudioImportCancellationToken::NumOfFramesPerCheck)};
+
+		const int32 NumOfChunkFrames{ReadSamples(ChunkPCMData, static_cast<int32>(NumOfChunkFramesToRead * NumOfChannels))};
+
+		if (NumOfChunkFrames == 0)
+		{
+			break;
+		}
 
+		NumOfFrames += NumOfChunkFrames;
 
-	// Getting the number of frames
-	DecodedData.PCMInfo.PCMNumOfFrames = NumOfFrames;
+		if (Progress != nullptr)
+		{
+			Progress->AddDecodedFrames(NumOfChunkFrames);
+		}
+	}
 
-	// Getting PCM data size
-	const int32 TempPCMDataSize = DecodedData.PCMInfo.PCMNumOfFrames * NumOfChannels * 2;
+	stb_vorbis_close(Vorbis_Decoder);
 
-	// Transcoding int16 to float format
+	if (NumOfFrames > TNumericLimits<uint32>::Max())
 	{
-		float* TempFloatBuffer = static_cast<float*>(FMemory::Malloc(DecodedData.PCMInfo.PCMNumOfFrames * NumOfChannels * 2 * sizeof(float)));
-		int32 TempFloatSize;
+		RuntimeAudioImporter_TranscoderLogs::PrintError(TEXT("Vorbis audio data is too long to be decoded"));
+		FMemory::Free(PCMData);
+		return false;
+	}
 
-		RAWTranscoder::TranscodeRAWData<int16, float>(Int16RAWBuffer, TempPCMDataSize, TempFloatBuffer, TempFloatSize);
-		DecodedData.PCMInfo.PCMData = FBulkDataBuffer<uint8>(reinterpret_cast<uint8*>(TempFloatBuffer), TempFloatSize);
+	// Shrinking the PCM data only if the length was unknown or inaccurate
+	const int64 PCMDataSize{static_cast<int64>(NumOfFrames) * NumOfChannels * SampleSize};
+	if (NumOfFrames != FrameCapacity)
+	{
+		PCMData = static_cast<uint8*>(FMemory::Realloc(PCMData, PCMDataSize));
 	}
-	
-	FMemory::Free(Int16RAWBuffer);
+
+	DecodedData.PCMInfo.PCMData = FRuntimeBulkDataBuffer<uint8>(PCMData, PCMDataSize);
+	DecodedData.PCMInfo.PCMNumOfFrames = static_cast<uint32>(NumOfFrames);
 
 	// Getting basic audio information
 	{
@@ -286,3 +339,76 @@ bool VorbisTranscoder::Decode(const FEncodedAudioStruct& EncodedData, FDecodedAu
 
 	return true;
 }
+
+
+/**
+ * Decoder that reads Vorbis data in chunks using stb_vorbis
+ */
+class FVorbisChunkedDecoder final : public FChunkedAudioDecoder
+{
+public:
+	virtual ~FVorbisChunkedDecoder() override
+	{
+		if (Vorbis_Decoder != nullptr)
+		{
+			stb_vorbis_close(Vorbis_Decoder);
+		}
+	}
+
+	/**
+	 * Initialize transcoding of audio data in memory
+	 */
+	bool Initialize(const uint8* AudioData, int64 AudioDataSize)
+	{
+		// stb_vorbis addresses the audio data with 32-bit integers
+		if (AudioDataSize > TNumericLimits<int32>::Max())
+		{
+			return false;
+		}
+
+		int32 ErrorCode;
+		Vorbis_Decoder = stb_vorbis_open_memory(AudioData, static_cast<int32>(AudioDataSize), &ErrorCode, nullptr);
+
+		if (Vorbis_Decoder == nullptr)
+		{
+			return false;
+		}
+
+		// Getting the number of frames only requires reading the last Ogg page, not decoding the stream. Zero if the last page cannot be found
+		const uint32 StreamLength{stb_vorbis_stream_length_in_samples(Vorbis_Decoder)};
+		NumOfFrames = StreamLength < 0xfffffffe ? StreamLength : 0;
+
+		SoundWaveBasicInfo.NumOfChannels = Vorbis_Decoder->channels;
+		SoundWaveBasicInfo.SampleRate = Vorbis_Decoder->sample_rate;
+		SoundWaveBasicInfo.Duration = static_cast<float>(NumOfFrames) / Vorbis_Decoder->sample_rate;
+
+		return true;
+	}
+
+	virtual uint32 ReadFrames(float* PCMData, uint32 NumOfFramesToRead) override
+	{
+		const int32 NumOfChannels{Vorbis_Decoder->channels};
+		return static_cast<uint32>(stb_vorbis_get_samples_float_interleaved(Vorbis_Decoder, NumOfChannels, PCMData, NumOfFramesToRead * NumOfChannels));
+	}
+
+	virtual bool SeekToFrame(uint64 FrameIndex) override
+	{
+		return stb_vorbis_seek(Vorbis_Decoder, static_cast<uint32>(FrameIndex)) != 0;
+	}
+
+private:
+	stb_vorbis* Vorbis_Decoder{nullptr};
+};
+
+TUniquePtr<FChunkedAudioDecoder> VorbisTranscoder::CreateChunkedDecoder(const uint8* AudioData, int64 AudioDataSize)
+{
+	TUniquePtr<FVorbisChunkedDecoder> Decoder{MakeUnique<FVorbisChunkedDecoder>()};
+
+	if (!Decoder->Initialize(AudioData, AudioDataSize))
+	{
+		RuntimeAudioImporter_TranscoderLogs::PrintError(TEXT("Unable to initialize OGG Vorbis Decoder"));
+		return nullptr;
+	}
+
+	return Decoder;
+}
@@ -6,6 +6,9 @@
 
 struct FDecodedAudioStruct;
 struct FEncodedAudioStruct;
+struct FAudioImportCancellationToken;
+struct FAudioDecodingProgress;
+class FChunkedAudioDecoder;
 
 class RUNTIMEAUDIOIMPORTER_API VorbisTranscoder
 {
@@ -15,6 +18,13 @@ public:
 	 */
 	static bool CheckAudioFormat(const uint8* AudioData, int32 AudioDataSize);
 
+	/**
+	 * Estimate whether the given audio data is Ogg Vorbis by looking only at its header (the first Ogg page)
+	 *
+	 * @return Confidence from 0 (not Ogg Vorbis) to 100 (definitely Ogg Vorbis)
+	 */
+	static uint8 SniffAudioFormat(const uint8* AudioData, int64 AudioDataSize);
+
 	/**
 	 * Encode uncompressed data to Vorbis format
 	 */
@@ -22,6 +32,17 @@ public:
 
 	/**
 	 * Decode compressed Vorbis data to PCM format
+	 *
+	 * @param CancellationToken Optional token checked between decoded chunks. The decoding fails if the cancellation is requested
+	 * @param Progress Optional progress updated between decoded chunks
+	 */
+	static bool Decode(const FEncodedAudioStruct& EncodedData, FDecodedAudioStruct& DecodedData, const FAudioImportCancellationToken* CancellationToken = nullptr, FAudioDecodingProgress* Progress = nullptr);
+
+	/**
+	 * Create a decoder that reads Vorbis data in chunks instead of decoding it all at once
+	 *
+	 * @note The audio data must remain valid for the entire lifetime of the decoder
+	 * @return The initialized decoder, or nullptr if the audio data cannot be decoded
 	 */
-	static bool Decode(const FEncodedAudioStruct& EncodedData, FDecodedAudioStruct& DecodedData);
+	static TUniquePtr<FChunkedAudioDecoder> CreateChunkedDecoder(const uint8* AudioData, int64 AudioDataSize);
 };
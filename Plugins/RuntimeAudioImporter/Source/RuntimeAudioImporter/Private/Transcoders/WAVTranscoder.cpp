@@ -3,17 +3,19 @@
 #include "WAVTranscoder.h"
 #include "RuntimeAudioImporterDefines.h"
 #include "RuntimeAudioImporterTypes.h"
+#include "Transcoders/ChunkedDecoder.h"
+#include "Transcoders/ParallelDecoding.h"
 
 #define INCLUDE_WAV
 #include "TranscodersIncludes.h"
 #undef INCLUDE_WAV
 
-bool WAVTranscoder::CheckAndFixWavDurationErrors(TArray<uint8>& WavData)
+bool WAVTranscoder::CheckAndFixWavDurationErrors(FRuntimeBulkDataBuffer<uint8>& WavData)
 {
 	drwav WAV;
 
 	// Initializing transcoding of audio data in memory
-	if (!drwav_init_memory(&WAV, WavData.GetData(), WavData.Num(), nullptr))
+	if (!drwav_init_memory(&WAV, WavData.GetView().GetData(), WavData.GetView().Num(), nullptr))
 	{
 		RuntimeAudioImporter_TranscoderLogs::PrintError(TEXT("Unable to initialize WAV Decoder"));
 		return false;
@@ -29,19 +31,22 @@ bool WAVTranscoder::CheckAndFixWavDurationErrors(TArray<uint8>& WavData)
 	// Get 4-byte field at byte 4, which is the overall file size as uint32, according to RIFF specification.
 	// If the field is set to nothing (hex FFFFFFFF), replace the incorrectly set field with the actual size.
 	// The field should be (size of file - 8 bytes), as the chunk identifier for the whole file (4 bytes spelling out RIFF at the start of the file), and the chunk length (4 bytes that we're replacing) are excluded.
-	if (BytesToHex(WavData.GetData() + 4, 4) == "FFFFFFFF")
+	if (BytesToHex(WavData.GetView().GetData() + 4, 4) == "FFFFFFFF")
 	{
-		const int32 ActualFileSize = WavData.Num() - 8;
-		FMemory::Memcpy(WavData.GetData() + 4, &ActualFileSize, 4);
+		// Memory-mapped audio data is read-only, so it has to be copied before being fixed
+		WavData.MakeWritable();
+
+		const int32 ActualFileSize = static_cast<int32>(WavData.GetView().Num() - 8);
+		FMemory::Memcpy(WavData.GetView().GetData() + 4, &ActualFileSize, 4);
 	}
 
 	// Search for the place in the file after the chunk id "data", which is where the data length is stored.
 	// First 36 bytes are skipped, as they're always "RIFF", 4 bytes filesize, "WAVE", "fmt ", and 20 bytes of format data.
 	uint32 DataSizeLocation = INDEX_NONE;
-	for (uint32 Index = 36; Index < static_cast<uint32>(WavData.Num()) - 4; ++Index)
+	for (uint32 Index = 36; Index < static_cast<uint32>(WavData.GetView().Num()) - 4; ++Index)
 	{
 		// "64617461" - hex for string "data"
-		if (BytesToHex(WavData.GetData() + Index, 4) == "64617461")
+		if (BytesToHex(WavData.GetView().GetData() + Index, 4) == "64617461")
 		{
 			DataSizeLocation = Index + 4;
 			break;
@@ -57,12 +62,14 @@ bool WAVTranscoder::CheckAndFixWavDurationErrors(TArray<uint8>& WavData)
 	}
 
 	// Same process as replacing full file size, except DataSize counts bytes from end of DataSize int to end of file.
-	if (BytesToHex(WavData.GetData() + DataSizeLocation, 4) == "FFFFFFFF")
+	if (BytesToHex(WavData.GetView().GetData() + DataSizeLocation, 4) == "FFFFFFFF")
 	{
+		WavData.MakeWritable();
+
 		// -4 to not include the DataSize int itself
-		const uint32 ActualDataSize = WavData.Num() - DataSizeLocation - 4;
+		const uint32 ActualDataSize = static_cast<uint32>(WavData.GetView().Num() - DataSizeLocation - 4);
 
-		FMemory::Memcpy(WavData.GetData() + DataSizeLocation, &ActualDataSize, 4);
+		FMemory::Memcpy(WavData.GetView().GetData() + DataSizeLocation, &ActualDataSize, 4);
 	}
 
 	drwav_uninit(&WAV);
@@ -79,9 +86,28 @@ bool WAVTranscoder::CheckAudioFormat(const uint8* AudioData, int32 AudioDataSize
 		return false;
 	}
 
+	drwav_uninit(&WAV);
+
 	return true;
 }
 
+uint8 WAVTranscoder::SniffAudioFormat(const uint8* AudioData, int64 AudioDataSize)
+{
+	// RIFF and RF64 containers with the WAVE form type
+	if (AudioDataSize >= 12 && (FMemory::Memcmp(AudioData, "RIFF", 4) == 0 || FMemory::Memcmp(AudioData, "RF64", 4) == 0))
+	{
+		return FMemory::Memcmp(AudioData + 8, "WAVE", 4) == 0 ? 100 : 0;
+	}
+
+	// Wave64 uses GUIDs instead of FourCCs
+	if (AudioDataSize >= 40 && FMemory::Memcmp(AudioData, drwavGUID_W64_RIFF, 16) == 0)
+	{
+		return FMemory::Memcmp(AudioData + 24, drwavGUID_W64_WAVE, 16) == 0 ? 100 : 0;
+	}
+
+	return 0;
+}
+
 uint32 ConvertFormat(EWAVEncodingFormat Format)
 {
 	switch (Format)
@@ -134,7 +160,7 @@ bool WAVTranscoder::Encode(const FDecodedAudioStruct& DecodedData, FEncodedAudio
 	drwav_uninit(&WAV_Encoder);
 
 	{
-		EncodedData.AudioData = FBulkDataBuffer<uint8>(static_cast<uint8*>(AudioData), AudioDataSize);
+		EncodedData.AudioData = FRuntimeBulkDataBuffer<uint8>(static_cast<uint8*>(AudioData), AudioDataSize);
 		EncodedData.AudioFormat = EAudioFormat::Wav;
 	}
 	
@@ -143,7 +169,7 @@ bool WAVTranscoder::Encode(const FDecodedAudioStruct& DecodedData, FEncodedAudio
 	return true;
 }
 
-bool WAVTranscoder::Decode(const FEncodedAudioStruct& EncodedData, FDecodedAudioStruct& DecodedData)
+bool WAVTranscoder::Decode(const FEncodedAudioStruct& EncodedData, FDecodedAudioStruct& DecodedData, const FAudioImportCancellationToken* CancellationToken, FAudioDecodingProgress* Progress)
 {
 	RuntimeAudioImporter_TranscoderLogs::PrintLog(FString::Printf(TEXT("Decoding WAV audio data to uncompressed audio format.\nEncoded audio info: %s"), *EncodedData.ToString()));
 
@@ -156,16 +182,112 @@ bool WAVTranscoder::Decode(const FEncodedAudioStruct& EncodedData, FDecodedAudio
 		return false;
 	}
 
-	// Allocating memory for PCM data
-	uint8* TempPCMData = static_cast<uint8*>(FMemory::Malloc(WAV_Decoder.totalPCMFrameCount * WAV_Decoder.channels * sizeof(float)));
+	const uint64 NumOfFrames{WAV_Decoder.totalPCMFrameCount};
+	const uint32 NumOfChannels{WAV_Decoder.channels};
+	const EPCMStorageFormat StorageFormat{DecodedData.PCMInfo.StorageFormat};
+	const uint32 SampleSize{DecodedData.PCMInfo.GetSampleSize()};
+
+	if (Progress != nullptr)
+	{
+		Progress->SetNumOfFrames(NumOfFrames);
+	}
+
+	// Filling PCM data in the requested storage format
+	auto ReadPCMFrames = [StorageFormat, NumOfChannels, SampleSize, CancellationToken, Progress](drwav* Decoder, uint64 NumOfFramesToRead, uint8* PCMData, uint64 StartFrame) -> uint64
+	{
+		uint64 NumOfReadFrames{0};
+
+		// Reading in chunks to be able to stop as soon as the cancellation is requested
+		while (NumOfReadFrames < NumOfFramesToRead && (CancellationToken == nullptr || !CancellationToken->IsCancelled()))
+		{
+			uint8* FramesPCMData = PCMData + static_cast<int64>(StartFrame + NumOfReadFrames) * NumOfChannels * SampleSize;
+			const uint64 NumOfChunkFrames{FMath::Min(NumOfFramesToRead - NumOfReadFrames, FAudioImportCancellationToken::NumOfFramesPerCheck)};
+
+			const uint64 NumOfReadChunkFrames{
+				StorageFormat == EPCMStorageFormat::Int16
+					? drwav_read_pcm_frames_s16(Decoder, NumOfChunkFrames, reinterpret_cast<drwav_int16*>(FramesPCMData))
+					: drwav_read_pcm_frames_f32(Decoder, NumOfChunkFrames, reinterpret_cast<float*>(FramesPCMData))
+			};
+
+			if (NumOfReadChunkFrames == 0)
+			{
+				break;
+			}
+
+			NumOfReadFrames += NumOfReadChunkFrames;
+
+			if (Progress != nullptr)
+			{
+				Progress->AddDecodedFrames(NumOfReadChunkFrames);
+			}
+		}
+
+		return NumOfReadFrames;
+	};
+
+	// Allocating memory for PCM data. The size is computed in 64 bits, since long multichannel audio data exceeds 2 GB once decoded
+	const int64 FrameSize{static_cast<int64>(NumOfChannels) * SampleSize};
+	uint8* TempPCMData = static_cast<uint8*>(FMemory::Malloc(static_cast<int64>(NumOfFrames) * FrameSize));
+
+	// Only uncompressed PCM data is seekable to an arbitrary frame at no cost
+	const int32 NumOfSegments{WAV_Decoder.translatedFormatTag == DR_WAVE_FORMAT_PCM || WAV_Decoder.translatedFormatTag == DR_WAVE_FORMAT_IEEE_FLOAT ? ParallelDecoding::GetNumOfSegments(NumOfFrames) : 1};
 
-	// Filling PCM data and getting the number of frames
-	DecodedData.PCMInfo.PCMNumOfFrames = drwav_read_pcm_frames_f32(&WAV_Decoder, WAV_Decoder.totalPCMFrameCount, reinterpret_cast<float*>(TempPCMData));
+	// Each segment is decoded by its own decoder instance into a disjoint region of the PCM data
+	const EParallelDecodingResult ParallelDecodingResult{NumOfSegments > 1 ? ParallelDecoding::DecodeSegments(NumOfFrames, NumOfSegments, CancellationToken, Progress, [&EncodedData, &ReadPCMFrames, TempPCMData](uint64 StartFrame, uint64 NumOfSegmentFrames) -> uint64
+	{
+		drwav Segment_Decoder;
+
+		if (!drwav_init_memory(&Segment_Decoder, EncodedData.AudioData.GetView().GetData(), EncodedData.AudioData.GetView().Num(), nullptr))
+		{
+			return 0;
+		}
+
+		uint64 NumOfDecodedFrames{0};
+
+		if (drwav_seek_to_pcm_frame(&Segment_Decoder, StartFrame))
+		{
+			NumOfDecodedFrames = ReadPCMFrames(&Segment_Decoder, NumOfSegmentFrames, TempPCMData, StartFrame);
+		}
+
+		drwav_uninit(&Segment_Decoder);
+
+		return NumOfDecodedFrames;
+	}) : EParallelDecodingResult::Failed};
+
+	if (ParallelDecodingResult == EParallelDecodingResult::Decoded)
+	{
+		DecodedData.PCMInfo.PCMNumOfFrames = NumOfFrames;
+
+		if (ParallelDecoding::ShouldValidate())
+		{
+			uint8* SerialPCMData = static_cast<uint8*>(FMemory::Malloc(static_cast<int64>(NumOfFrames) * FrameSize));
+			const uint64 NumOfSerialFrames{ReadPCMFrames(&WAV_Decoder, NumOfFrames, SerialPCMData, 0)};
+
+			ParallelDecoding::Validate(TempPCMData, SerialPCMData, FMath::Min(NumOfFrames, NumOfSerialFrames) * FrameSize);
+
+			FMemory::Free(SerialPCMData);
+		}
+	}
+	else if (ParallelDecodingResult == EParallelDecodingResult::Failed)
+	{
+		// Filling PCM data and getting the number of frames
+		DecodedData.PCMInfo.PCMNumOfFrames = ReadPCMFrames(&WAV_Decoder, NumOfFrames, TempPCMData, 0);
+	}
+
+	if (CancellationToken != nullptr && CancellationToken->IsCancelled())
+	{
+		RuntimeAudioImporter_TranscoderLogs::PrintLog(TEXT("Decoding of WAV audio data has been cancelled"));
+
+		FMemory::Free(TempPCMData);
+		drwav_uninit(&WAV_Decoder);
+
+		return false;
+	}
 
 	// Getting PCM data size
-	const int32 TempPCMDataSize = static_cast<int32>(DecodedData.PCMInfo.PCMNumOfFrames * WAV_Decoder.channels * sizeof(float));
+	const int64 TempPCMDataSize{static_cast<int64>(DecodedData.PCMInfo.PCMNumOfFrames) * FrameSize};
 
-	DecodedData.PCMInfo.PCMData =FBulkDataBuffer<uint8>(TempPCMData, TempPCMDataSize);
+	DecodedData.PCMInfo.PCMData = FRuntimeBulkDataBuffer<uint8>(TempPCMData, TempPCMDataSize);
 
 	// Getting basic audio information
 	{
@@ -181,3 +303,67 @@ bool WAVTranscoder::Decode(const FEncodedAudioStruct& EncodedData, FDecodedAudio
 
 	return true;
 }
+
+
+/**
+ * Decoder that reads WAV data in chunks using the dr_wav pull API
+ */
+class FWAVChunkedDecoder final : public FChunkedAudioDecoder
+{
+public:
+	virtual ~FWAVChunkedDecoder() override
+	{
+		if (bInitialized)
+		{
+			drwav_uninit(&WAV_Decoder);
+		}
+	}
+
+	/**
+	 * Initialize transcoding of audio data in memory
+	 */
+	bool Initialize(const uint8* AudioData, int64 AudioDataSize)
+	{
+		if (!drwav_init_memory(&WAV_Decoder, AudioData, AudioDataSize, nullptr))
+		{
+			return false;
+		}
+
+		bInitialized = true;
+
+		NumOfFrames = WAV_Decoder.totalPCMFrameCount;
+
+		SoundWaveBasicInfo.NumOfChannels = WAV_Decoder.channels;
+		SoundWaveBasicInfo.SampleRate = WAV_Decoder.sampleRate;
+		SoundWaveBasicInfo.Duration = static_cast<float>(NumOfFrames) / WAV_Decoder.sampleRate;
+
+		return true;
+	}
+
+	virtual uint32 ReadFrames(float* PCMData, uint32 NumOfFramesToRead) override
+	{
+		return static_cast<uint32>(drwav_read_pcm_frames_f32(&WAV_Decoder, NumOfFramesToRead, PCMData));
+	}
+
+	virtual bool SeekToFrame(uint64 FrameIndex) override
+	{
+		return drwav_seek_to_pcm_frame(&WAV_Decoder, FrameIndex) == DRWAV_TRUE;
+	}
+
+private:
+	drwav WAV_Decoder;
+	bool bInitialized{false};
+};
+
+TUniquePtr<FChunkedAudioDecoder> WAVTranscoder::CreateChunkedDecoder(const uint8* AudioData, int64 AudioDataSize)
+{
+	TUniquePtr<FWAVChunkedDecoder> Decoder{MakeUnique<FWAVChunkedDecoder>()};
+
+	if (!Decoder->Initialize(AudioData, AudioDataSize))
+	{
+		RuntimeAudioImporter_TranscoderLogs::PrintError(TEXT("Unable to initialize WAV Decoder"));
+		return nullptr;
+	}
+
+	return Decoder;
+}
@@ -6,6 +6,11 @@
 
 struct FDecodedAudioStruct;
 struct FEncodedAudioStruct;
+struct FAudioImportCancellationToken;
+struct FAudioDecodingProgress;
+template <typename DataType>
+class FRuntimeBulkDataBuffer;
+class FChunkedAudioDecoder;
 
 /**
  * All possible WAV formats
@@ -56,13 +61,20 @@ public:
 	 *
 	 * @param WavData Buffer of the wav data
 	 */
-	static bool CheckAndFixWavDurationErrors(TArray<uint8>& WavData);
+	static bool CheckAndFixWavDurationErrors(FRuntimeBulkDataBuffer<uint8>& WavData);
 
 	/**
 	 * Check if the given WAV audio data seems to be valid
 	 */
 	static bool CheckAudioFormat(const uint8* AudioData, int32 AudioDataSize);
 
+	/**
+	 * Estimate whether the given audio data is WAV by looking only at its header (RIFF, RF64 or Wave64)
+	 *
+	 * @return Confidence from 0 (not WAV) to 100 (definitely WAV)
+	 */
+	static uint8 SniffAudioFormat(const uint8* AudioData, int64 AudioDataSize);
+
 	/**
 	 * Encode uncompressed data to WAV format
 	 */
@@ -70,6 +82,17 @@ public:
 
 	/**
 	 * Decode compressed WAV data to PCM format
+	 *
+	 * @param CancellationToken Optional token checked between decoded chunks. The decoding fails if the cancellation is requested
+	 * @param Progress Optional progress updated between decoded chunks
+	 */
+	static bool Decode(const FEncodedAudioStruct& EncodedData, FDecodedAudioStruct& DecodedData, const FAudioImportCancellationToken* CancellationToken = nullptr, FAudioDecodingProgress* Progress = nullptr);
+
+	/**
+	 * Create a decoder that reads WAV data in chunks instead of decoding it all at once
+	 *
+	 * @note The audio data must remain valid for the entire lifetime of the decoder
+	 * @return The initialized decoder, or nullptr if the audio data cannot be decoded
 	 */
-	static bool Decode(const FEncodedAudioStruct& EncodedData, FDecodedAudioStruct& DecodedData);
+	static TUniquePtr<FChunkedAudioDecoder> CreateChunkedDecoder(const uint8* AudioData, int64 AudioDataSize);
 };
@@ -0,0 +1,112 @@
+// Georgy Treshchev 2022.
+
+#pragma once
+
+#include "Subsystems/EngineSubsystem.h"
+#include "RuntimeAudioImporterTypes.h"
+#include "DecodedAudioCacheSubsystem.generated.h"
+
+/** Entry of the decoded audio cache. CPP use only. */
+struct FDecodedAudioCacheEntry
+{
+	/** SoundWave basic info (e.g. duration, number of channels, etc) */
+	FSoundWaveBasicStruct SoundWaveBasicInfo;
+
+	/** Shared immutable PCM data */
+	TSharedRef<const FRuntimeBulkDataBuffer<uint8>, ESPMode::ThreadSafe> PCMData;
+
+	/** Number of PCM frames */
+	uint32 PCMNumOfFrames;
+
+	/** Format of the PCM data */
+	EPCMStorageFormat StorageFormat;
+
+	/** Value of the access counter at the last access, used to find the least recently used entries */
+	uint64 LastAccess;
+};
+
+/**
+ * In-memory cache of decoded audio data, shared between the sound waves imported from the same source.
+ * The PCM data is held in reference-counted immutable buffers, so an evicted entry releases its memory only once no sound wave uses it anymore
+ */
+UCLASS()
+class RUNTIMEAUDIOIMPORTER_API UDecodedAudioCacheSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Get the decoded audio cache
+	 *
+	 * @return The decoded audio cache. Null if the engine is not initialized
+	 */
+	static UDecodedAudioCacheSubsystem* Get();
+
+	/**
+	 * Make the cache key of the audio file. The key changes whenever the file is modified
+	 *
+	 * @param FilePath Path to the audio file
+	 * @param StorageFormat The storage format of the decoded PCM data
+	 * @param SampleRate The sample rate the decoded PCM data is resampled to. Zero if not resampled
+	 * @return The cache key. Empty if the file does not exist
+	 */
+	static FString MakeFileCacheKey(const FString& FilePath, EPCMStorageFormat StorageFormat, int32 SampleRate);
+
+	/**
+	 * Find the decoded audio data in the cache. Thread safe
+	 *
+	 * @param CacheKey The cache key of the audio data
+	 * @param DecodedAudioInfo Decoded audio data sharing the cached PCM data
+	 * @return Whether the decoded audio data was found in the cache or not
+	 */
+	bool Find(const FString& CacheKey, FDecodedAudioStruct& DecodedAudioInfo);
+
+	/**
+	 * Add the decoded audio data to the cache, evicting the least recently used entries exceeding the memory budget. Thread safe
+	 *
+	 * @param CacheKey The cache key of the audio data
+	 * @param DecodedAudioInfo Decoded audio data. Its PCM data is moved into a shared buffer, which it references afterwards
+	 */
+	void Add(const FString& CacheKey, FDecodedAudioStruct& DecodedAudioInfo);
+
+	/**
+	 * Remove all entries from the cache. The sound waves sharing the PCM data keep it
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Audio Importer|Cache")
+	void Empty();
+
+	/**
+	 * Get the statistics of the cache
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Audio Importer|Cache")
+	FDecodedAudioCacheStats GetStats() const;
+
+	//~ Begin USubsystem Interface
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+private:
+	/**
+	 * Evict the least recently used entries until the cache fits into the memory budget. Must be called with CacheGuard locked
+	 *
+	 * @param MaxCachedBytes The memory budget of the cache, in bytes
+	 */
+	void EvictEntries(int64 MaxCachedBytes);
+
+	/** Cache entries by their keys */
+	TMap<FString, FDecodedAudioCacheEntry> Entries;
+
+	/** Size of the PCM data held by the cache entries */
+	int64 CachedBytes{0};
+
+	/** Incremented on every access to order the entries by their last use */
+	uint64 AccessCounter{0};
+
+	/** Statistics counters */
+	int64 NumOfHits{0};
+	int64 NumOfMisses{0};
+	int64 NumOfEvictions{0};
+
+	/** Guards the entries and counters, since the imports may access the cache from different threads */
+	mutable FCriticalSection CacheGuard;
+};
@@ -3,7 +3,12 @@
 #pragma once
 
 #include "RuntimeAudioImporterTypes.h"
+#include "ImportedSoundWaveTap.h"
+#include "ImportedSoundWaveTimeStretcher.h"
 #include "Sound/SoundWaveProcedural.h"
+#include "HAL/CriticalSection.h"
+#include "Templates/Atomic.h"
+#include "Containers/Ticker.h"
 #include "ImportedSoundWave.generated.h"
 
 /** Static delegate broadcast to track the end of audio playback */
@@ -19,6 +24,40 @@ DECLARE_MULTICAST_DELEGATE_OneParam(FOnGeneratePCMDataNative, const TArray<float
 /** Dynamic delegate broadcast PCM data during a generation request */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnGeneratePCMData, const TArray<float>&, PCMData);
 
+/**
+ * Block of PCM data retrieved during a generation request, shared between all listeners without being copied
+ * The blocks are pooled by the sound wave and reused once no listener references them, so they should not be held for long
+ */
+struct FImportedPCMDataBlock
+{
+	/** Interleaved 32-bit float PCM data */
+	TArray<float> PCMData;
+};
+
+/** Static delegate broadcast pooled PCM data blocks during a generation request */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnGeneratePCMDataBlockNative, const TSharedRef<const FImportedPCMDataBlock, ESPMode::ThreadSafe>&);
+
+class UImportedSoundWave;
+
+/** Static delegate broadcast when a queued sound wave starts playing */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnQueuedSoundWaveStartedNative, UImportedSoundWave*);
+
+/** Dynamic delegate broadcast when a queued sound wave starts playing */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnQueuedSoundWaveStarted, UImportedSoundWave*, SoundWave);
+
+
+/** PCM data of a sound wave queued for gapless playback */
+struct FQueuedPCMSource
+{
+	/** PCM data shared with the queued sound wave. Once the source starts playing, it holds the PCM data played before it instead, to be released on the game thread */
+	FPCMStruct PCMBufferInfo;
+
+	/** Number of decoded frames of the queued sound wave, which is kept alive by the queue */
+	const TAtomic<uint32>* NumOfDecodedFrames;
+
+	/** Duration of the queued sound wave, in seconds */
+	float Duration;
+};
 
 /**
  * The main sound wave class used to play imported audio from the Runtime Audio Importer
@@ -28,6 +67,10 @@ class RUNTIMEAUDIOIMPORTER_API UImportedSoundWave : public USoundWaveProcedural
 {
 	GENERATED_BODY()
 public:
+	//~ Begin UObject Interface
+	virtual void PostInitProperties() override;
+	//~ End UObject Interface
+
 	//~ Begin USoundWave Interface
 	virtual void BeginDestroy() override;
 	//~ End USoundWave Interface
@@ -48,19 +91,123 @@ public:
 	bool RewindPlaybackTime(const float PlaybackTime);
 
 	/**
-	 * Change the current number of frames. Usually used to rewind the sound
+	 * Change the current number of frames. Usually used to rewind the sound. Thread safe
+	 * The seek is posted to the next generation request, which applies it at the block boundary with a short fade. If the sound wave is being decoded in streaming mode, the decoder prefetches the target first
 	 *
 	 * @param NumOfFrames The new number of frames from which to continue playing sound
 	 * @return Whether the frames were changed or not
 	 */
 	bool ChangeCurrentFrameCount(const uint32 NumOfFrames);
 
+	/**
+	 * Append PCM data to the end of the sound wave, e.g. while importing a live stream. Thread safe
+	 *
+	 * @param PCMData Interleaved PCM data in the storage format of the sound wave
+	 * @param NumOfFrames Number of PCM frames to append
+	 * @return Whether the PCM data was appended or not. Fails if the sound wave no longer awaits PCM data (e.g. its memory has been released)
+	 */
+	bool AppendPCMData(const uint8* PCMData, uint32 NumOfFrames);
+
+	/**
+	 * Truncate the sound wave to the frames decoded so far, e.g. once its streaming decoding is cancelled. The PCM data itself is kept, so the sound wave can keep playing. Thread safe
+	 * Does nothing if the sound wave no longer plays its own PCM data (e.g. it has switched to a queued sound wave or its memory has been released)
+	 *
+	 * @param NumOfFrames Number of frames to keep
+	 */
+	void TruncatePCMData(uint32 NumOfFrames);
+
+	/**
+	 * Queue the sound wave to be played right after this one without a gap. The switch happens within the generation request, without involving the game thread
+	 * The PCM data of the queued sound wave is shared, not copied. It may still be decoding in streaming mode, but must have the same sample rate, number of channels and storage format
+	 *
+	 * @param SoundWave The sound wave to queue
+	 * @return Whether the sound wave was queued or not
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Imported Sound Wave|Playlist")
+	bool EnqueueSoundWave(UImportedSoundWave* SoundWave);
+
+	/**
+	 * Remove the queued sound waves that have not started playing yet
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Imported Sound Wave|Playlist")
+	void ClearQueue();
+
+	/**
+	 * Get the number of queued sound waves that have not started playing yet
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Imported Sound Wave|Playlist")
+	int32 GetNumOfQueuedSoundWaves();
+
+	/**
+	 * Loop the region of the sound wave being played, sample-accurately. The loop is crossfaded if a crossfade duration is set
+	 * The loop is cleared when switching to a queued sound wave
+	 *
+	 * @param StartTime Start of the loop region, in seconds
+	 * @param EndTime End of the loop region, in seconds. The end of the sound wave if zero or less
+	 * @param NumOfLoops How many times to jump back to the start of the region. Infinite if less than zero
+	 * @return Whether the loop region was set or not
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Imported Sound Wave|Playlist")
+	bool SetLoopRegion(float StartTime, float EndTime, int32 NumOfLoops = -1);
+
+	/**
+	 * Stop looping. The playback continues to the end of the sound wave
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Imported Sound Wave|Playlist")
+	void ClearLoopRegion();
+
+	/**
+	 * Set the duration of the crossfade applied when jumping to the loop start and when switching to a queued sound wave. Zero for a hard cut
+	 *
+	 * @param CrossfadeDuration Crossfade duration, in seconds
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Imported Sound Wave|Playlist")
+	void SetCrossfadeDuration(float CrossfadeDuration);
+
+	/**
+	 * Change the tempo and the pitch of the playback independently of each other, unlike the pitch of the sound, by rendering the sound wave through a time stretcher
+	 * The time stretcher is allocated on first use, so the tempo and the pitch can then be changed at any rate. While it is in use, the seeks, the loop and the queued sound waves are crossfaded by the time stretcher instead
+	 *
+	 * @param Tempo Playback speed ratio, clamped to 0.25-4
+	 * @param PitchShift Pitch ratio, clamped to 0.5-2
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Imported Sound Wave|Time Stretch")
+	void SetTimeStretch(float Tempo, float PitchShift = 1.f);
+
+	/**
+	 * Stop rendering the sound wave through the time stretcher. The playback continues at the original tempo and pitch
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Imported Sound Wave|Time Stretch")
+	void ClearTimeStretch();
+
+	/**
+	 * Reference the PCM data of the sound wave without copying it, e.g. to export or compress the sound wave. Thread safe
+	 *
+	 * @return PCM data sharing the buffer of the sound wave. It is read-only and stays valid even if the sound wave memory is released
+	 */
+	FPCMStruct SharePCMData();
+
+	/**
+	 * Get the tap fed with the PCM data rendered by the sound wave, creating it on first use. Read it through FImportedSoundWaveTapReader at any rate without involving the game thread. Thread safe
+	 * Should be requested once the sound wave is imported, as the tap stores the number of channels the sound wave has at the time it is created
+	 *
+	 * @param NumOfFrames Capacity of the tap, in frames. Only used when creating the tap
+	 * @return The tap shared by all consumers
+	 */
+	TSharedRef<const FImportedSoundWaveTap, ESPMode::ThreadSafe> GetTap(int32 NumOfFrames = 16384);
+
 	/**
 	 * Get the current sound wave playback time, in seconds
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Imported Sound Wave|Info")
 	float GetPlaybackTime() const;
 
+	/**
+	 * Get the current number of processed frames. Thread safe
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Imported Sound Wave|Info")
+	int32 GetCurrentNumOfFrames() const;
+
 	/**
 	 * Constant alternative for getting the length of the sound wave, in seconds
 	 */
@@ -118,6 +265,16 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Imported Sound Wave|Delegates")
 	FOnGeneratePCMData OnGeneratePCMData;
 
+	/** Bind to this delegate to receive PCM data during playback as pooled blocks, which can be kept without being copied. Recommended for C++ only */
+	FOnGeneratePCMDataBlockNative OnGeneratePCMDataBlockNative;
+
+	/** Bind to this delegate to know when a queued sound wave starts playing. Recommended for C++ only */
+	FOnQueuedSoundWaveStartedNative OnQueuedSoundWaveStartedNative;
+
+	/** Bind to this delegate to know when a queued sound wave starts playing. Recommended for Blueprints only */
+	UPROPERTY(BlueprintAssignable, Category = "Imported Sound Wave|Delegates")
+	FOnQueuedSoundWaveStarted OnQueuedSoundWaveStarted;
+
 private:
 	/** Bool to control the behaviour of the OnAudioPlaybackFinished delegate */
 	bool PlaybackFinishedBroadcast = false;
@@ -126,7 +283,7 @@ public:
 	//~ Begin UProceduralSoundWave Interface
 
 	/**
-	 * Generating PCM data by splitting it into samples
+	 * Generating PCM data by splitting it into samples. Does not allocate once the playback has warmed up, as OutAudio is reused by the engine
 	 *
 	 * @param OutAudio Retrieved PCM data array
 	 * @param NumSamples Required number of samples
@@ -137,16 +294,173 @@ public:
 	/**
 	 * Getting the format of the retrieved PCM data
 	 *
-	 * @note Since we are using 32-bit float, there will be no PCM transcoding in the engine, which will improve audio processing performance
+	 * @note With 32-bit float storage there will be no PCM transcoding in the engine, which will improve audio processing performance. With signed 16-bit storage the engine converts each block to float
 	 */
 	virtual Audio::EAudioMixerStreamDataFormat::Type GetGeneratedPCMDataFormat() const override;
 
 	//~ End UProceduralSoundWave Interface
 
-	/** The current number of processed frames */
-	UPROPERTY(BlueprintReadOnly, Category = "Imported Sound Wave|Info")
-	int32 CurrentNumOfFrames = 0;
+	/** The current number of processed frames. Only changed by the generation requests, use ChangeCurrentFrameCount to seek. Atomic, since it is read from the game thread without locking the data guard */
+	TAtomic<uint32> CurrentNumOfFrames{0};
 
 	/** Contains PCM data for sound wave playback */
 	FPCMStruct PCMBufferInfo;
+
+	/**
+	 * The number of frames already decoded and available for playback
+	 * Differs from the total number of frames only while the audio data is still being decoded in streaming mode
+	 */
+	TAtomic<uint32> NumOfDecodedFrames{0};
+
+	/**
+	 * Whether more PCM data is expected to be appended to the sound wave (e.g. while importing a live stream)
+	 * Running out of PCM data does not finish the playback until then, silence is played instead
+	 */
+	TAtomic<bool> bAwaitingPCMData{false};
+
+	/** Frame the streaming decoder is requested to prefetch, or a negative value if there is no request */
+	TAtomic<int64> PendingPrefetchFrame{-1};
+
+	/**
+	 * Range of frames decoded ahead of the decoded frames by the streaming decoder, e.g. at the seek target. Empty if the start equals the end
+	 * Available for playback in addition to the decoded frames. Written within the data guard
+	 */
+	TAtomic<uint32> PrefetchedStartFrame{0};
+	TAtomic<uint32> PrefetchedEndFrame{0};
+
+	/** Prevents PCM data from being released or reallocated while it is being read during playback or filled in by the streaming decoder */
+	FCriticalSection DataGuard;
+
+	/**
+	 * Get the number of allocations made by the imported sound waves while generating PCM data, which stays the same once the playback has warmed up
+	 * The allocations are only counted while RuntimeAudioImporter.TrackImportAllocations is enabled
+	 */
+	static int64 GetNumOfRenderAllocations();
+
+private:
+	/**
+	 * Broadcast the playback finish and the PCM data blocks queued during the generation requests. Called by the core ticker on the game thread
+	 *
+	 * @return Whether to keep ticking or not
+	 */
+	bool BroadcastPendingPlaybackEvents(float DeltaTime);
+
+	/**
+	 * Queue the retrieved PCM data to be broadcast to the listeners without allocating. The data is dropped if all pooled blocks are in use
+	 *
+	 * @param PCMData Retrieved PCM data in the storage format of the sound wave
+	 * @param NumOfSamples Number of retrieved samples
+	 */
+	void QueuePCMDataBlock(const uint8* PCMData, int32 NumOfSamples);
+
+	/** Number of pooled PCM data blocks, including the ones queued for the broadcast and the ones held by the listeners */
+	static constexpr int32 NumOfPooledPCMDataBlocks{16};
+
+	/** Number of PCM data blocks that can be queued for the broadcast at once. Power of two */
+	static constexpr uint32 PendingPCMDataBlocksCapacity{8};
+
+	/** Pooled PCM data blocks. A block is free when the pool holds the only reference to it */
+	TSharedPtr<FImportedPCMDataBlock, ESPMode::ThreadSafe> PCMDataBlockPool[NumOfPooledPCMDataBlocks];
+
+	/** PCM data blocks queued for the broadcast. Filled in by the generation requests and drained by the game thread */
+	TSharedPtr<FImportedPCMDataBlock, ESPMode::ThreadSafe> PendingPCMDataBlocks[PendingPCMDataBlocksCapacity];
+
+	/** Number of PCM data blocks ever queued and broadcast, used as the write and read positions of the queue */
+	TAtomic<uint32> NumOfQueuedPCMDataBlocks{0};
+	TAtomic<uint32> NumOfBroadcastPCMDataBlocks{0};
+
+	/** Whether the playback has finished and the finish is yet to be broadcast */
+	TAtomic<bool> bPlaybackFinishedPending{false};
+
+	/** Whether the playback has switched to a queued sound wave and the start is yet to be broadcast, so that the data guard is only locked when needed */
+	TAtomic<bool> bQueuedSoundWaveStartedPending{false};
+
+	/** Whether the core ticker broadcasting the pending playback events has been requested. The events only arise from the playback, so it is registered once the playback starts */
+	TAtomic<bool> bPlaybackEventsTickerRequested{false};
+
+	/** Handle of the core ticker broadcasting the pending playback events. Game thread only */
+	FTSTicker::FDelegateHandle PlaybackEventsTickerHandle;
+
+	/** Tap fed with the rendered PCM data. Created on first request and guarded by the data guard */
+	TSharedPtr<FImportedSoundWaveTap, ESPMode::ThreadSafe> Tap;
+
+	/** Time stretcher the PCM data is rendered through, if the tempo or the pitch is changed. Guarded by the data guard */
+	TUniquePtr<FImportedSoundWaveTimeStretcher> TimeStretcher;
+
+	/** Whether the time stretcher exists and matches the sample rate and the number of channels of the sound wave. Called within the data guard */
+	bool IsTimeStretcherCompatible() const;
+
+	/**
+	 * Render the PCM data of the sound wave and of the queued sound waves, looping and crossfading as requested. Called within the data guard
+	 *
+	 * @param OutPCMData PCM data in the storage format of the sound wave, large enough to hold the frames
+	 * @param NumOfFrames Number of frames to render
+	 * @return Number of rendered frames. Fewer than requested once the playback has finished
+	 */
+	int32 RenderPCMData(uint8* OutPCMData, int32 NumOfFrames);
+
+	/**
+	 * Crossfade the rendered part of the PCM data towards the loop start or the next queued sound wave, if it overlaps the crossfade region. Called within the data guard
+	 *
+	 * @param PCMData Rendered PCM data to crossfade in place
+	 * @param StartFrame Frame of the sound wave the rendered part starts at
+	 * @param NumOfFrames Number of rendered frames
+	 * @param SegmentEndFrame Frame at which the playback jumps to the loop start or switches to the next queued sound wave
+	 * @param bLooping Whether the playback jumps to the loop start or not
+	 */
+	void CrossfadeToNextSegment(uint8* PCMData, uint32 StartFrame, int32 NumOfFrames, uint32 SegmentEndFrame, bool bLooping) const;
+
+	/** Get the number of frames to crossfade when switching to the queued source. Called within the data guard */
+	uint32 GetNumOfCrossfadeFrames(const FQueuedPCMSource& QueuedSource) const;
+
+	/** Queued sound waves, kept alive until they finish playing. Guarded by the data guard */
+	UPROPERTY(Transient)
+	TArray<UImportedSoundWave*> QueuedSoundWaves;
+
+	/** The queued sound wave being played, kept alive while its PCM data is rendered. Game thread only */
+	UPROPERTY(Transient)
+	UImportedSoundWave* PlayingQueuedSoundWave = nullptr;
+
+	/** PCM data of the queued sound waves, in the same order. Guarded by the data guard */
+	TArray<FQueuedPCMSource> QueuedPCMSources;
+
+	/** Number of queued sources the playback has switched to, which are yet to be removed by the game thread. Guarded by the data guard */
+	int32 NumOfStartedQueuedPCMSources{0};
+
+	/** Number of decoded frames of the PCM data being played, which belongs to a queued sound wave once the playback has switched to it. Guarded by the data guard */
+	const TAtomic<uint32>* PlayingNumOfDecodedFrames{&NumOfDecodedFrames};
+
+	/** Loop region, in frames. Guarded by the data guard */
+	uint32 LoopStartFrame{0};
+	uint32 LoopEndFrame{0};
+
+	/** How many more times to jump back to the loop start. Infinite if less than zero, no loop if zero. Guarded by the data guard */
+	int32 NumOfRemainingLoops{0};
+
+	/** Number of frames to crossfade the loop and the queued sound waves over. Guarded by the data guard */
+	uint32 NumOfCrossfadeFrames{0};
+
+	/** Frame to seek to at the next generation request, or a negative value if there is no seek pending */
+	TAtomic<int64> PendingSeekFrame{-1};
+
+	/** Duration of the fade applied when seeking, in seconds */
+	static constexpr float SeekFadeDuration{0.005f};
+
+	/**
+	 * Fade the rendered PCM data in from the PCM data that would have been played without the seek, to avoid clicks. Called within the data guard
+	 *
+	 * @param PCMData Rendered PCM data, starting at the seek target
+	 * @param NumOfFrames Number of rendered frames
+	 * @param PreviousPCMData PCM data at the position before the seek. Null if there is none
+	 * @param NumOfPreviousFrames Number of frames available at the position before the seek
+	 */
+	void FadeInSeek(uint8* PCMData, int32 NumOfFrames, const uint8* PreviousPCMData, uint32 NumOfPreviousFrames) const;
+
+	/**
+	 * Get the frame up to which the PCM data being played is available, either decoded or prefetched. Called within the data guard
+	 *
+	 * @param StartFrame Frame the playback continues from
+	 * @param SegmentEndFrame Frame the available PCM data is limited to
+	 */
+	uint32 GetAvailableEndFrame(uint32 StartFrame, uint32 SegmentEndFrame) const;
 };
@@ -0,0 +1,148 @@
+// Georgy Treshchev 2022.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RuntimeAudioImporterTypes.h"
+#include "Templates/Atomic.h"
+
+/**
+ * Lock-free ring buffer fed with the PCM data rendered by an imported sound wave, intended for analysis (e.g. spectrum or VU meters)
+ * There is a single producer (the generation requests of the sound wave) and any number of consumers, each reading through its own FImportedSoundWaveTapReader
+ * Both writing and reading are wait-free. The producer never waits for the consumers and overwrites the oldest data instead, which the consumers detect as overruns
+ */
+class RUNTIMEAUDIOIMPORTER_API FImportedSoundWaveTap
+{
+public:
+	/**
+	 * Allocate the ring buffer
+	 *
+	 * @param InNumOfFrames Capacity of the ring buffer, in frames
+	 * @param InNumOfChannels Number of channels of the sound wave
+	 */
+	FImportedSoundWaveTap(int32 InNumOfFrames, int32 InNumOfChannels);
+
+	/**
+	 * Write the rendered PCM data, overwriting the oldest data if there is not enough space. Single producer only
+	 *
+	 * @param PCMData Interleaved PCM data
+	 * @param StorageFormat Storage format of the PCM data. It is always stored as 32-bit float
+	 * @param NumOfFrames Number of frames to write
+	 */
+	void Write(const uint8* PCMData, EPCMStorageFormat StorageFormat, int32 NumOfFrames);
+
+	/**
+	 * Copy the written frames. The copy is validated afterwards, since the producer may overwrite the frames while they are being copied
+	 *
+	 * @param StartFrame Absolute position of the first frame to copy. Must be written already
+	 * @param OutPCMData Interleaved 32-bit float PCM data, large enough to hold the frames
+	 * @param NumOfFrames Number of frames to copy
+	 * @return Absolute position of the first copied frame that was not overwritten. Equals to StartFrame if the whole copy is intact
+	 */
+	uint64 Read(uint64 StartFrame, float* OutPCMData, int32 NumOfFrames) const;
+
+	/** Get the total number of frames ever written, which is the absolute position the next frame is written at */
+	uint64 GetWritePosition() const
+	{
+		return WritePosition;
+	}
+
+	/** Get the capacity of the ring buffer, in frames */
+	int32 GetNumOfFrames() const
+	{
+		return NumOfFrames;
+	}
+
+	/** Get the number of channels of the stored PCM data */
+	int32 GetNumOfChannels() const
+	{
+		return NumOfChannels;
+	}
+
+private:
+	/** Interleaved 32-bit float PCM data. The frame at an absolute position is stored at the position modulo the capacity */
+	TArray<float> PCMData;
+
+	/** Capacity of the ring buffer, in frames */
+	int32 NumOfFrames;
+
+	/** Number of channels of the stored PCM data */
+	int32 NumOfChannels;
+
+	/** Absolute position up to which the frames are written and can be read */
+	TAtomic<uint64> WritePosition{0};
+
+	/** Absolute position up to which the frames are being written. Frames older than this by the capacity are overwritten or being overwritten */
+	TAtomic<uint64> WriteEndPosition{0};
+};
+
+/**
+ * Consumer of an imported sound wave tap. Keeps its own read position and overrun counter, so any number of consumers can read the same tap independently
+ * Reading does not allocate once the output array is large enough. A single reader is not thread safe, each thread should use its own
+ */
+class RUNTIMEAUDIOIMPORTER_API FImportedSoundWaveTapReader
+{
+public:
+	/**
+	 * Start reading the tap from the most recently written frame
+	 *
+	 * @param InTap The tap to read
+	 */
+	explicit FImportedSoundWaveTapReader(const TSharedRef<const FImportedSoundWaveTap, ESPMode::ThreadSafe>& InTap);
+
+	/**
+	 * Read the frames written since the previous read. If the producer has overwritten some of them, they are skipped and counted as an overrun
+	 *
+	 * @param OutPCMData Interleaved 32-bit float PCM data
+	 * @param MaxNumOfFrames Maximum number of frames to read. The rest are left for the next read
+	 * @return Number of read frames
+	 */
+	int32 ReadNew(TArray<float>& OutPCMData, int32 MaxNumOfFrames);
+
+	/**
+	 * Read the most recently written frames, without affecting the read position. Intended for pulling the latest data at frame rate (e.g. for a spectrum)
+	 *
+	 * @param OutPCMData Interleaved 32-bit float PCM data
+	 * @param NumOfFrames Number of frames to read. Fewer frames are read if not enough have been written yet
+	 * @return Number of read frames
+	 */
+	int32 ReadLatest(TArray<float>& OutPCMData, int32 NumOfFrames) const;
+
+	/** Get the number of times the producer has overwritten the frames before they were read */
+	uint64 GetNumOfOverruns() const
+	{
+		return NumOfOverruns;
+	}
+
+	/** Get the total number of frames overwritten before they were read */
+	uint64 GetNumOfDroppedFrames() const
+	{
+		return NumOfDroppedFrames;
+	}
+
+	/** Get the tap being read */
+	const TSharedRef<const FImportedSoundWaveTap, ESPMode::ThreadSafe>& GetTap() const
+	{
+		return Tap;
+	}
+
+private:
+	/**
+	 * Copy the frames into the output array, dropping the ones overwritten during the copy
+	 *
+	 * @return Absolute position of the first copied frame that was not overwritten
+	 */
+	uint64 CopyFrames(uint64 StartFrame, int32 NumOfFramesToCopy, TArray<float>& OutPCMData) const;
+
+	/** The tap being read */
+	TSharedRef<const FImportedSoundWaveTap, ESPMode::ThreadSafe> Tap;
+
+	/** Absolute position of the next frame to read */
+	uint64 ReadPosition;
+
+	/** Number of times the frames were overwritten before being read */
+	uint64 NumOfOverruns{0};
+
+	/** Number of frames overwritten before being read */
+	uint64 NumOfDroppedFrames{0};
+};
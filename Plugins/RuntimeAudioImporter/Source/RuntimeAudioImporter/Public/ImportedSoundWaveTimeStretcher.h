@@ -0,0 +1,166 @@
+// Georgy Treshchev 2022.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RuntimeAudioImporterTypes.h"
+
+/**
+ * Real-time time stretcher changing the tempo and the pitch of PCM data independently, using WSOLA (waveform similarity overlap-add)
+ * Each hop of the output crossfades the continuation of the previous segment into the most similar segment of the source around its nominal position, so the source is read faster or slower without changing the pitch
+ * The pitch is then shifted by resampling the stretched output. All state is allocated up front, and the cost of each output frame is bounded by the constant search range
+ * Not thread safe, the imported sound wave uses it within its data guard
+ */
+class RUNTIMEAUDIOIMPORTER_API FImportedSoundWaveTimeStretcher
+{
+public:
+	/**
+	 * Allocate the state of the time stretcher
+	 *
+	 * @param InSampleRate Sample rate of the PCM data
+	 * @param InNumOfChannels Number of channels of the PCM data
+	 */
+	FImportedSoundWaveTimeStretcher(int32 InSampleRate, int32 InNumOfChannels);
+
+	/** Range the tempo is clamped to */
+	static constexpr float MinTempo{0.25f};
+	static constexpr float MaxTempo{4.f};
+
+	/** Range the pitch shift is clamped to. The cost of rendering grows with the pitch shift */
+	static constexpr float MinPitchShift{0.5f};
+	static constexpr float MaxPitchShift{2.f};
+
+	/**
+	 * Set the playback speed ratio, without changing the pitch
+	 */
+	void SetTempo(float InTempo);
+
+	/**
+	 * Set the pitch ratio, without changing the playback speed
+	 */
+	void SetPitchShift(float InPitchShift);
+
+	float GetTempo() const
+	{
+		return Tempo;
+	}
+
+	float GetPitchShift() const
+	{
+		return PitchShift;
+	}
+
+	/**
+	 * Continue stretching from the frame of the source, e.g. after a seek. The frames already stretched are played first, and the next hop is crossfaded into the frame
+	 *
+	 * @param Frame Frame of the source to continue from
+	 */
+	void SetSourcePosition(uint32 Frame);
+
+	/** Get the frame of the source the next hop is stretched from */
+	uint32 GetSourcePosition() const
+	{
+		return static_cast<uint32>(SourcePosition);
+	}
+
+	/**
+	 * Start stretching from the frame of the source without crossfading, dropping the frames already stretched
+	 *
+	 * @param Frame Frame of the source to start from
+	 */
+	void Reset(uint32 Frame = 0);
+
+	/**
+	 * Render the stretched PCM data, advancing the source position
+	 *
+	 * @param SourcePCMData Interleaved PCM data of the source
+	 * @param StorageFormat Storage format of both the source and the rendered PCM data
+	 * @param SourceEndFrame Frame up to which the source is available
+	 * @param bSourceEnds Whether the source ends at the end frame, so the frames beyond it are treated as silence. Otherwise the rendering stops until more frames are available
+	 * @param OutPCMData Interleaved PCM data, large enough to hold the frames
+	 * @param NumOfFrames Number of frames to render
+	 * @return Number of rendered frames. Fewer than requested if the source has run out
+	 */
+	int32 Render(const uint8* SourcePCMData, EPCMStorageFormat StorageFormat, uint32 SourceEndFrame, bool bSourceEnds, uint8* OutPCMData, int32 NumOfFrames);
+
+	int32 GetSampleRate() const
+	{
+		return SampleRate;
+	}
+
+	int32 GetNumOfChannels() const
+	{
+		return NumOfChannels;
+	}
+
+private:
+	/**
+	 * Render the stretched PCM data as 32-bit float, advancing the source position
+	 *
+	 * @return Number of rendered frames. Fewer than requested if the source has run out
+	 */
+	int32 RenderFrames(const uint8* SourcePCMData, EPCMStorageFormat StorageFormat, uint32 SourceEndFrame, bool bSourceEnds, float* OutPCMData, int32 NumOfFrames);
+
+	/**
+	 * Stretch the next hop from the source into the hop PCM data
+	 *
+	 * @return Whether the hop was stretched or not. Not stretched if the source has run out
+	 */
+	bool StretchHop(const uint8* SourcePCMData, EPCMStorageFormat StorageFormat, uint32 SourceEndFrame, bool bSourceEnds);
+
+	/**
+	 * Read the frames of the source into the window PCM data as 32-bit float, filling in silence outside of the source
+	 */
+	void ReadSourceFrames(const uint8* SourcePCMData, EPCMStorageFormat StorageFormat, int64 StartFrame, int32 NumOfFramesToRead, uint32 SourceEndFrame);
+
+	/**
+	 * Find the segment of the window most similar to the overlap PCM data, by the normalized cross-correlation of the channels downmixed to mono
+	 *
+	 * @param SearchRadius Maximum distance of the segment from the nominal position, which is at the middle of the window
+	 * @return Offset of the segment from the nominal position
+	 */
+	int32 FindSimilarSegmentOffset(int32 SearchRadius);
+
+	int32 SampleRate;
+	int32 NumOfChannels;
+
+	/** Number of frames each hop of the output consists of, which is also the length of the crossfade */
+	int32 NumOfHopFrames;
+
+	/** Maximum distance of the stretched segment from its nominal position */
+	int32 MaxSearchRadius;
+
+	float Tempo{1.f};
+	float PitchShift{1.f};
+
+	/** Nominal frame of the source the next hop is stretched from. Fractional, as the source advances by a fractional number of frames per hop */
+	double SourcePosition{0};
+
+	/** Position of the next output frame in the hop PCM data. Fractional, as the stretched output is resampled to shift the pitch */
+	double HopReadPosition{0};
+
+	/** Whether the overlap PCM data holds the continuation of the previous segment, which the next hop is crossfaded from */
+	bool bHasOverlap{false};
+
+	/** Interleaved stretched hop. The first frame is the last frame of the previous hop, which the resampling interpolates from */
+	TArray<float> HopPCMData;
+
+	/** Interleaved frames rendered in 32-bit float before being converted to the signed 16-bit output */
+	TArray<float> RenderedPCMData;
+
+	/** Interleaved continuation of the previous segment */
+	TArray<float> OverlapPCMData;
+
+	/** Interleaved frames of the source the segment is searched within */
+	TArray<float> WindowPCMData;
+
+	/** The window and the overlap downmixed to mono */
+	TArray<float> WindowMonoPCMData;
+	TArray<float> OverlapMonoPCMData;
+
+	/** Prefix sums of the energy of the downmixed window, so that the energy of any segment takes a single subtraction */
+	TArray<float> WindowEnergy;
+
+	/** Gains of the crossfade into the segment */
+	TArray<float> FadeInGains;
+};
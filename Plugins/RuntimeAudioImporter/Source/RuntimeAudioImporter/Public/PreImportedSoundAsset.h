@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "RuntimeAudioImporterTypes.h"
+#include "Serialization/BulkData.h"
 #include "PreImportedSoundAsset.generated.h"
 
 /**
@@ -36,5 +37,70 @@ public:
 
 	UPROPERTY(Category = "Info", VisibleAnywhere, Meta = (DisplayName = "Sample rate"))
 	int32 SampleRate;
+
+	/** Whether to store the decoded PCM data along with the audio data, so that importing the asset at runtime requires no decoding at the cost of disk space */
+	UPROPERTY(Category = "Decoded PCM", EditAnywhere, Meta = (DisplayName = "Store decoded PCM"))
+	bool bStoreDecodedPCM = false;
 #endif
+
+	/** Format to store the decoded PCM data in. Signed 16-bit PCM halves the disk space at the cost of precision */
+	UPROPERTY(Category = "Decoded PCM", EditAnywhere, Meta = (DisplayName = "Decoded PCM storage format", EditCondition = "bStoreDecodedPCM"))
+	EPCMStorageFormat DecodedPCMStorageFormat = EPCMStorageFormat::Float32;
+
+	//~ Begin UObject Interface
+	virtual void Serialize(FArchive& Ar) override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+	//~ End UObject Interface
+
+#if WITH_EDITOR
+	/**
+	 * Decode the audio data and store the decoded PCM data, or remove the stored PCM data if it should not be stored
+	 *
+	 * @return Whether the decoded PCM data was updated successfully or not
+	 */
+	bool UpdateDecodedPCMData();
+#endif
+
+	/**
+	 * Check if the asset has the decoded PCM data stored
+	 */
+	bool HasDecodedPCMData() const;
+
+	/**
+	 * Load the stored decoded PCM data without decoding it. The data is loaded asynchronously once and shared between all callers afterwards. If supported by the platform, the data is memory-mapped instead of being read. Game thread only
+	 *
+	 * @param OnLoaded Called on the game thread with whether the loading was successful and the decoded audio data referencing the loaded PCM data. Each caller receives its own reference, which it may move further
+	 */
+	void LoadDecodedAudioData(TFunction<void(bool bSucceeded, FDecodedAudioStruct&& DecodedAudioInfo)> OnLoaded);
+
+private:
+	/**
+	 * Finish loading of the stored decoded PCM data and call the pending callbacks. Game thread only
+	 *
+	 * @param LoadedPCMData The loaded PCM data. Empty if the loading failed
+	 */
+	void OnDecodedPCMDataLoaded(FRuntimeBulkDataBuffer<uint8>&& LoadedPCMData);
+
+	/** Decoded PCM data payload. Stored separately from the rest of the asset, so that it is only loaded on demand */
+	FByteBulkData DecodedPCMBulkData;
+
+	/** Number of channels of the decoded PCM data */
+	UPROPERTY()
+	int32 DecodedNumOfChannels;
+
+	/** Sample rate of the decoded PCM data */
+	UPROPERTY()
+	int32 DecodedSampleRate;
+
+	/** Number of frames of the decoded PCM data */
+	UPROPERTY()
+	int32 DecodedNumOfFrames;
+
+	/** Loaded decoded PCM data, shared between the sound waves imported from the asset */
+	TSharedPtr<const FRuntimeBulkDataBuffer<uint8>, ESPMode::ThreadSafe> LoadedDecodedPCMData;
+
+	/** Callbacks waiting for the decoded PCM data being loaded */
+	TArray<TFunction<void(bool, FDecodedAudioStruct&&)>> PendingLoadCallbacks;
 };
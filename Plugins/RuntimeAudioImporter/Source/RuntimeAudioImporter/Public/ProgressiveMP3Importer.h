@@ -0,0 +1,128 @@
+// Georgy Treshchev 2022.
+
+#pragma once
+
+#include "ImportedSoundWave.h"
+#include "RuntimeAudioImporterTypes.h"
+#include "ProgressiveMP3Importer.generated.h"
+
+/** Static delegate broadcast to get the result of the progressive import. Success means that the sound wave is ready to be played, while the rest of the stream keeps being appended to it */
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnProgressiveImporterResultNative, class UProgressiveMP3Importer* ProgressiveImporterRef, UImportedSoundWave* SoundWaveRef, ETranscodingStatus Status);
+
+/** Dynamic delegate broadcast to get the result of the progressive import. Success means that the sound wave is ready to be played, while the rest of the stream keeps being appended to it */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnProgressiveImporterResult, class UProgressiveMP3Importer*, ProgressiveImporterRef, UImportedSoundWave*, SoundWaveRef, ETranscodingStatus, Status);
+
+
+/** Static delegate broadcast when the whole stream has been decoded and appended to the sound wave */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnProgressiveImporterFinishedNative, class UProgressiveMP3Importer* ProgressiveImporterRef, UImportedSoundWave* SoundWaveRef);
+
+/** Dynamic delegate broadcast when the whole stream has been decoded and appended to the sound wave */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnProgressiveImporterFinished, class UProgressiveMP3Importer*, ProgressiveImporterRef, UImportedSoundWave*, SoundWaveRef);
+
+/** Forward declaration of the decoding state of the progressive import */
+struct FProgressiveMP3ImportState;
+
+/**
+ * Importer of MP3 audio received as a growing byte stream (e.g. from a capture process)
+ * The MPEG audio frames are decoded in the background as soon as they arrive and appended to a sound wave that can be played while the stream is still being received
+ */
+UCLASS(BlueprintType, Category = "Runtime Audio Importer")
+class RUNTIMEAUDIOIMPORTER_API UProgressiveMP3Importer : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual ~UProgressiveMP3Importer() override;
+
+	//~ Begin UObject Interface
+	virtual void BeginDestroy() override;
+	//~ End UObject Interface
+
+	/** Bind to know when the sound wave is ready to be played (or the import has failed). Recommended for C++ only */
+	FOnProgressiveImporterResultNative OnResultNative;
+
+	/** Bind to know when the sound wave is ready to be played (or the import has failed). Recommended for Blueprints only */
+	UPROPERTY(BlueprintAssignable, Category = "Runtime Audio Importer|Delegates")
+	FOnProgressiveImporterResult OnResult;
+
+	/** Bind to know when the whole stream has been appended to the sound wave. Recommended for C++ only */
+	FOnProgressiveImporterFinishedNative OnFinishedNative;
+
+	/** Bind to know when the whole stream has been appended to the sound wave. Recommended for Blueprints only */
+	UPROPERTY(BlueprintAssignable, Category = "Runtime Audio Importer|Delegates")
+	FOnProgressiveImporterFinished OnFinished;
+
+	/**
+	 * Instantiates a progressive MP3 importer object
+	 *
+	 * @param PCMStorageFormat Format to store the PCM data of the imported sound wave in
+	 * @return The progressive MP3 importer object. Bind to it's OnResult and OnFinished delegates
+	 */
+	UFUNCTION(BlueprintCallable, meta = (Keywords = "Create, Audio, Runtime, Progressive, Live, Stream, MP3"), Category = "Runtime Audio Importer")
+	static UProgressiveMP3Importer* CreateProgressiveMP3Importer(EPCMStorageFormat PCMStorageFormat = EPCMStorageFormat::Float32);
+
+	/**
+	 * Append the next part of the MP3 stream. Thread safe
+	 *
+	 * @param AudioData The next part of the encoded audio data
+	 */
+	UFUNCTION(BlueprintCallable, meta = (Keywords = "Importer, Runtime, Progressive, Live, Stream, MP3"), Category = "Runtime Audio Importer|Import")
+	void AppendEncodedData(const TArray<uint8>& AudioData);
+
+	/**
+	 * Append the next part of the MP3 stream. The data is copied, so it does not have to remain valid after the call. Thread safe
+	 *
+	 * @param AudioData Pointer to the next part of the encoded audio data
+	 * @param AudioDataSize Size of the next part of the encoded audio data
+	 */
+	void AppendEncodedData(const uint8* AudioData, int64 AudioDataSize);
+
+	/**
+	 * Mark the end of the MP3 stream. The remaining data is decoded, after which the playback of the sound wave finishes once it reaches the end. Thread safe
+	 */
+	UFUNCTION(BlueprintCallable, meta = (Keywords = "Importer, Runtime, Progressive, Live, Stream, MP3"), Category = "Runtime Audio Importer|Import")
+	void FinishStream();
+
+	/**
+	 * Get the imported sound wave
+	 *
+	 * @return The imported sound wave, or nullptr if it is not ready to be played yet
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Audio Importer|Info")
+	UImportedSoundWave* GetSoundWave() const;
+
+protected:
+	/** Schedule decoding of the appended data in the background, unless it is already scheduled */
+	void ScheduleDecoding();
+
+	/**
+	 * Decode the appended data and append the decoded PCM data to the sound wave. Called from the background decoding tasks, which do not keep the importer alive, so it is not accessed
+	 *
+	 * @param State Decoding state of the progressive import
+	 */
+	static void DecodePendingData(const TSharedRef<FProgressiveMP3ImportState, ESPMode::ThreadSafe>& State);
+
+	/**
+	 * Progressive importing result callback. Thread safe
+	 *
+	 * @param WeakThis The progressive importer to broadcast the result of
+	 * @param SoundWaveRef Reference to the imported sound wave
+	 * @param Status Importing status
+	 */
+	static void OnResult_Internal(const TWeakObjectPtr<UProgressiveMP3Importer>& WeakThis, UImportedSoundWave* SoundWaveRef, ETranscodingStatus Status);
+
+	/**
+	 * Progressive importing finished callback. Thread safe
+	 *
+	 * @param WeakThis The progressive importer to broadcast the finish of
+	 */
+	static void OnFinished_Internal(const TWeakObjectPtr<UProgressiveMP3Importer>& WeakThis);
+
+private:
+	/** The sound wave the decoded PCM data is appended to. Created along with the importer, but exposed only once the format of the stream is known */
+	UPROPERTY()
+	UImportedSoundWave* SoundWave;
+
+	/** Decoding state shared with the background decoding tasks */
+	TSharedPtr<FProgressiveMP3ImportState, ESPMode::ThreadSafe> State;
+};
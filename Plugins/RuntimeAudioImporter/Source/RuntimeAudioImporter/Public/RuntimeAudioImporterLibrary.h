@@ -19,9 +19,29 @@ DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnAudioImporterResultNative, class URunt
 /** Dynamic delegate broadcast to get the audio importer result */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnAudioImporterResult, class URuntimeAudioImporterLibrary*, RuntimeAudioImporterObjectRef, UImportedSoundWave*, SoundWaveRef, ETranscodingStatus, Status);
 
+
+/** Static delegate broadcast when the background decoding of a sound wave imported in streaming mode has finished, either completely or cut short by cancellation */
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnAudioImporterStreamingFinishedNative, class URuntimeAudioImporterLibrary* RuntimeAudioImporterObjectRef, UImportedSoundWave* SoundWaveRef, bool bCancelled);
+
+/** Dynamic delegate broadcast when the background decoding of a sound wave imported in streaming mode has finished, either completely or cut short by cancellation */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnAudioImporterStreamingFinished, class URuntimeAudioImporterLibrary*, RuntimeAudioImporterObjectRef, UImportedSoundWave*, SoundWaveRef, bool, bCancelled);
+
+
+/** Static delegate broadcast to get the progress and results of the batch import */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnAudioImporterBatchProgressNative, class URuntimeAudioImporterLibrary* RuntimeAudioImporterObjectRef, const FBatchImportProgress& Progress);
+
+/** Dynamic delegate broadcast to get the progress and results of the batch import */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnAudioImporterBatchProgress, class URuntimeAudioImporterLibrary*, RuntimeAudioImporterObjectRef, const FBatchImportProgress&, Progress);
+
 /** Forward declaration of the UPreImportedSoundAsset class */
 class UPreImportedSoundAsset;
 
+/** Forward declaration of the shared state of the batch import */
+struct FBatchImportState;
+
+/** Forward declaration of the collector of the import statistics */
+class FAudioImportStatsCollector;
+
 /**
  * Runtime Audio Importer library
  * Various functions related to transcoding audio data, such as importing audio files, manually encoding / decoding audio data and more
@@ -46,6 +66,35 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Runtime Audio Importer|Delegates")
 	FOnAudioImporterResult OnResult;
 
+	/** Bind to know when the sound wave imported in streaming mode has been decoded completely, or truncated to the frames decoded so far if the import was cancelled. Recommended for C++ only */
+	FOnAudioImporterStreamingFinishedNative OnStreamingFinishedNative;
+
+	/** Bind to know when the sound wave imported in streaming mode has been decoded completely, or truncated to the frames decoded so far if the import was cancelled. Recommended for Blueprints only */
+	UPROPERTY(BlueprintAssignable, Category = "Runtime Audio Importer|Delegates")
+	FOnAudioImporterStreamingFinished OnStreamingFinished;
+
+	/** Bind to know the progress and results of each file imported as part of a batch. Recommended for C++ only */
+	FOnAudioImporterBatchProgressNative OnBatchProgressNative;
+
+	/** Bind to know the progress and results of each file imported as part of a batch. Recommended for Blueprints only */
+	UPROPERTY(BlueprintAssignable, Category = "Runtime Audio Importer|Delegates")
+	FOnAudioImporterBatchProgress OnBatchProgress;
+
+	/** Format to store the PCM data of the imported sound waves in. Signed 16-bit PCM halves memory usage at the cost of precision */
+	UPROPERTY(BlueprintReadWrite, Category = "Runtime Audio Importer")
+	EPCMStorageFormat PCMStorageFormat = EPCMStorageFormat::Float32;
+
+	/** Sample rate to resample the imported sound waves to at import time, so that the audio mixer does not have to resample them during playback. Zero to keep the original sample rate */
+	UPROPERTY(BlueprintReadWrite, meta = (ClampMin = "0"), Category = "Runtime Audio Importer")
+	int32 TargetSampleRate = 0;
+
+	/**
+	 * Statistics of the import whose result is being broadcast. Set right before OnResult is broadcast, so read it from the OnResult handlers
+	 * Collected for the file, buffer and pre-imported sound imports. For the streaming imports, only the part up to the first chunk is covered. Not collected for the batch imports, which do not broadcast OnResult
+	 */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	FAudioImportStats LastImportStats;
+
 	/**
 	 * Instantiates a RuntimeAudioImporter object
 	 *
@@ -63,6 +112,27 @@ public:
 	UFUNCTION(BlueprintCallable, meta = (Keywords = "Importer, Transcoder, Converter, Runtime, MP3, FLAC, WAV, OGG, Vorbis"), Category = "Runtime Audio Importer|Import")
 	void ImportAudioFromFile(const FString& FilePath, EAudioFormat Format);
 
+	/**
+	 * Import audio from file in streaming mode. The sound wave is returned as soon as the first chunk is decoded, and the rest of the audio data keeps being decoded in the background
+	 *
+	 * @param FilePath Path to the audio file to import
+	 * @param Format Audio format
+	 * @param NumOfFramesPerChunk The number of frames to decode at a time
+	 */
+	UFUNCTION(BlueprintCallable, meta = (Keywords = "Importer, Transcoder, Converter, Runtime, Streaming, MP3, FLAC, WAV, OGG, Vorbis"), Category = "Runtime Audio Importer|Import")
+	void ImportAudioFromFileStreamed(const FString& FilePath, EAudioFormat Format, int32 NumOfFramesPerChunk = 65536);
+
+	/**
+	 * Import multiple audio files in parallel using a bounded number of workers. Progress and results of each file are reported through the OnBatchProgress delegates
+	 * An empty batch is reported as complete right away, with a single finished progress that does not refer to any file
+	 *
+	 * @param FilePaths Paths to the audio files to import. The audio format of each file is determined automatically
+	 * @param NumOfWorkers The maximum number of files decoded at the same time. Limited to the number of task graph worker threads
+	 * @param MaxDecodedMegabytesInFlight The maximum amount of decoded audio data (in megabytes) held by the files being imported at the same time
+	 */
+	UFUNCTION(BlueprintCallable, meta = (Keywords = "Importer, Transcoder, Converter, Runtime, Batch, Playlist, MP3, FLAC, WAV, OGG, Vorbis"), Category = "Runtime Audio Importer|Import")
+	void ImportAudioFromFiles(const TArray<FString>& FilePaths, int32 NumOfWorkers = 4, int32 MaxDecodedMegabytesInFlight = 512);
+
 	/**
 	 * Import audio file from the pre-imported sound asset
 	 *
@@ -80,6 +150,16 @@ public:
 	UFUNCTION(BlueprintCallable, meta = (Keywords = "Importer, Transcoder, Converter, Runtime, MP3, FLAC, WAV, OGG, Vorbis"), Category = "Runtime Audio Importer|Import")
 	void ImportAudioFromBuffer(TArray<uint8> AudioData, EAudioFormat Format);
 
+	/**
+	 * Import audio from buffer in streaming mode. The sound wave is returned as soon as the first chunk is decoded, and the rest of the audio data keeps being decoded in the background
+	 *
+	 * @param AudioData Audio data array
+	 * @param Format Audio format
+	 * @param NumOfFramesPerChunk The number of frames to decode at a time
+	 */
+	UFUNCTION(BlueprintCallable, meta = (Keywords = "Importer, Transcoder, Converter, Runtime, Streaming, MP3, FLAC, WAV, OGG, Vorbis"), Category = "Runtime Audio Importer|Import")
+	void ImportAudioFromBufferStreamed(TArray<uint8> AudioData, EAudioFormat Format, int32 NumOfFramesPerChunk = 65536);
+
 	/**
 	 * Import audio from RAW file. Audio data must not have headers and must be uncompressed
 	 *
@@ -102,6 +182,13 @@ public:
 	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Import Audio From RAW Buffer"), Category = "Runtime Audio Importer|Import")
 	void ImportAudioFromRAWBuffer(TArray<uint8> RAWBuffer, ERAWAudioFormat Format, int32 SampleRate = 44100, int32 NumOfChannels = 1);
 
+	/**
+	 * Cancel all imports of this importer that are currently in progress. Their partially decoded data is released and the result is reported with the Cancelled status
+	 * The sound waves imported in streaming mode, which have already been reported, keep the frames decoded so far and are reported through the OnStreamingFinished delegates instead
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Audio Importer|Import")
+	void CancelImport();
+
 	/**
 	 * Transcoding one RAW Data format to another
 	 *
@@ -111,10 +198,10 @@ public:
 	 * @param FormatTo Required format
 	 */
 	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Transcode RAW Data From Buffer"), Category = "Runtime Audio Importer|Transcode")
-	static void TranscodeRAWDataFromBuffer(TArray<uint8> RAWData_From, ERAWAudioFormat FormatFrom, TArray<uint8>& RAWData_To, ERAWAudioFormat FormatTo);
+	static void TranscodeRAWDataFromBuffer(const TArray<uint8>& RAWData_From, ERAWAudioFormat FormatFrom, TArray<uint8>& RAWData_To, ERAWAudioFormat FormatTo);
 
 	/**
-	 * Transcoding one RAW Data format to another
+	 * Transcoding one RAW Data format to another. The file is transcoded in chunks, so the memory usage does not depend on the file size
 	 *
 	 * @param FilePathFrom Path to file with RAW data for transcoding
 	 * @param FormatFrom Original format
@@ -174,9 +261,11 @@ public:
 	 *
 	 * @param EncodedAudioInfo Encoded audio data
 	 * @param DecodedAudioInfo Decoded audio data
+	 * @param CancellationToken Optional token checked between decoded chunks. The decoding fails if the cancellation is requested
+	 * @param Progress Optional progress updated between decoded chunks
 	 * @return Whether the decoding was successful or not
 	 */
-	static bool DecodeAudioData(FEncodedAudioStruct& EncodedAudioInfo, FDecodedAudioStruct& DecodedAudioInfo);
+	static bool DecodeAudioData(FEncodedAudioStruct& EncodedAudioInfo, FDecodedAudioStruct& DecodedAudioInfo, const FAudioImportCancellationToken* CancellationToken = nullptr, FAudioDecodingProgress* Progress = nullptr);
 
 	/**
 	 * Encode uncompressed audio data to compressed
@@ -196,6 +285,66 @@ public:
 	 */
 	static EAudioFormat GetAudioFormat(const uint8* AudioData, int32 AudioDataSize);
 
+	/**
+	 * Determine audio format based only on the header of the audio data (magic bytes, frame headers), without initializing any decoders
+	 *
+	 * @param AudioData Pointer to in-memory audio data
+	 * @param AudioDataSize Size of in-memory audio data
+	 * @param Confidence How certain the determined format is, from 0 (unknown) to 100 (certain)
+	 * @return The most likely audio format, or EAudioFormat::Invalid if no format matches
+	 */
+	static EAudioFormat SniffAudioFormat(const uint8* AudioData, int64 AudioDataSize, uint8& Confidence);
+
+	/**
+	 * Get basic audio information (e.g. duration, number of channels, etc) by reading only the headers of the audio data, without decoding it
+	 *
+	 * @param AudioData Pointer to in-memory audio data
+	 * @param AudioDataSize Size of in-memory audio data
+	 * @param AudioFormat Audio format. Determined from the audio data if set to EAudioFormat::Auto
+	 * @param SoundWaveBasicInfo Basic audio information. The duration is zero if it cannot be determined without decoding the audio data
+	 * @return Whether the headers were read successfully or not
+	 */
+	static bool ProbeAudioInfo(const uint8* AudioData, int64 AudioDataSize, EAudioFormat& AudioFormat, FSoundWaveBasicStruct& SoundWaveBasicInfo);
+
+	/**
+	 * Check that the whole audio data can be decoded. The audio data is decoded in chunks into a reused buffer, so the decoded audio data is never held in memory as a whole. Thread safe
+	 *
+	 * @param AudioData Pointer to in-memory audio data
+	 * @param AudioDataSize Size of in-memory audio data
+	 * @param AudioFormat Audio format
+	 * @return Whether the audio data was decoded successfully or not
+	 */
+	static bool ValidateAudioData(const uint8* AudioData, int64 AudioDataSize, EAudioFormat AudioFormat);
+
+	/**
+	 * Transcoding one RAW Data format to another in-place. The array is reallocated only if the transcoded data does not fit into it
+	 *
+	 * @param RAWData RAW data to transcode
+	 * @param FormatFrom Original format
+	 * @param FormatTo Required format
+	 */
+	static void TranscodeRAWDataInPlace(TArray<uint8>& RAWData, ERAWAudioFormat FormatFrom, ERAWAudioFormat FormatTo);
+
+	/**
+	 * Import audio from encoded audio data without copying it
+	 *
+	 * @param AudioData Encoded audio data (e.g. a moved array or a memory-mapped file)
+	 * @param AudioFormat Audio format
+	 * @param CacheKey Key to add the decoded audio data to the decoded audio cache with. Not cached if empty
+	 * @param StatsCollector Collector of the import statistics. Created if null
+	 */
+	void ImportAudioFromEncodedBuffer(FRuntimeBulkDataBuffer<uint8>&& AudioData, EAudioFormat AudioFormat, const FString& CacheKey = FString(), TSharedPtr<FAudioImportStatsCollector, ESPMode::ThreadSafe> StatsCollector = nullptr);
+
+	/**
+	 * Import audio from encoded audio data without copying it, in streaming mode
+	 *
+	 * @param AudioData Encoded audio data (e.g. a moved array or a memory-mapped file)
+	 * @param AudioFormat Audio format
+	 * @param NumOfFramesPerChunk The number of frames to decode at a time
+	 * @param StatsCollector Collector of the import statistics, which cover the import up to the first chunk. Created if null
+	 */
+	void ImportAudioFromEncodedBufferStreamed(FRuntimeBulkDataBuffer<uint8>&& AudioData, EAudioFormat AudioFormat, int32 NumOfFramesPerChunk, TSharedPtr<FAudioImportStatsCollector, ESPMode::ThreadSafe> StatsCollector = nullptr);
+
 	/**
 	 * Import audio from 32-bit float PCM data
 	 *
@@ -207,20 +356,20 @@ public:
 	void ImportAudioFromFloat32Buffer(uint8* PCMData, const int32 PCMDataSize, const int32 SampleRate = 44100, const int32 NumOfChannels = 1);
 
 	/**
-	 * Create Imported Sound Wave and finish importing.
+	 * Create Imported Sound Wave and finish importing. The decoded PCM data is moved to the sound wave without being copied
 	 *
-	 * @param DecodedAudioInfo Decoded audio data
+	 * @param DecodedAudioInfo Decoded audio data. Its PCM data is no longer valid after the call
+	 * @param StatsCollector Collector of the import statistics. No statistics are collected if null
 	 */
-	void ImportAudioFromDecodedInfo(const FDecodedAudioStruct& DecodedAudioInfo);
+	void ImportAudioFromDecodedInfo(FDecodedAudioStruct&& DecodedAudioInfo, const TSharedPtr<FAudioImportStatsCollector, ESPMode::ThreadSafe>& StatsCollector = nullptr);
 
 	/**
 	 * Define SoundWave object reference
 	 *
 	 * @param SoundWaveRef Reference to the imported sound wave
-	 * @param DecodedAudioInfo Decoded audio data
-	 * @return Whether the defining was successful or not
+	 * @param DecodedAudioInfo Decoded audio data. Its PCM data is moved to the sound wave and is no longer valid after the call
 	 */
-	virtual void DefineSoundWave(UImportedSoundWave* SoundWaveRef, const FDecodedAudioStruct& DecodedAudioInfo);
+	virtual void DefineSoundWave(UImportedSoundWave* SoundWaveRef, FDecodedAudioStruct&& DecodedAudioInfo);
 
 	/**
 	 * Fill SoundWave basic information (e.g. duration, number of channels, etc)
@@ -231,29 +380,78 @@ public:
 	static void FillSoundWaveBasicInfo(UImportedSoundWave* SoundWaveRef, const FDecodedAudioStruct& DecodedAudioInfo);
 
 	/**
-	 * Fill SoundWave PCM data buffer
+	 * Fill SoundWave PCM data buffer by moving the decoded PCM data instead of copying it
 	 *
 	 * @param SoundWaveRef Reference to the imported sound wave
-	 * @param DecodedAudioInfo Decoded audio data
+	 * @param DecodedAudioInfo Decoded audio data. Its PCM data is no longer valid after the call
 	 */
-	static void FillPCMData(UImportedSoundWave* SoundWaveRef, const FDecodedAudioStruct& DecodedAudioInfo);
+	static void FillPCMData(UImportedSoundWave* SoundWaveRef, FDecodedAudioStruct&& DecodedAudioInfo);
 
 protected:
 	/** Creates a new instance of the ImportedSoundWave class to use */
 	virtual UImportedSoundWave* CreateImportedSoundWave() const;
 
 	/**
-	 * Audio transcoding progress callback
+	 * Audio transcoding progress callback. Thread safe. The latest percentage is broadcast on the game thread at most once per frame
 	 * 
 	 * @param Percentage Percentage of importing completion (0-100%)
 	 */
 	void OnProgress_Internal(int32 Percentage);
 
+	/** Broadcast the latest percentage reported by OnProgress_Internal, unless it has already been broadcast. Game thread only */
+	void BroadcastPendingProgress();
+
 	/**
 	 * Audio importing finished callback
 	 * 
 	 * @param SoundWaveRef Reference to the imported sound wave
 	 * @param Status Importing status
+	 * @param StatsCollector Collector of the import statistics. No statistics are broadcast if null
 	 */
-	void OnResult_Internal(UImportedSoundWave* SoundWaveRef, ETranscodingStatus Status);
+	void OnResult_Internal(UImportedSoundWave* SoundWaveRef, ETranscodingStatus Status, const TSharedPtr<FAudioImportStatsCollector, ESPMode::ThreadSafe>& StatsCollector = nullptr);
+
+	/**
+	 * Import a single file of the batch. Called from the batch import workers, which do not keep the importer alive, so it is only accessed through the weak pointer
+	 *
+	 * @param WeakThis The importer that started the batch import
+	 * @param State Shared state of the batch import
+	 * @param FileIndex Index of the file in the batch
+	 */
+	static void ImportFileFromBatch(const TWeakObjectPtr<URuntimeAudioImporterLibrary>& WeakThis, const TSharedRef<FBatchImportState, ESPMode::ThreadSafe>& State, int32 FileIndex);
+
+	/**
+	 * Batch import progress callback. Thread safe. The intermediate progress of the files is broadcast on the game thread at most once per frame, and nothing is broadcast once the importer is destroyed
+	 *
+	 * @param WeakThis The importer that started the batch import
+	 * @param State Shared state of the batch import
+	 * @param FileIndex Index of the file in the batch
+	 * @param FilePercentage Percentage of importing completion of the file (0-100%)
+	 * @param SoundWaveRef Reference to the imported sound wave. Valid only if the import of the file is complete
+	 * @param Status Importing status of the file
+	 * @param bFinished Whether the import of the file is complete
+	 */
+	static void OnBatchProgress_Internal(const TWeakObjectPtr<URuntimeAudioImporterLibrary>& WeakThis, const TSharedRef<FBatchImportState, ESPMode::ThreadSafe>& State, int32 FileIndex, int32 FilePercentage, UImportedSoundWave* SoundWaveRef, ETranscodingStatus Status, bool bFinished);
+
+	/**
+	 * Broadcast the batch import progress of the file. Game thread only
+	 *
+	 * @note The parameters are the same as for OnBatchProgress_Internal, except for WeakThis
+	 */
+	void BroadcastBatchProgress(const TSharedRef<FBatchImportState, ESPMode::ThreadSafe>& State, int32 FileIndex, int32 FilePercentage, UImportedSoundWave* SoundWaveRef, ETranscodingStatus Status, bool bFinished);
+
+	/** Get the cancellation token for the imports being started. Thread safe */
+	TSharedRef<FAudioImportCancellationToken, ESPMode::ThreadSafe> GetCancellationToken() const;
+
+private:
+	/** Token shared with the imports in progress. Cancelled and replaced with a new one by CancelImport */
+	TSharedRef<FAudioImportCancellationToken, ESPMode::ThreadSafe> CancellationToken = MakeShared<FAudioImportCancellationToken, ESPMode::ThreadSafe>();
+
+	/** Guards CancellationToken, since the imports may be started from different threads */
+	mutable FCriticalSection CancellationTokenGuard;
+
+	/** The latest percentage reported by OnProgress_Internal */
+	TAtomic<int32> PendingPercentage{0};
+
+	/** Whether a broadcast of the latest percentage is scheduled */
+	TAtomic<bool> bProgressBroadcastPending{false};
 };
@@ -5,8 +5,9 @@
 #include "Engine/EngineBaseTypes.h"
 #include "Sound/SoundGroups.h"
 #include "RuntimeAudioImporterDefines.h"
-#include "Serialization/BulkDataBuffer.h"
 #include "HAL/UnrealMemory.h"
+#include "Async/MappedFileHandle.h"
+#include "Templates/Atomic.h"
 
 #include "RuntimeAudioImporterTypes.generated.h"
 
@@ -30,7 +31,10 @@ enum class ETranscodingStatus : uint8
 	AudioDoesNotExist UMETA(DisplayName = "Audio does not exist"),
 
 	/** Load file to array error */
-	LoadFileToArrayError UMETA(DisplayName = "Load file to array error")
+	LoadFileToArrayError UMETA(DisplayName = "Load file to array error"),
+
+	/** The import was cancelled */
+	Cancelled UMETA(DisplayName = "Cancelled")
 };
 
 /** Possible audio formats (extensions) */
@@ -55,6 +59,14 @@ enum class ERAWAudioFormat : uint8
 	Float32 UMETA(DisplayName = "32-bit float")
 };
 
+/** Possible formats of PCM data stored in memory */
+UENUM(BlueprintType, Category = "Runtime Audio Importer")
+enum class EPCMStorageFormat : uint8
+{
+	Float32 UMETA(DisplayName = "32-bit float"),
+	Int16 UMETA(DisplayName = "Signed 16-bit PCM (half the memory)")
+};
+
 /** Basic SoundWave data. CPP use only. */
 struct FSoundWaveBasicStruct
 {
@@ -78,22 +90,314 @@ struct FSoundWaveBasicStruct
 	}
 };
 
+/**
+ * Bulk data buffer which, unlike FBulkDataBuffer, can also reference memory it did not allocate itself,
+ * such as the data of a moved array, a memory-mapped file region or another shared buffer, so that it does not have to be copied
+ */
+template <typename DataType>
+class FRuntimeBulkDataBuffer
+{
+public:
+	using ViewType = TArrayView64<DataType>;
+
+	/** Base constructor */
+	FRuntimeBulkDataBuffer() = default;
+
+	/** The buffer is move-only, so that the data is never copied implicitly. Use Clone to copy the data or Share to reference it */
+	FRuntimeBulkDataBuffer(const FRuntimeBulkDataBuffer&) = delete;
+	FRuntimeBulkDataBuffer& operator=(const FRuntimeBulkDataBuffer&) = delete;
+
+	/** Move constructor */
+	FRuntimeBulkDataBuffer(FRuntimeBulkDataBuffer&& Other) noexcept
+	{
+		*this = MoveTemp(Other);
+	}
+
+	/** Take ownership of the memory allocated with FMemory::Malloc */
+	FRuntimeBulkDataBuffer(DataType* InBuffer, int64 InNumberOfElements)
+		: View(InBuffer, InNumberOfElements)
+	  , NumOfAllocatedElements{InNumberOfElements}
+	  , bOwnsHeapBuffer{true}
+	{
+	}
+
+	/** Take ownership of the array data without copying it */
+	explicit FRuntimeBulkDataBuffer(TArray<DataType>&& InArray)
+		: ArrayBuffer(MoveTemp(InArray))
+	{
+		View = ViewType(ArrayBuffer.GetData(), ArrayBuffer.Num());
+	}
+
+	/** Reference the memory-mapped file region, which is kept mapped for the lifetime of the buffer. The data is read-only */
+	FRuntimeBulkDataBuffer(TUniquePtr<IMappedFileHandle>&& InMappedFileHandle, TUniquePtr<IMappedFileRegion>&& InMappedFileRegion)
+		: MappedFileHandle(MoveTemp(InMappedFileHandle))
+	  , MappedFileRegion(MoveTemp(InMappedFileRegion))
+	{
+		View = ViewType(const_cast<DataType*>(reinterpret_cast<const DataType*>(MappedFileRegion->GetMappedPtr())), MappedFileRegion->GetMappedSize() / sizeof(DataType));
+	}
+
+	/** Reference the data of the shared buffer, which is kept alive for the lifetime of this buffer. The data is read-only */
+	explicit FRuntimeBulkDataBuffer(const TSharedRef<const FRuntimeBulkDataBuffer, ESPMode::ThreadSafe>& InSharedBuffer)
+		: SharedBuffer(InSharedBuffer)
+	{
+		View = InSharedBuffer->GetView();
+	}
+
+	~FRuntimeBulkDataBuffer()
+	{
+		FreeBuffer();
+	}
+
+	FRuntimeBulkDataBuffer& operator=(FRuntimeBulkDataBuffer&& Other) noexcept
+	{
+		if (this != &Other)
+		{
+			FreeBuffer();
+
+			ArrayBuffer = MoveTemp(Other.ArrayBuffer);
+			SharedBuffer = MoveTemp(Other.SharedBuffer);
+			MappedFileHandle = MoveTemp(Other.MappedFileHandle);
+			MappedFileRegion = MoveTemp(Other.MappedFileRegion);
+			View = Other.View;
+			NumOfAllocatedElements = Other.NumOfAllocatedElements;
+			bOwnsHeapBuffer = Other.bOwnsHeapBuffer;
+
+			Other.View = ViewType();
+			Other.NumOfAllocatedElements = 0;
+			Other.bOwnsHeapBuffer = false;
+		}
+
+		return *this;
+	}
+
+	/**
+	 * Copy the data into a newly allocated (and therefore writable) buffer
+	 *
+	 * @param NumOfSlackElements Number of elements to allocate beyond the data, so that as many can be appended without reallocating
+	 * @return The buffer owning the copied data
+	 */
+	FRuntimeBulkDataBuffer Clone(int64 NumOfSlackElements = 0) const
+	{
+		if (View.Num() + NumOfSlackElements == 0)
+		{
+			return FRuntimeBulkDataBuffer();
+		}
+
+		const int64 BufferSize{View.Num() * static_cast<int64>(sizeof(DataType))};
+		FRuntimeBulkDataBuffer ClonedBuffer(static_cast<DataType*>(FMemory::Malloc(BufferSize + NumOfSlackElements * static_cast<int64>(sizeof(DataType)))), View.Num());
+		FMemory::Memcpy(ClonedBuffer.View.GetData(), View.GetData(), BufferSize);
+		ClonedBuffer.NumOfAllocatedElements = View.Num() + NumOfSlackElements;
+
+		return ClonedBuffer;
+	}
+
+	/**
+	 * Reference the data without copying it. Unless the data is shared already, it is moved into a shared buffer first, which both buffers reference afterwards
+	 * The data stays at the same address, but becomes read-only for both buffers
+	 *
+	 * @return The buffer referencing the same data
+	 */
+	FRuntimeBulkDataBuffer Share()
+	{
+		if (View.Num() == 0)
+		{
+			return FRuntimeBulkDataBuffer();
+		}
+
+		if (!SharedBuffer.IsValid())
+		{
+			const TSharedRef<const FRuntimeBulkDataBuffer, ESPMode::ThreadSafe> NewSharedBuffer = MakeShared<FRuntimeBulkDataBuffer, ESPMode::ThreadSafe>(MoveTemp(*this));
+			*this = FRuntimeBulkDataBuffer(NewSharedBuffer);
+		}
+
+		return FRuntimeBulkDataBuffer(SharedBuffer.ToSharedRef());
+	}
+
+	/** Release the data */
+	void Empty()
+	{
+		FreeBuffer();
+	}
+
+	/** Release the current data and take ownership of the memory allocated with FMemory::Malloc */
+	void Reset(DataType* InBuffer, int64 InNumberOfElements)
+	{
+		FreeBuffer();
+
+		View = ViewType(InBuffer, InNumberOfElements);
+		NumOfAllocatedElements = InNumberOfElements;
+		bOwnsHeapBuffer = true;
+	}
+
+	/**
+	 * Append the data to the end of the buffer. The heap buffer grows geometrically, so that appending in small portions takes amortized constant time
+	 * Data the buffer does not own (e.g. array, memory-mapped or shared data) is copied into a newly allocated heap buffer first
+	 *
+	 * @param InData Pointer to the data to append
+	 * @param InNumberOfElements Number of elements to append
+	 */
+	void Append(const DataType* InData, int64 InNumberOfElements)
+	{
+		const int64 NumOfElements{View.Num()};
+		const int64 NewNumOfElements{NumOfElements + InNumberOfElements};
+
+		if (!bOwnsHeapBuffer || NewNumOfElements > NumOfAllocatedElements)
+		{
+			const int64 NewNumOfAllocatedElements{FMath::Max<int64>(NewNumOfElements, NumOfAllocatedElements * 2)};
+
+			if (bOwnsHeapBuffer)
+			{
+				View = ViewType(static_cast<DataType*>(FMemory::Realloc(View.GetData(), NewNumOfAllocatedElements * sizeof(DataType))), NumOfElements);
+				NumOfAllocatedElements = NewNumOfAllocatedElements;
+			}
+			else
+			{
+				DataType* NewBuffer = static_cast<DataType*>(FMemory::Malloc(NewNumOfAllocatedElements * sizeof(DataType)));
+				FMemory::Memcpy(NewBuffer, View.GetData(), NumOfElements * sizeof(DataType));
+
+				Reset(NewBuffer, NumOfElements);
+				NumOfAllocatedElements = NewNumOfAllocatedElements;
+			}
+		}
+
+		FMemory::Memcpy(View.GetData() + NumOfElements, InData, InNumberOfElements * sizeof(DataType));
+		View = ViewType(View.GetData(), NewNumOfElements);
+	}
+
+	/** Get a view of the data */
+	const ViewType& GetView() const
+	{
+		return View;
+	}
+
+	/** Get the number of elements that can be appended without reallocating. Data the buffer does not own has no slack */
+	int64 GetSlack() const
+	{
+		return bOwnsHeapBuffer ? NumOfAllocatedElements - View.Num() : 0;
+	}
+
+	/** Whether the data can be modified in place. Memory-mapped and shared data is read-only */
+	bool IsWritable() const
+	{
+		return !MappedFileRegion.IsValid() && !SharedBuffer.IsValid();
+	}
+
+	/** Copy the read-only data into a newly allocated buffer so that it can be modified in place */
+	void MakeWritable()
+	{
+		if (!IsWritable())
+		{
+			const int64 BufferSize{View.Num() * static_cast<int64>(sizeof(DataType))};
+			DataType* BufferCopy = static_cast<DataType*>(FMemory::Memcpy(FMemory::Malloc(BufferSize), View.GetData(), BufferSize));
+
+			Reset(BufferCopy, View.Num());
+		}
+	}
+
+private:
+	void FreeBuffer()
+	{
+		if (bOwnsHeapBuffer)
+		{
+			FMemory::Free(View.GetData());
+			bOwnsHeapBuffer = false;
+		}
+
+		ArrayBuffer.Empty();
+		SharedBuffer.Reset();
+
+		// The region must be unmapped before the file handle is closed
+		MappedFileRegion.Reset();
+		MappedFileHandle.Reset();
+
+		View = ViewType();
+		NumOfAllocatedElements = 0;
+	}
+
+	/** Array whose data is referenced by the view, if the buffer was created from an array */
+	TArray<DataType> ArrayBuffer;
+
+	/** Shared buffer whose data is referenced by the view, if the buffer was created from a shared buffer */
+	TSharedPtr<const FRuntimeBulkDataBuffer, ESPMode::ThreadSafe> SharedBuffer;
+
+	/** Mapped file handle and region referenced by the view, if the buffer was created from a memory-mapped file */
+	TUniquePtr<IMappedFileHandle> MappedFileHandle;
+	TUniquePtr<IMappedFileRegion> MappedFileRegion;
+
+	/** View of the data */
+	ViewType View;
+
+	/** Number of elements allocated for the heap buffer, which may exceed the number of elements in the view after appending */
+	int64 NumOfAllocatedElements = 0;
+
+	/** Whether the view references memory allocated with FMemory::Malloc, which should be freed */
+	bool bOwnsHeapBuffer = false;
+};
+
 /** PCM Data buffer structure */
 USTRUCT()
 struct FPCMStruct
 {
 	GENERATED_BODY()
 	
-	/** 32-bit float PCM data */
-	FBulkDataBuffer<uint8> PCMData;
+	/** PCM data in the storage format. Read-only if mapped from the decoded PCM disk cache */
+	FRuntimeBulkDataBuffer<uint8> PCMData;
 
 	/** Number of PCM frames */
 	uint32 PCMNumOfFrames;
 
+	/** Format of the stored PCM data. When decoding, specifies the format the transcoders should decode to */
+	EPCMStorageFormat StorageFormat;
+
 	/** Base constructor */
 	FPCMStruct()
 		: PCMNumOfFrames(0)
+	  , StorageFormat(EPCMStorageFormat::Float32)
+	{
+	}
+
+	/** The PCM data is move-only, so that the buffer allocated by the decoder is the one played from. Use Clone or Share to duplicate it explicitly */
+	FPCMStruct(FPCMStruct&&) = default;
+	FPCMStruct& operator=(FPCMStruct&&) = default;
+	FPCMStruct(const FPCMStruct&) = delete;
+	FPCMStruct& operator=(const FPCMStruct&) = delete;
+
+	/**
+	 * Copy the PCM data into a newly allocated buffer
+	 *
+	 * @return The PCM struct owning the copied PCM data
+	 */
+	FPCMStruct Clone() const
+	{
+		FPCMStruct PCMInfo;
+		PCMInfo.PCMData = PCMData.Clone();
+		PCMInfo.PCMNumOfFrames = PCMNumOfFrames;
+		PCMInfo.StorageFormat = StorageFormat;
+		return PCMInfo;
+	}
+
+	/**
+	 * Reference the PCM data without copying it. The PCM data becomes read-only for both structs
+	 *
+	 * @return The PCM struct referencing the same PCM data
+	 */
+	FPCMStruct Share()
+	{
+		FPCMStruct PCMInfo;
+		PCMInfo.PCMData = PCMData.Share();
+		PCMInfo.PCMNumOfFrames = PCMNumOfFrames;
+		PCMInfo.StorageFormat = StorageFormat;
+		return PCMInfo;
+	}
+
+	/**
+	 * Get the size of a single sample in the storage format
+	 *
+	 * @return Sample size in bytes
+	 */
+	uint32 GetSampleSize() const
 	{
+		return StorageFormat == EPCMStorageFormat::Int16 ? sizeof(int16) : sizeof(float);
 	}
 
 	/**
@@ -103,12 +407,21 @@ struct FPCMStruct
 	 */
 	FString ToString() const
 	{
-		return FString::Printf(TEXT("Validity of PCM data in memory: %s, number of PCM frames: %d, PCM data size: %d"),
-		                       PCMData.GetView().IsValidIndex(0) ? TEXT("Valid") : TEXT("Invalid"), PCMNumOfFrames, PCMData.GetView().Num());
+		return FString::Printf(TEXT("Validity of PCM data in memory: %s, number of PCM frames: %d, PCM data size: %d, storage format: %s"),
+		                       PCMData.GetView().IsValidIndex(0) ? TEXT("Valid") : TEXT("Invalid"), PCMNumOfFrames, PCMData.GetView().Num(), *UEnum::GetValueAsName(StorageFormat).ToString());
 	}
 };
 
-/** Decoded audio information */
+template <>
+struct TStructOpsTypeTraits<FPCMStruct> : public TStructOpsTypeTraitsBase2<FPCMStruct>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/** Decoded audio information. Move-only, as is the PCM data it holds */
 struct FDecodedAudioStruct
 {
 	/** SoundWave basic info (e.g. duration, number of channels, etc) */
@@ -117,6 +430,32 @@ struct FDecodedAudioStruct
 	/** PCM Data buffer */
 	FPCMStruct PCMInfo;
 
+	/**
+	 * Copy the decoded audio data into a newly allocated buffer
+	 *
+	 * @return The decoded audio struct owning the copied PCM data
+	 */
+	FDecodedAudioStruct Clone() const
+	{
+		FDecodedAudioStruct DecodedAudioInfo;
+		DecodedAudioInfo.SoundWaveBasicInfo = SoundWaveBasicInfo;
+		DecodedAudioInfo.PCMInfo = PCMInfo.Clone();
+		return DecodedAudioInfo;
+	}
+
+	/**
+	 * Reference the decoded audio data without copying it. The PCM data becomes read-only for both structs
+	 *
+	 * @return The decoded audio struct referencing the same PCM data
+	 */
+	FDecodedAudioStruct Share()
+	{
+		FDecodedAudioStruct DecodedAudioInfo;
+		DecodedAudioInfo.SoundWaveBasicInfo = SoundWaveBasicInfo;
+		DecodedAudioInfo.PCMInfo = PCMInfo.Share();
+		return DecodedAudioInfo;
+	}
+
 	/**
 	 * Converts Decoded Audio Struct to a readable format
 	 *
@@ -132,7 +471,7 @@ struct FDecodedAudioStruct
 struct FEncodedAudioStruct
 {
 	/** Audio data */
-	FBulkDataBuffer<uint8> AudioData;
+	FRuntimeBulkDataBuffer<uint8> AudioData;
 
 	/** Format of the audio data (e.g. mp3, flac, etc) */
 	EAudioFormat AudioFormat;
@@ -150,6 +489,13 @@ struct FEncodedAudioStruct
 	{
 	}
 
+	/** Custom constructor */
+	FEncodedAudioStruct(FRuntimeBulkDataBuffer<uint8>&& AudioData, EAudioFormat AudioFormat)
+		: AudioData(MoveTemp(AudioData))
+	  , AudioFormat{AudioFormat}
+	{
+	}
+
 	/**
 	 * Converts Encoded Audio Struct to a readable format
 	 *
@@ -162,6 +508,81 @@ struct FEncodedAudioStruct
 	}
 };
 
+/**
+ * Flag used to cooperatively cancel the import of audio data. The decoders check it between decoded chunks
+ */
+struct FAudioImportCancellationToken
+{
+	/** The number of frames decoded between cancellation checks */
+	static constexpr uint64 NumOfFramesPerCheck{65536};
+
+	/** Request the cancellation */
+	void Cancel()
+	{
+		bCancelled = true;
+	}
+
+	/** Whether the cancellation was requested or not */
+	bool IsCancelled() const
+	{
+		return bCancelled;
+	}
+
+private:
+	TAtomic<bool> bCancelled{false};
+};
+
+/**
+ * Progress of decoding audio data, updated by the decoders between decoded chunks. Frames may be added from several threads
+ */
+struct FAudioDecodingProgress
+{
+	/** Called whenever the decoding percentage (0-100) increases. Called from the decoding threads */
+	TFunction<void(int32 Percentage)> OnPercentageChanged;
+
+	/** Set the total number of frames to decode. If unknown (zero), no progress is reported */
+	void SetNumOfFrames(uint64 InNumOfFrames)
+	{
+		NumOfFrames = InNumOfFrames;
+	}
+
+	/** Discard the decoded frames, e.g. before decoding the audio data again. The percentage already reported is kept, so it is never reported backwards */
+	void ResetDecodedFrames()
+	{
+		NumOfDecodedFrames = 0;
+	}
+
+	/** Account for the newly decoded frames */
+	void AddDecodedFrames(uint64 NumOfNewFrames)
+	{
+		const uint64 TotalNumOfFrames{NumOfFrames};
+
+		if (TotalNumOfFrames == 0 || !OnPercentageChanged)
+		{
+			return;
+		}
+
+		const uint64 TotalNumOfDecodedFrames{NumOfDecodedFrames.AddExchange(NumOfNewFrames) + NumOfNewFrames};
+		const int32 Percentage{static_cast<int32>(FMath::Min<uint64>(TotalNumOfDecodedFrames * 100 / TotalNumOfFrames, 100))};
+
+		// Only the thread that raises the percentage reports it, so each percentage is reported once and in order
+		int32 ExpectedPercentage{LastPercentage};
+		while (Percentage > ExpectedPercentage)
+		{
+			if (LastPercentage.CompareExchange(ExpectedPercentage, Percentage))
+			{
+				OnPercentageChanged(Percentage);
+				break;
+			}
+		}
+	}
+
+private:
+	TAtomic<uint64> NumOfFrames{0};
+	TAtomic<uint64> NumOfDecodedFrames{0};
+	TAtomic<int32> LastPercentage{0};
+};
+
 /** Compressed sound wave information */
 USTRUCT(BlueprintType, Category = "Runtime Audio Importer")
 struct FCompressedSoundWaveInfo
@@ -191,4 +612,199 @@ struct FCompressedSoundWaveInfo
 	  , Pitch(1.f)
 	{
 	}
+};
+
+/** Progress of a single file imported as part of a batch */
+USTRUCT(BlueprintType, Category = "Runtime Audio Importer")
+struct FBatchImportProgress
+{
+	GENERATED_BODY()
+
+	/** Index of the file in the batch. INDEX_NONE if the batch is empty */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	int32 FileIndex;
+
+	/** Path to the file */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	FString FilePath;
+
+	/** Import progress of the file (0-100%) */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	int32 FilePercentage;
+
+	/** Whether the import of the file is complete (even if it failed) */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	bool bFinished;
+
+	/** Importing status of the file. Valid only if the import of the file is complete */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	ETranscodingStatus Status;
+
+	/** Imported sound wave. Valid only if the file was imported successfully */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	class UImportedSoundWave* SoundWave;
+
+	/** Number of files in the batch whose import is complete */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	int32 NumOfFinishedFiles;
+
+	/** Total number of files in the batch */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	int32 NumOfFiles;
+
+	/** Import progress of the whole batch (0-100%) */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	int32 TotalPercentage;
+
+	FBatchImportProgress()
+		: FileIndex(INDEX_NONE)
+	  , FilePercentage(0)
+	  , bFinished(false)
+	  , Status(ETranscodingStatus::SuccessfulImport)
+	  , SoundWave(nullptr)
+	  , NumOfFinishedFiles(0)
+	  , NumOfFiles(0)
+	  , TotalPercentage(0)
+	{
+	}
+};
+
+/** Statistics of the decoded audio cache */
+USTRUCT(BlueprintType, Category = "Runtime Audio Importer")
+struct FDecodedAudioCacheStats
+{
+	GENERATED_BODY()
+
+	/** Number of imports whose decoded audio data was found in the cache */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	int64 NumOfHits;
+
+	/** Number of imports whose decoded audio data was not found in the cache */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	int64 NumOfMisses;
+
+	/** Number of entries evicted to fit into the memory budget */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	int64 NumOfEvictions;
+
+	/** Number of entries currently in the cache */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	int32 NumOfEntries;
+
+	/** Size of the PCM data currently held by the cache, in bytes */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	int64 CachedBytes;
+
+	/** The memory budget of the cache, in bytes */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	int64 MaxCachedBytes;
+
+	FDecodedAudioCacheStats()
+		: NumOfHits(0)
+	  , NumOfMisses(0)
+	  , NumOfEvictions(0)
+	  , NumOfEntries(0)
+	  , CachedBytes(0)
+	  , MaxCachedBytes(0)
+	{
+	}
+};
+
+/** Statistics of a single stage of the audio import */
+USTRUCT(BlueprintType, Category = "Runtime Audio Importer")
+struct FAudioImportStageStats
+{
+	GENERATED_BODY()
+
+	/** Time spent in the stage, in seconds */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	float Time;
+
+	/** Number of bytes copied by the stage. For the read stage, the number of bytes read from the file into memory */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	int64 NumOfCopiedBytes;
+
+	/** Peak number of bytes allocated by the stage on top of what had been allocated before it. Tracked only if RuntimeAudioImporter.TrackImportAllocations is enabled */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	int64 PeakAllocatedBytes;
+
+	/** Number of allocations made by the stage. Tracked only if RuntimeAudioImporter.TrackImportAllocations is enabled */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	int64 NumOfAllocations;
+
+	FAudioImportStageStats()
+		: Time(0)
+	  , NumOfCopiedBytes(0)
+	  , PeakAllocatedBytes(0)
+	  , NumOfAllocations(0)
+	{
+	}
+
+	/**
+	 * Converts Audio Import Stage Stats to a readable format
+	 *
+	 * @return String representation of the Audio Import Stage Stats
+	 */
+	FString ToString() const
+	{
+		return FString::Printf(TEXT("time: %f, copied bytes: %lld, peak allocated bytes: %lld, number of allocations: %lld"), Time, NumOfCopiedBytes, PeakAllocatedBytes, NumOfAllocations);
+	}
+};
+
+/** Statistics of a single audio import, broken down by the stages of the import */
+USTRUCT(BlueprintType, Category = "Runtime Audio Importer")
+struct FAudioImportStats
+{
+	GENERATED_BODY()
+
+	/** Reading the audio file */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	FAudioImportStageStats Read;
+
+	/** Handing the encoded audio data over to the decoding */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	FAudioImportStageStats Copy;
+
+	/** Decoding the audio data into PCM data */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	FAudioImportStageStats Decode;
+
+	/** Converting the decoded PCM data, such as resampling it */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	FAudioImportStageStats Convert;
+
+	/** Attaching the PCM data to the sound wave */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	FAudioImportStageStats Attach;
+
+	/** Whether the statistics were collected for the import or not */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	bool bCollected;
+
+	/** Whether the allocations were tracked for the import or not */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Audio Importer")
+	bool bAllocationsTracked;
+
+	FAudioImportStats()
+		: bCollected(false)
+	  , bAllocationsTracked(false)
+	{
+	}
+
+	/** Get the total number of bytes copied by all stages */
+	int64 GetTotalCopiedBytes() const
+	{
+		return Read.NumOfCopiedBytes + Copy.NumOfCopiedBytes + Decode.NumOfCopiedBytes + Convert.NumOfCopiedBytes + Attach.NumOfCopiedBytes;
+	}
+
+	/**
+	 * Converts Audio Import Stats to a readable format
+	 *
+	 * @return String representation of the Audio Import Stats
+	 */
+	FString ToString() const
+	{
+		return FString::Printf(TEXT("Read: %s\nCopy: %s\nDecode: %s\nConvert: %s\nAttach: %s\nTotal copied bytes: %lld"),
+		                       *Read.ToString(), *Copy.ToString(), *Decode.ToString(), *Convert.ToString(), *Attach.ToString(), GetTotalCopiedBytes());
+	}
 };
\ No newline at end of file
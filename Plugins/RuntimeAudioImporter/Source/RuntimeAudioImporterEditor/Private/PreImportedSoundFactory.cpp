@@ -3,11 +3,15 @@
 #include "PreImportedSoundFactory.h"
 #include "PreImportedSoundAsset.h"
 #include "Misc/FileHelper.h"
+#include "Misc/ScopedSlowTask.h"
+#include "Async/Async.h"
 
 DEFINE_LOG_CATEGORY(LogPreImportedSoundFactory);
 
 #include "RuntimeAudioImporterLibrary.h"
 
+#define LOCTEXT_NAMESPACE "PreImportedSoundFactory"
+
 UPreImportedSoundFactory::UPreImportedSoundFactory()
 {
 	Formats.Add(TEXT("imp;IMP Pre-imported Audio Format"));
@@ -26,39 +30,78 @@ bool UPreImportedSoundFactory::FactoryCanImport(const FString& Filename)
 
 UObject* UPreImportedSoundFactory::FactoryCreateFile(UClass* InClass, UObject* InParent, FName InName, EObjectFlags Flags, const FString& Filename, const TCHAR* Params, FFeedbackContext* Warn, bool& bOutOperationCanceled)
 {
-	UPreImportedSoundAsset* PreImportedSoundAsset;
+	FScopedSlowTask SlowTask(2, FText::Format(LOCTEXT("ImportingAudioFile", "Importing {0}"), FText::FromString(FPaths::GetCleanFilename(Filename))));
+
+	SlowTask.EnterProgressFrame(1);
 
 	TArray<uint8> AudioDataArray;
 
-	if (FFileHelper::LoadFileToArray(AudioDataArray, *Filename))
+	if (!FFileHelper::LoadFileToArray(AudioDataArray, *Filename))
 	{
-		FDecodedAudioStruct DecodedAudioInfo;
-
-		uint8* EncodedAudioDataPtr = static_cast<uint8*>(FMemory::Memcpy(FMemory::Malloc(AudioDataArray.Num() - 2), AudioDataArray.GetData(), AudioDataArray.Num() - 2));
-		FEncodedAudioStruct EncodedAudioInfo = FEncodedAudioStruct(EncodedAudioDataPtr, AudioDataArray.Num() - 2, EAudioFormat::Auto);
+		UE_LOG(LogPreImportedSoundFactory, Error, TEXT("Unable to read the audio file '%s'. Check file permissions"), *Filename);
+		return nullptr;
+	}
 
-		if (!URuntimeAudioImporterLibrary::DecodeAudioData(EncodedAudioInfo, DecodedAudioInfo))
-		{
-			UE_LOG(LogPreImportedSoundFactory, Error, TEXT("Unable to decode the audio file '%s'"), *Filename);
-			return nullptr;
-		}
+	SlowTask.EnterProgressFrame(1);
 
-		PreImportedSoundAsset = NewObject<UPreImportedSoundAsset>(InParent, UPreImportedSoundAsset::StaticClass(), InName, Flags);
-		PreImportedSoundAsset->AudioDataArray = AudioDataArray;
-		PreImportedSoundAsset->AudioFormat = EncodedAudioInfo.AudioFormat;
-		PreImportedSoundAsset->SourceFilePath = Filename;
+	// Only the headers are read to fill in the information about the audio data, while the whole audio data is validated on a worker thread
+	EAudioFormat AudioFormat{EAudioFormat::Auto};
+	FSoundWaveBasicStruct SoundWaveBasicInfo;
 
-		PreImportedSoundAsset->SoundDuration = URuntimeAudioImporterLibrary::ConvertSecondsToString(DecodedAudioInfo.SoundWaveBasicInfo.Duration);
-		PreImportedSoundAsset->NumberOfChannels = DecodedAudioInfo.SoundWaveBasicInfo.NumOfChannels;
-		PreImportedSoundAsset->SampleRate = DecodedAudioInfo.SoundWaveBasicInfo.SampleRate;
-	}
-	else
+	if (!URuntimeAudioImporterLibrary::ProbeAudioInfo(AudioDataArray.GetData(), AudioDataArray.Num(), AudioFormat, SoundWaveBasicInfo))
 	{
-		UE_LOG(LogPreImportedSoundFactory, Error, TEXT("Unable to read the audio file '%s'. Check file permissions"), *Filename);
+		UE_LOG(LogPreImportedSoundFactory, Error, TEXT("Unable to read the headers of the audio file '%s'"), *Filename);
 		return nullptr;
 	}
 
+	UPreImportedSoundAsset* PreImportedSoundAsset = NewObject<UPreImportedSoundAsset>(InParent, UPreImportedSoundAsset::StaticClass(), InName, Flags);
+	PreImportedSoundAsset->AudioDataArray = MoveTemp(AudioDataArray);
+	PreImportedSoundAsset->AudioFormat = AudioFormat;
+	PreImportedSoundAsset->SourceFilePath = Filename;
+
+	PreImportedSoundAsset->SoundDuration = URuntimeAudioImporterLibrary::ConvertSecondsToString(SoundWaveBasicInfo.Duration);
+	PreImportedSoundAsset->NumberOfChannels = SoundWaveBasicInfo.NumOfChannels;
+	PreImportedSoundAsset->SampleRate = SoundWaveBasicInfo.SampleRate;
+
+	// The validation reads its own copy of the audio data, since the asset may be modified or destroyed before the validation is waited for in CleanUp
+	const TSharedRef<const TArray<uint8>, ESPMode::ThreadSafe> ValidatedAudioData = MakeShared<const TArray<uint8>, ESPMode::ThreadSafe>(PreImportedSoundAsset->AudioDataArray);
+
+	PendingValidations.Add(FPreImportedSoundValidation{
+		Filename,
+		Async(EAsyncExecution::ThreadPool, [ValidatedAudioData, AudioFormat]()
+		{
+			return URuntimeAudioImporterLibrary::ValidateAudioData(ValidatedAudioData->GetData(), ValidatedAudioData->Num(), AudioFormat);
+		})
+	});
+
 	bOutOperationCanceled = false;
 
 	return PreImportedSoundAsset;
 }
+
+void UPreImportedSoundFactory::CleanUp()
+{
+	Super::CleanUp();
+
+	if (PendingValidations.Num() == 0)
+	{
+		return;
+	}
+
+	FScopedSlowTask SlowTask(PendingValidations.Num(), FText::Format(LOCTEXT("ValidatingAudioFiles", "Validating {0} imported audio files"), PendingValidations.Num()));
+	SlowTask.MakeDialog();
+
+	for (FPreImportedSoundValidation& PendingValidation : PendingValidations)
+	{
+		SlowTask.EnterProgressFrame(1, FText::Format(LOCTEXT("ValidatingAudioFile", "Validating {0}"), FText::FromString(FPaths::GetCleanFilename(PendingValidation.Filename))));
+
+		if (!PendingValidation.Result.Get())
+		{
+			UE_LOG(LogPreImportedSoundFactory, Error, TEXT("Unable to decode the audio file '%s'. The pre-imported sound asset may not play correctly"), *PendingValidation.Filename);
+		}
+	}
+
+	PendingValidations.Empty();
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -8,12 +8,23 @@
 #include "Logging/LogMacros.h"
 #include "Logging/LogVerbosity.h"
 
+#include "Async/Future.h"
 #include "Factories/Factory.h"
 #include "PreImportedSoundFactory.generated.h"
 
 /** Declaring custom logging */
 DECLARE_LOG_CATEGORY_EXTERN(LogPreImportedSoundFactory, Log, All);
 
+/** Validation decode of the imported audio file running on a worker thread */
+struct FPreImportedSoundValidation
+{
+	/** Path to the imported audio file */
+	FString Filename;
+
+	/** Whether the whole audio data was decoded successfully or not */
+	TFuture<bool> Result;
+};
+
 /**
  * Factory for pre-importing audio files. Supports all formats from EAudioFormat, but OGG Vorbis is recommended due to its smaller size and better quality
  */
@@ -29,5 +40,10 @@ public:
 	//~ Begin UFactory Interface.
 	virtual bool FactoryCanImport(const FString& Filename) override;
 	virtual UObject* FactoryCreateFile(UClass* InClass, UObject* InParent, FName InName, EObjectFlags Flags, const FString& Filename, const TCHAR* Params, FFeedbackContext* Warn, bool& bOutOperationCanceled) override;
+	virtual void CleanUp() override;
 	//~ end UFactory Interface.
+
+private:
+	/** Validation decodes of the files imported in the current batch. They run in parallel and are waited for once the whole batch is imported */
+	TArray<FPreImportedSoundValidation> PendingValidations;
 };